@@ -154,6 +154,8 @@ int FEBioApp::RunModel()
 	// set options that were passed on the command line
 	fem.SetDebugFlag(m_ops.bdebug);
 	fem.SetDumpLevel(m_ops.dumpLevel);
+	fem.SetDumpRebaseInterval(m_ops.dumpRebase);
+	fem.SetMeshCache(m_ops.bcache);
 
 	// set the output filenames
 	fem.SetLogFilename(m_ops.szlog);
@@ -277,6 +279,16 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 			bplt = true;
 			strcpy(ops.szplt, argv[++i]);
 		}
+		else if (strncmp(sz, "-dump_rebase=", 13) == 0)
+		{
+			// write a full restart file every n restart points and incremental ones in between
+			ops.dumpRebase = atoi(sz + 13);
+			if (ops.dumpRebase < 0)
+			{
+				fprintf(stderr, "FATAL ERROR: invalid restart rebase interval.\n");
+				return false;
+			}
+		}
 		else if (strncmp(sz, "-dump", 5) == 0)
 		{
 			ops.dumpLevel = FE_DUMP_MAJOR_ITRS;
@@ -330,6 +342,11 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 			// don't show the welcome message
 			ops.bsplash = false;
 		}
+		else if (strcmp(sz, "-cache") == 0)
+		{
+			// read the mesh from a binary cache (created on the first run)
+			ops.bcache = true;
+		}
 		else if (strcmp(sz, "-silent") == 0)
 		{
 			// no output to screen
@@ -34,6 +34,7 @@ SOFTWARE.*/
 #include <FECore/FESolver.h>
 #include <FECore/CompactMatrix.h>
 #include <FECore/FEAnalysis.h>
+#include <FECore/DataRecord.h>
 #include "FEBioCommand.h"
 #include "console.h"
 #include "cmdoptions.h"
@@ -71,6 +72,7 @@ REGISTER_COMMAND(FEBioCmd_Fail         , "fail"   , "force iteratoin failer");
 REGISTER_COMMAND(FEBioCmd_Help         , "help"   , "print available commands");
 REGISTER_COMMAND(FEBioCmd_hist         , "hist"   , "lists history of commands");
 REGISTER_COMMAND(FEBioCmd_LoadPlugin   , "load"   , "load a plugin");
+REGISTER_COMMAND(FEBioCmd_logconv      , "logconv", "convert a binary data file to text");
 REGISTER_COMMAND(FEBioCmd_Plot         , "plot"   , "store current state to plot file");
 REGISTER_COMMAND(FEBioCmd_out          , "out"    , "write matrix and rhs file");
 REGISTER_COMMAND(FEBioCmd_Plugins      , "plugins", "list the plugins that are loaded");
@@ -765,3 +767,18 @@ int FEBioCmd_list::run(int nargs, char** argv)
 
 	return 0;
 }
+
+//-----------------------------------------------------------------------------
+// converts a binary data file (see DataRecord) to the equivalent text file
+int FEBioCmd_logconv::run(int nargs, char** argv)
+{
+	if (nargs != 3) return invalid_nr_args();
+
+	if (DataRecord::ConvertToText(argv[1], argv[2]) == false)
+	{
+		printf("Failed converting %s\n", argv[1]);
+		return 0;
+	}
+	printf("Data file written: %s\n", argv[2]);
+	return 0;
+}
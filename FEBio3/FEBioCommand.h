@@ -255,6 +255,14 @@ public:
 	DECLARE_COMMAND(FEBioCmd_list);
 };
 
+//-----------------------------------------------------------------------------
+class FEBioCmd_logconv : public FEBioCommand
+{
+public:
+	int run(int nargs, char** argv);
+	DECLARE_COMMAND(FEBioCmd_logconv);
+};
+
 //-----------------------------------------------------------------------------
 class FEBioCmd_hist: public FEBioCommand
 {
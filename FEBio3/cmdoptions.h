@@ -38,8 +38,10 @@ struct CMDOPTIONS
 	bool	bsplash;			//!< show splash screen or not
 	bool	bsilent;			//!< run FEBio in silent mode (no output to screen)
 	bool	binteractive;		//!< start FEBio interactively
+	bool	bcache;				//!< use a binary cache for the mesh
 
 	int		dumpLevel;		//!< requested restart level
+	int		dumpRebase;		//!< nr of restart points between full restart files
 
 	char	szfile[MAXFILE];	//!< model input file name
 	char	szlog[MAXFILE];	//!< log file name
@@ -61,7 +63,9 @@ struct CMDOPTIONS
 		bsplash = true;
 		bsilent = false;
 		binteractive = false;
+		bcache = false;
 		dumpLevel = 0;
+		dumpRebase = 0;
 
 		szfile[0] = 0;
 		szlog[0] = 0;
@@ -87,7 +87,7 @@ bool FEConstraintFrictionlessWall::Init()
         FEAugLagLinearConstraint* pLC = new FEAugLagLinearConstraint;
         for (int j=0; j<3; ++j) {
             FEAugLagLinearConstraint::DOF dof;
-            FENode node = m_surf.Node(i);
+            FENode& node = m_surf.Node(i);
             dof.node = node.GetID() - 1;    // zero-based
             switch (j) {
                 case 0:
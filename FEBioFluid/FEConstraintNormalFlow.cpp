@@ -92,7 +92,7 @@ bool FEConstraintNormalFlow::Init()
         FEAugLagLinearConstraint* pLC0 = new FEAugLagLinearConstraint;
         for (int j=0; j<3; ++j) {
             FEAugLagLinearConstraint::DOF dof;
-            FENode node = m_surf.Node(i);
+            FENode& node = m_surf.Node(i);
             dof.node = node.GetID() - 1;    // zero-based
             switch (j) {
                 case 0:
@@ -119,7 +119,7 @@ bool FEConstraintNormalFlow::Init()
         FEAugLagLinearConstraint* pLC1 = new FEAugLagLinearConstraint;
         for (int j=0; j<3; ++j) {
             FEAugLagLinearConstraint::DOF dof;
-            FENode node = m_surf.Node(i);
+            FENode& node = m_surf.Node(i);
             dof.node = node.GetID() - 1;    // zero-based
             switch (j) {
                 case 0:
@@ -146,7 +146,7 @@ bool FEConstraintNormalFlow::Init()
         FEAugLagLinearConstraint* pLC2 = new FEAugLagLinearConstraint;
         for (int j=0; j<3; ++j) {
             FEAugLagLinearConstraint::DOF dof;
-            FENode node = m_surf.Node(i);
+            FENode& node = m_surf.Node(i);
             dof.node = node.GetID() - 1;    // zero-based
             switch (j) {
                 case 0:
@@ -140,7 +140,7 @@ void FEFluidDomain3D::UnpackLM(FEElement& el, vector<int>& lm)
     for (int i=0; i<N; ++i)
     {
         FENode& node = m_pMesh->Node(el.m_node[i]);
-        vector<int>& id = node.m_ID;
+        int* id = node.m_ID;
         
         lm[4*i  ] = id[m_dofW[0]];
         lm[4*i+1] = id[m_dofW[1]];
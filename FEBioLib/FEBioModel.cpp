@@ -46,15 +46,18 @@ SOFTWARE.*/
 #include <FEBioMech/FERigidSpring.h>
 #include <FEBioMech/FERigidAngularDamper.h>
 #include <FEBioMech/FERigidContractileForce.h>
+#include <FEBioMech/FEContactInterface.h>
 #include "FECore/log.h"
 #include "FECore/FECoreKernel.h"
 #include "FECore/DumpFile.h"
+#include "FECore/DumpMemStream.h"
 #include "FECore/DOFS.h"
 #include <FECore/FEAnalysis.h>
 #include <NumCore/MatrixTools.h>
 #include <FECore/LinearSolver.h>
 #include <FECore/FEDomain.h>
 #include <FECore/FEMaterial.h>
+#include <FECore/FECounter.h>
 #include "febio.h"
 #include "version.h"
 #include <iostream>
@@ -67,14 +70,15 @@ size_t FEBIOLIB_API GetPeakMemory();	// in memory.cpp
 
 FEBioModel::FEPlotVariable::FEPlotVariable()
 {
-
+	m_tol = 0.0;
 }
 
-FEBioModel::FEPlotVariable::FEPlotVariable(const std::string& varName, const std::vector<int>& itemList, const std::string& domainName)
+FEBioModel::FEPlotVariable::FEPlotVariable(const std::string& varName, const std::vector<int>& itemList, const std::string& domainName, double tol)
 {
 	m_var = varName;
 	m_item = itemList;
 	m_domName = domainName;
+	m_tol = tol;
 }
 
 FEBioModel::FEPlotVariable::FEPlotVariable(const FEBioModel::FEPlotVariable& v)
@@ -82,6 +86,7 @@ FEBioModel::FEPlotVariable::FEPlotVariable(const FEBioModel::FEPlotVariable& v)
 	m_var = v.m_var;
 	m_item = v.m_item;
 	m_domName = v.m_domName;
+	m_tol = v.m_tol;
 }
 
 void FEBioModel::FEPlotVariable::operator = (const FEBioModel::FEPlotVariable& v)
@@ -89,6 +94,7 @@ void FEBioModel::FEPlotVariable::operator = (const FEBioModel::FEPlotVariable& v
 	m_var = v.m_var;
 	m_item = v.m_item;
 	m_domName = v.m_domName;
+	m_tol = v.m_tol;
 }
 
 void FEBioModel::FEPlotVariable::Serialize(DumpStream& ar)
@@ -96,6 +102,7 @@ void FEBioModel::FEPlotVariable::Serialize(DumpStream& ar)
 	ar & m_var;
 	ar & m_item;
 	ar & m_domName;
+	ar & m_tol;
 }
 
 //-----------------------------------------------------------------------------
@@ -136,6 +143,7 @@ FEBioModel::FEBioModel()
 	m_becho = true;
 	m_plot = nullptr;
 	m_writeMesh = false;
+	m_meshCache = false;
 
 	m_ntimeSteps = 0;
 	m_ntotalIters = 0;
@@ -143,6 +151,8 @@ FEBioModel::FEBioModel()
 	m_ntotalReforms = 0;
 
 	m_pltCompression = 0;
+	m_pltAsync = 0;
+	m_pltIndex = false;
 	m_pltAppendOnRestart = true;
 
 	// Add the output callback
@@ -185,9 +195,15 @@ void FEBioModel::SetDumpLevel(int dumpLevel) { m_dumpLevel = dumpLevel; }
 //! get the dump level
 int FEBioModel::GetDumpLevel() const { return m_dumpLevel; }
 
+//! set the number of restart points between full archives
+void FEBioModel::SetDumpRebaseInterval(int n) { m_dumpWriter.SetRebaseInterval(n); }
+
 //! Set the log level
 void FEBioModel::SetLogLevel(int logLevel) { m_logLevel = logLevel; }
 
+//! use a binary cache for the mesh when reading the input file
+void FEBioModel::SetMeshCache(bool b) { m_meshCache = b; }
+
 //-----------------------------------------------------------------------------
 //! Set the title of the model
 void FEBioModel::SetTitle(const char* sz)
@@ -328,6 +344,7 @@ bool FEBioModel::Input(const char* szfile)
 
 	// create file reader
 	FEBioImport fim;
+	fim.SetMeshCache(m_meshCache);
 
 	feLog("Reading file %s ...", szfile);
 
@@ -358,6 +375,8 @@ bool FEBioModel::Input(const char* szfile)
 
 		// set compression
 		m_pltCompression = fim.m_nplot_compression;
+		m_pltAsync = fim.m_nplot_async;
+		m_pltIndex = fim.m_bplot_index;
 
 		// define the plot file variables
 		FEModel& fem = *GetFEModel();
@@ -377,7 +396,7 @@ bool FEBioModel::Input(const char* szfile)
 				DomainListFromMaterial(lmat, item);
 			}
 
-			FEPlotVariable pltvar(var.m_szvar, item, var.m_szdom);
+			FEPlotVariable pltvar(var.m_szvar, item, var.m_szdom, var.m_tol);
 			m_pltData.push_back(pltvar);
 		}
 	}
@@ -666,18 +685,30 @@ void FEBioModel::WriteData()
 
 //-----------------------------------------------------------------------------
 //! Dump state to archive for restarts
+//! The model is serialized to memory and the archive is written on a background
+//! thread, so the solver doesn't have to wait for the file.
 void FEBioModel::DumpData()
 {
-	DumpFile ar(*this);
-	if (ar.Create(m_sdump.c_str()) == false)
-	{
-		feLogWarning("Failed creating restart file (%s).\n", m_sdump.c_str());
-	}
-	else 
-	{
-		Serialize(ar);
-		feLogInfo("\nRestart point created. Archive name is %s.", m_sdump.c_str());
-	}
+	DumpMemStream ar(*this);
+	ar.Open(true, false);
+	Serialize(ar);
+
+	// hand the archive data to the writer without copying it
+	// (this waits for the previous restart point, which is reported now)
+	std::vector<char> data;
+	ar.release(data);
+	bool bpending = m_dumpWriter.Pending();
+	bool bok = m_dumpWriter.Write(m_sdump.c_str(), data);
+	if (bpending) ReportRestartPoint(bok);
+}
+
+//-----------------------------------------------------------------------------
+//! Report the result of writing a restart point. Since the restart files are written
+//! in the background, this is only known when the writer is done.
+void FEBioModel::ReportRestartPoint(bool bok)
+{
+	if (bok) feLogInfo("\nRestart point created. Archive name is %s.", m_sdump.c_str());
+	else feLogWarning("Failed writing restart file (%s).\n", m_sdump.c_str());
 }
 
 //-----------------------------------------------------------------------------
@@ -1226,6 +1257,7 @@ void FEBioModel::SerializeIOData(DumpStream &ar)
 		ar << npltfmt;
 
 		ar << m_pltCompression;
+		ar << m_pltAsync << m_pltIndex;
 		ar << m_pltData;
 
 		// data records
@@ -1256,6 +1288,7 @@ void FEBioModel::SerializeIOData(DumpStream &ar)
 		assert(npltfmt == 2);
 
 		ar >> m_pltCompression;
+		ar >> m_pltAsync >> m_pltIndex;
 		ar >> m_pltData;
 
 		// remove the plot file (if any)
@@ -1264,6 +1297,8 @@ void FEBioModel::SerializeIOData(DumpStream &ar)
 		// create the plot file
 		FEBioPlotFile* pplt = new FEBioPlotFile(*this);
 		m_plot = pplt;
+		pplt->SetAsync(m_pltAsync);
+		pplt->SetIndexing(m_pltIndex);
 
 		if (m_pltAppendOnRestart)
 		{
@@ -1273,6 +1308,12 @@ void FEBioModel::SerializeIOData(DumpStream &ar)
 				printf("FATAL ERROR: Failed reopening plot database %s\n", m_splot.c_str());
 				throw "FATAL ERROR";
 			}
+
+			// the quantization tolerances are not stored in the plot file
+			for (FEPlotVariable& vi : m_pltData)
+			{
+				if (vi.m_tol > 0.0) pplt->SetTolerance(vi.m_var.c_str(), vi.m_tol);
+			}
 		}
 		else
 		{
@@ -1283,7 +1324,7 @@ void FEBioModel::SerializeIOData(DumpStream &ar)
 			for (FEPlotVariable& vi : m_pltData)
 			{
 				// add the plot output variable
-				if (pplt->AddVariable(vi.m_var.c_str(), vi.m_item, vi.m_domName.c_str()) == false)
+				if (pplt->AddVariable(vi.m_var.c_str(), vi.m_item, vi.m_domName.c_str(), vi.m_tol) == false)
 				{
 					feLog("FATAL ERROR: Output variable \"%s\" is not defined\n", vi.m_var.c_str());
 					throw "FATAL ERROR";
@@ -1370,12 +1411,14 @@ bool FEBioModel::Init()
 
 			// set compression
 			pplt->SetCompression(m_pltCompression);
+			pplt->SetAsync(m_pltAsync);
+			pplt->SetIndexing(m_pltIndex);
 
 			// add plot variables
 			for (FEPlotVariable& vi : m_pltData)
 			{
 				// add the plot output variable
-				if (pplt->AddVariable(vi.m_var.c_str(), vi.m_item, vi.m_domName.c_str()) == false)
+				if (pplt->AddVariable(vi.m_var.c_str(), vi.m_item, vi.m_domName.c_str(), vi.m_tol) == false)
 				{
 					feLog("FATAL ERROR: Output variable \"%s\" is not defined\n", vi.m_var.c_str());
 					return false;
@@ -1561,6 +1604,13 @@ bool FEBioModel::Solve()
 	// solve the FE model
 	bool bconv = FEMechModel::Solve();
 
+	// make sure the last restart file is written
+	if (m_dumpWriter.Pending())
+	{
+		bool bok = m_dumpWriter.Wait();
+		ReportRestartPoint(bok);
+	}
+
 	// stop total time tracker
 	m_SolveTime.stop();
 
@@ -1626,6 +1676,50 @@ bool FEBioModel::Solve()
 		Timer::time_str(total_linsol, sztime); feLog("\t   time in linear solver ........ : %s (%lg sec)\n\n", sztime, total_linsol);
 		Timer::time_str(total_time  , sztime); feLog("\tTotal elapsed time .............. : %s (%lg sec)\n\n", sztime, total_time  );
 
+		feLog("\tMaterial point type searches .... : %lld\n\n", FEMaterialPoint::SlowLookups());
+
+		// report the state snapshots that were taken for time step retries
+		int nsnap = 0;
+		size_t snapsize = 0;
+		for (int i = 0; i < NS; ++i)
+		{
+			FEAnalysis* pstep = GetStep(i);
+			nsnap += pstep->m_nsnap;
+			if (pstep->m_snapsize > snapsize) snapsize = pstep->m_snapsize;
+		}
+		if (nsnap > 0)
+		{
+			double tsnap = GetTimer(TimerID::Timer_Snapshot)->GetTime();
+			feLog("\tState snapshots (for retries) ... : %d\n", nsnap);
+			Timer::time_str(tsnap, sztime); feLog("\t   snapshot time ................ : %s (%lg sec)\n", sztime, tsnap);
+			feLog("\t   snapshot size ................ : %lg MB\n\n", (double)snapsize / 1048576.0);
+		}
+
+		// report the event counters that were registered by the modules
+		bool bcount = false;
+		for (int i = 0; i < FECounter::Counters(); ++i)
+		{
+			FECounter* pc = FECounter::GetCounter(i);
+			if (pc->Value() == 0) continue;
+			feLog("\t%-32s : %lld\n", pc->GetName(), pc->Value());
+			bcount = true;
+		}
+		if (bcount) feLog("\n");
+
+		// report the time spent in the contact interfaces
+		for (int i = 0; i < SurfacePairConstraints(); ++i)
+		{
+			FEContactInterface* pci = dynamic_cast<FEContactInterface*>(SurfacePairConstraint(i));
+			if (pci == nullptr) continue;
+
+			double tf = pci->LoadVectorTimer().GetTime();
+			double tk = pci->StiffnessTimer().GetTime();
+			const char* szname = (pci->GetName().empty() ? pci->GetTypeStr() : pci->GetName().c_str());
+			feLog("\tContact interface %d (%s)\n", i + 1, szname);
+			Timer::time_str(tf, sztime); feLog("\t   contact forces ............... : %s (%lg sec)\n", sztime, tf);
+			Timer::time_str(tk, sztime); feLog("\t   contact stiffness ............ : %s (%lg sec)\n\n", sztime, tk);
+		}
+
 
 		m_log.SetMode(old_mode);
 
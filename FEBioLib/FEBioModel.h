@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include <FEBioMech/FEMechModel.h>
 #include <FECore/Timer.h>
 #include <FECore/DataStore.h>
+#include <FECore/DumpWriter.h>
 #include <FEBioPlot/PlotFile.h>
 #include <FECore/FECoreKernel.h>
 #include "febiolib_api.h"
@@ -55,7 +56,7 @@ class FEBIOLIB_API FEBioModel : public FEMechModel
 	{
 	public:
 		FEPlotVariable();
-		FEPlotVariable(const std::string& varName, const std::vector<int>& itemList, const std::string& domainName);
+		FEPlotVariable(const std::string& varName, const std::vector<int>& itemList, const std::string& domainName, double tol = 0.0);
 		FEPlotVariable(const FEPlotVariable& v);
 		void operator = (const FEPlotVariable& v);
 
@@ -65,6 +66,7 @@ class FEBIOLIB_API FEBioModel : public FEMechModel
 		std::string			m_var;
 		std::vector<int>	m_item;
 		std::string			m_domName;
+		double				m_tol;		// quantization tolerance
 	};
 
 public:
@@ -100,6 +102,9 @@ public: // --- I/O functions ---
 	//! dump data to archive for restart
 	void DumpData();
 
+	//! report the result of writing a restart point
+	void ReportRestartPoint(bool bok);
+
 	//! add to log 
 	void Log(int ntag, const char* szmsg) override;
 
@@ -179,9 +184,15 @@ public:
 	//! get the dump level
 	int GetDumpLevel() const;
 
+	//! set the number of restart points between full archives (0 = no incremental restart points)
+	void SetDumpRebaseInterval(int n);
+
 	//! Set the log level
 	void SetLogLevel(int logLevel);
 
+	//! use a binary cache for the mesh when reading the input file
+	void SetMeshCache(bool b);
+
 private:
 	void print_parameter(FEParam& p, int level = 0);
 	void print_parameter_list(FEParameterList& pl, int level = 0);
@@ -201,10 +212,12 @@ private:
 	bool		m_becho;		//!< echo input to logfile
 	bool		m_debug;		//!< debug flag
 	bool		m_writeMesh;	//!< write a new mesh section
+	bool		m_meshCache;	//!< read/write the mesh from/to a binary cache
 
 	int			m_logLevel;		//!< output level for log file
 
 	int			m_dumpLevel;	//!< level or writing restart file
+	DumpWriter	m_dumpWriter;	//!< writes the restart files in the background
 
 private:
 	// accumulative statistics
@@ -225,6 +238,8 @@ protected: // file names
 protected:
 	vector<FEPlotVariable>	m_pltData;
 	int						m_pltCompression;
+	int						m_pltAsync;
+	bool					m_pltIndex;
 	bool					m_pltAppendOnRestart;
 
 private:
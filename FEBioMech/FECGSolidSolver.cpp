@@ -182,7 +182,7 @@ bool FECGSolidSolver::InitEquations()
 	for (int i = 0; i<mesh.Nodes(); ++i)
 	{
 		FENode& node = mesh.Node(i);
-		for (int j = 0; j<(int)node.m_ID.size(); ++j)
+		for (int j = 0; j<node.dofs(); ++j)
 		{
 			if (node.m_ID[j] == DOF_FIXED) { node.m_ID[j] = -1; }
 			else if (node.m_ID[j] == DOF_OPEN) { node.m_ID[j] = neq++; }
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/FESurfacePairConstraint.h>
+#include <FECore/Timer.h>
 #include "febiomech_api.h"
 
 class FEModel;
@@ -63,6 +64,10 @@ public:
 	// Evaluates the contriubtion to the stiffness matrix
 	virtual void StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp) = 0;
 
+	//! time spent evaluating the contact forces and the stiffness of this interface
+	Timer& LoadVectorTimer() { return m_loadTimer; }
+	Timer& StiffnessTimer() { return m_stiffTimer; }
+
 protected:
 	//! don't call the default constructor
 	FEContactInterface() : FESurfacePairConstraint(0){}
@@ -82,4 +87,8 @@ public:
     double  m_psfmax;   //!< max allowable penalty scale factor during laugon
 
 	DECLARE_FECORE_CLASS();
+
+private:
+	Timer	m_loadTimer;	//!< timer for LoadVector
+	Timer	m_stiffTimer;	//!< timer for StiffnessMatrix
 };
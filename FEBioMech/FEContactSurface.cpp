@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEContactSurface.h"
 #include "FECore/FEModel.h"
+#include "FECore/FENormalProjection.h"
+#include "FECore/FESurfaceBVH.h"
 #include "FEBioMech/FEElasticMaterial.h"
 #include <assert.h>
 
@@ -36,13 +38,15 @@ SOFTWARE.*/
 FEContactSurface::FEContactSurface(FEModel* pfem) : FESurface(pfem), m_pfem(pfem)
 {
 	m_pSibling = 0; 
+	m_proj = nullptr;
+	m_bvh = nullptr;
 	m_dofX = -1;
 	m_dofY = -1;
 	m_dofZ = -1;
 }
 
 //-----------------------------------------------------------------------------
-FEContactSurface::~FEContactSurface() { m_pSibling = 0; m_pContactInterface = 0; }
+FEContactSurface::~FEContactSurface() { m_pSibling = 0; m_pContactInterface = 0; delete m_proj; delete m_bvh; }
 
 //-----------------------------------------------------------------------------
 bool FEContactSurface::Init()
@@ -53,6 +57,10 @@ bool FEContactSurface::Init()
 	m_dofY = dofs.GetDOF("y");
 	m_dofZ = dofs.GetDOF("z");
 
+	// the search trees will be rebuilt when they are needed
+	delete m_proj; m_proj = nullptr;
+	delete m_bvh; m_bvh = nullptr;
+
 	return FESurface::Init();
 }
 
@@ -64,7 +72,63 @@ void FEContactSurface::Serialize(DumpStream& ar)
 	if (ar.IsShallow() == false)
 	{
 		ar & m_dofX & m_dofY & m_dofZ;
+
+		if (ar.IsLoading()) { delete m_proj; m_proj = nullptr; }
+	}
+}
+
+//-----------------------------------------------------------------------------
+FENormalProjection& FEContactSurface::GetNormalProjection(double tol, double rad)
+{
+	if (m_proj == nullptr) m_proj = new FENormalProjection(*this);
+	m_proj->SetTolerance(tol);
+	m_proj->SetSearchRadius(rad);
+	m_proj->Update();
+	return *m_proj;
+}
+
+//-----------------------------------------------------------------------------
+void FEContactSurface::UpdateBroadPhase()
+{
+	if (m_bvh == nullptr)
+	{
+		// The element boxes are inflated a little since the facets of
+		// higher-order elements can bulge out of the box of their nodes.
+		m_bvh = new FESurfaceBVH(this);
+		m_bvh->Build(0.1);
 	}
+	else m_bvh->Update();
+}
+
+//-----------------------------------------------------------------------------
+bool FEContactSurface::BroadPhase(FEContactMaterialPoint& pt, const vec3d& x, double R)
+{
+	assert(m_bvh);
+	if (m_bvh == nullptr) return true;
+
+	// If the point was far at the last test, it can only have come closer by the
+	// distance it moved plus the distance the surface moved since then.
+	double drift = m_bvh->Drift();
+	if ((pt.m_db > 0.0) && (drift >= pt.m_sb))
+	{
+		double dx = (x - pt.m_xb).norm() + (drift - pt.m_sb);
+		if (dx < pt.m_db) return false;
+	}
+
+	// do the actual search
+	double d = m_bvh->Distance(x, R);
+	pt.m_xb = x;
+	pt.m_sb = drift;
+	pt.m_db = d - R;
+	return (d <= R);
+}
+
+//-----------------------------------------------------------------------------
+void FEContactSurface::FindElementsInBox(const vec3d& cmin, const vec3d& cmax, std::vector<int>& sel)
+{
+	assert(m_bvh);
+	if (m_bvh) m_bvh->FindElementsInBox(cmin, cmax, sel);
+	else sel.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -229,7 +293,7 @@ void FEContactSurface::UnpackLM(FEElement& el, vector<int>& lm)
 	{
 		int n = el.m_node[i];
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		int* id = node.m_ID;
 
 		lm[3*i  ] = id[m_dofX];
 		lm[3*i+1] = id[m_dofY];
@@ -33,6 +33,9 @@ SOFTWARE.*/
 #include "FEContactInterface.h"
 #include "febiomech_api.h"
 
+class FENormalProjection;
+class FESurfaceBVH;
+
 //-----------------------------------------------------------------------------
 // Stores material point data for contact interfaces
 class FEBIOMECH_API FEContactMaterialPoint : public FESurfaceMaterialPoint
@@ -44,6 +47,8 @@ public:
 		m_Ln  = 0.0;
 		m_pme = nullptr;
 		m_pmep = nullptr;
+		m_db = -1.0;
+		m_sb = 0.0;
 	}
 
 public:
@@ -52,6 +57,11 @@ public:
 
 	FESurfaceElement*	m_pme;	//!< target element
 	FESurfaceElement*	m_pmep;	//!< previous target element
+
+	// broad-phase data (see FEContactSurface::BroadPhase)
+	vec3d	m_xb;	//!< position at last broad-phase test
+	double	m_db;	//!< clearance beyond the search distance at last test (negative if it was near)
+	double	m_sb;	//!< drift of the searched surface at last test
 };
 
 //-----------------------------------------------------------------------------
@@ -87,6 +97,24 @@ public:
 	//! Unpack surface element data
 	virtual void UnpackLM(FEElement& el, vector<int>& lm);
 
+	//! Get the normal projection onto this surface. The projection (and its search
+	//! tree) persists between calls and is updated to the current nodal positions.
+	FENormalProjection& GetNormalProjection(double tol, double rad);
+
+	//! Update the broad-phase search tree to the current nodal positions.
+	//! This must be called before BroadPhase is used in a new search.
+	void UpdateBroadPhase();
+
+	//! Broad-phase test: returns false if the point x cannot be within distance R of
+	//! this surface. The point's active-set data is used to skip the search when the
+	//! point and the surface moved less than the clearance found at the last test.
+	//! This function is thread safe (for different points).
+	bool BroadPhase(FEContactMaterialPoint& pt, const vec3d& x, double R);
+
+	//! Find the elements that may overlap the box [cmin, cmax], using the broad-phase
+	//! search tree. UpdateBroadPhase must be called first.
+	void FindElementsInBox(const vec3d& cmin, const vec3d& cmax, std::vector<int>& sel);
+
 public:
     virtual void GetVectorGap      (int nface, vec3d& pg);
     virtual void GetContactTraction(int nface, vec3d& pt);
@@ -111,6 +139,9 @@ protected:
     FEContactInterface* m_pContactInterface;
 	FEModel*	m_pfem;
 
+	FENormalProjection*	m_proj;	//!< persistent normal projection onto this surface
+	FESurfaceBVH*		m_bvh;	//!< broad-phase search tree
+
 	int	m_dofX;
 	int	m_dofY;
 	int	m_dofZ;
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEContinuousFiberDistribution.h"
+#include <FECore/FEModel.h>
 
 BEGIN_FECORE_CLASS(FEContinuousFiberDistribution, FEElasticMaterial)
 
@@ -44,6 +45,7 @@ FEContinuousFiberDistribution::FEContinuousFiberDistribution(FEModel* pfem) : FE
 	m_pFmat = 0;
 	m_pFDD = 0;
 	m_pFint = 0;
+	m_bfixed = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -55,15 +57,94 @@ bool FEContinuousFiberDistribution::Init()
     // initialize base class
 	if (FEElasticMaterial::Init() == false) return false;
 
+	// evaluate the fiber directions
+	InitFibers();
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+FEMaterialPoint* FEContinuousFiberDistribution::CreateMaterialPointData()
+{
+	return new FEFiberMaterialPoint(FEElasticMaterial::CreateMaterialPointData());
+}
+
+//-----------------------------------------------------------------------------
+// The integration points that are used for evaluating the integrated fiber density
+// do not depend on the material point, so they are evaluated once here. If the 
+// integration scheme is not deformation dependent, these are also the integration
+// points for the stress and tangent.
+void FEContinuousFiberDistribution::InitFibers()
+{
+	m_fiber.clear();
+	m_weight.clear();
+	m_bfixed = (m_pFint->IsDeformationDependent() == false);
+
+	// NOTE: Pass nullptr to GetIterator to avoid issues with GK rule!
+	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(nullptr);
+	if (it->IsValid())
+	{
+		do
+		{
+			m_fiber.push_back(it->m_fiber);
+			m_weight.push_back(it->m_weight);
+		}
+		while (it->Next());
+	}
+	delete it;
+}
+
+//-----------------------------------------------------------------------------
+// Update the fiber data that is cached at the material point. Returns nullptr
+// if the material point does not have fiber data.
+FEFiberMaterialPoint* FEContinuousFiberDistribution::FiberData(FEMaterialPoint& mp)
+{
+	FEFiberMaterialPoint* fp = mp.ExtractData<FEFiberMaterialPoint>();
+	if (fp == nullptr) return nullptr;
+
+	// see if the cached data is still valid
+	mat3d Q = GetLocalCS(mp);
+	double time = GetFEModel()->GetTime().currentTime;
+	if (fp->IsValid(Q, time)) return fp;
+
+	// evaluate the fiber densities
+	mat3d Qt = Q.transpose();
+	const int nf = (int)m_fiber.size();
+	vector<double>& w = fp->m_w;
+	w.resize(nf);
+	double IFD = 0.0;
+	for (int i = 0; i < nf; ++i)
+	{
+		// rotate to local configuration to evaluate ellipsoidally distributed material coefficients
+		vec3d n0 = Qt*m_fiber[i];
+		w[i] = m_pFDD->FiberDensity(mp, n0)*m_weight[i];
+		IFD += w[i];
+	}
+
+	// just in case
+	if (IFD == 0.0) IFD = 1.0;
+	fp->m_IFD = IFD;
+
+	// the weights are only needed if the integration points are fixed
+	if (m_bfixed)
+	{
+		for (int i = 0; i < nf; ++i) w[i] /= IFD;
+	}
+	else w.clear();
+
+	fp->SetValid(Q, time);
+
+	return fp;
+}
+
 //-----------------------------------------------------------------------------
 //! Serialization
 void FEContinuousFiberDistribution::Serialize(DumpStream& ar)
 {	
 	FEElasticMaterial::Serialize(ar);
 	if (ar.IsShallow()) return;
+
+	if (ar.IsLoading()) InitFibers();
 }
 
 //-----------------------------------------------------------------------------
@@ -75,10 +156,19 @@ mat3ds FEContinuousFiberDistribution::Stress(FEMaterialPoint& mp)
 	// calculate stress
 	mat3ds s; s.zero();
 
+	// use the cached weights if the integration points are fixed
+	FEFiberMaterialPoint* fp = FiberData(mp);
+	if (fp && m_bfixed)
+	{
+		const int nf = (int)m_fiber.size();
+		for (int i = 0; i < nf; ++i) s += m_pFmat->FiberStress(pt, m_fiber[i])*fp->m_w[i];
+		return s;
+	}
+
 	// get the local coordinate systems
 	mat3d Qt = GetLocalCS(mp).transpose();
     
-    double IFD = IntegratedFiberDensity(mp);
+	double IFD = (fp ? fp->m_IFD : IntegratedFiberDensity(mp));
 
 	// obtain an integration point iterator
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
@@ -115,15 +205,24 @@ tens4ds FEContinuousFiberDistribution::Tangent(FEMaterialPoint& mp)
 {
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 
-	// get the local coordinate systems
-	mat3d Qt = GetLocalCS(mp).transpose();
-    
-    double IFD = IntegratedFiberDensity(mp);
-
 	// initialize stress tensor
 	tens4ds c;
 	c.zero();
 
+	// use the cached weights if the integration points are fixed
+	FEFiberMaterialPoint* fp = FiberData(mp);
+	if (fp && m_bfixed)
+	{
+		const int nf = (int)m_fiber.size();
+		for (int i = 0; i < nf; ++i) c += m_pFmat->FiberTangent(mp, m_fiber[i])*fp->m_w[i];
+		return c;
+	}
+
+	// get the local coordinate systems
+	mat3d Qt = GetLocalCS(mp).transpose();
+    
+	double IFD = (fp ? fp->m_IFD : IntegratedFiberDensity(mp));
+
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
 	if (it->IsValid())
 	{
@@ -158,12 +257,21 @@ double FEContinuousFiberDistribution::StrainEnergyDensity(FEMaterialPoint& mp)
 { 
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 
+	double sed = 0.0;
+
+	// use the cached weights if the integration points are fixed
+	FEFiberMaterialPoint* fp = FiberData(mp);
+	if (fp && m_bfixed)
+	{
+		const int nf = (int)m_fiber.size();
+		for (int i = 0; i < nf; ++i) sed += m_pFmat->FiberStrainEnergyDensity(mp, m_fiber[i])*fp->m_w[i];
+		return sed;
+	}
+
 	// get the local coordinate systems
 	mat3d Qt = GetLocalCS(mp).transpose();
     
-    double IFD = IntegratedFiberDensity(mp);
-
-	double sed = 0.0;
+	double IFD = (fp ? fp->m_IFD : IntegratedFiberDensity(mp));
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
 	if (it->IsValid())
 	{
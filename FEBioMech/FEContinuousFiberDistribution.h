@@ -58,13 +58,27 @@ public:
 	//! Serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! create material point data
+	FEMaterialPoint* CreateMaterialPointData() override;
+
 private:
 	double IntegratedFiberDensity(FEMaterialPoint& pt);
 
+	// update the cached fiber data at a material point
+	FEFiberMaterialPoint* FiberData(FEMaterialPoint& mp);
+
+	// evaluate the integration points of the fiber integration scheme
+	void InitFibers();
+
 protected:
     FEElasticFiberMaterial*     m_pFmat;    // pointer to fiber material
 	FEFiberDensityDistribution* m_pFDD;     // pointer to fiber density distribution
 	FEFiberIntegrationScheme*   m_pFint;    // pointer to fiber integration scheme
 
+private:
+	vector<vec3d>	m_fiber;	// fiber directions of the integration scheme (undeformed)
+	vector<double>	m_weight;	// integration weights of the fiber directions
+	bool			m_bfixed;	// true if the integration scheme does not depend on the deformation
+
 	DECLARE_FECORE_CLASS();
 };
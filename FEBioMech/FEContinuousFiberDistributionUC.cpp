@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEContinuousFiberDistributionUC.h"
+#include <FECore/FEModel.h>
 
 BEGIN_FECORE_CLASS(FEContinuousFiberDistributionUC, FEUncoupledMaterial)
 	// set material properties
@@ -42,6 +43,7 @@ FEContinuousFiberDistributionUC::FEContinuousFiberDistributionUC(FEModel* pfem)
 	m_pFmat = 0;
 	m_pFDD = 0;
 	m_pFint = 0;
+	m_bfixed = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -51,7 +53,96 @@ FEContinuousFiberDistributionUC::~FEContinuousFiberDistributionUC() {}
 // returns a pointer to a new material point object
 FEMaterialPoint* FEContinuousFiberDistributionUC::CreateMaterialPointData() 
 {
-	return m_pFmat->CreateMaterialPointData();
+	return new FEFiberMaterialPoint(m_pFmat->CreateMaterialPointData());
+}
+
+//-----------------------------------------------------------------------------
+bool FEContinuousFiberDistributionUC::Init()
+{
+	// initialize base class
+	if (FEUncoupledMaterial::Init() == false) return false;
+
+	// evaluate the fiber directions
+	InitFibers();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEContinuousFiberDistributionUC::Serialize(DumpStream& ar)
+{
+	FEUncoupledMaterial::Serialize(ar);
+	if (ar.IsShallow()) return;
+
+	if (ar.IsLoading()) InitFibers();
+}
+
+//-----------------------------------------------------------------------------
+// The integration points that are used for evaluating the integrated fiber density
+// do not depend on the material point, so they are evaluated once here. If the 
+// integration scheme is not deformation dependent, these are also the integration
+// points for the stress and tangent.
+void FEContinuousFiberDistributionUC::InitFibers()
+{
+	m_fiber.clear();
+	m_weight.clear();
+	m_bfixed = (m_pFint->IsDeformationDependent() == false);
+
+	// NOTE: Pass nullptr to GetIterator to avoid issues with GK rule!
+	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(nullptr);
+	if (it->IsValid())
+	{
+		do
+		{
+			m_fiber.push_back(it->m_fiber);
+			m_weight.push_back(it->m_weight);
+		}
+		while (it->Next());
+	}
+	delete it;
+}
+
+//-----------------------------------------------------------------------------
+// Update the fiber data that is cached at the material point. Returns nullptr
+// if the material point does not have fiber data.
+FEFiberMaterialPoint* FEContinuousFiberDistributionUC::FiberData(FEMaterialPoint& mp)
+{
+	FEFiberMaterialPoint* fp = mp.ExtractData<FEFiberMaterialPoint>();
+	if (fp == nullptr) return nullptr;
+
+	// see if the cached data is still valid
+	mat3d Q = GetLocalCS(mp);
+	double time = GetFEModel()->GetTime().currentTime;
+	if (fp->IsValid(Q, time)) return fp;
+
+	// evaluate the fiber densities
+	mat3d QT = Q.transpose();
+	const int nf = (int)m_fiber.size();
+	vector<double>& w = fp->m_w;
+	w.resize(nf);
+	double IFD = 0.0;
+	for (int i = 0; i < nf; ++i)
+	{
+		// rotate to local configuration to evaluate ellipsoidally distributed material coefficients
+		vec3d n0a = QT*m_fiber[i];
+		w[i] = m_pFDD->FiberDensity(mp, n0a)*m_weight[i];
+		IFD += w[i];
+	}
+
+	// just in case
+	if (IFD == 0.0) IFD = 1.0;
+	fp->m_IFD = IFD;
+
+	// the weights are only needed if the integration points are fixed
+	if (m_bfixed)
+	{
+		for (int i = 0; i < nf; ++i) w[i] /= IFD;
+	}
+	else w.clear();
+
+	fp->SetValid(Q, time);
+
+	return fp;
 }
 
 //-----------------------------------------------------------------------------
@@ -63,10 +154,19 @@ mat3ds FEContinuousFiberDistributionUC::DevStress(FEMaterialPoint& mp)
 	// calculate stress
 	mat3ds s; s.zero();
 
+	// use the cached weights if the integration points are fixed
+	FEFiberMaterialPoint* fp = FiberData(mp);
+	if (fp && m_bfixed)
+	{
+		const int nf = (int)m_fiber.size();
+		for (int i = 0; i < nf; ++i) s += m_pFmat->DevFiberStress(pt, m_fiber[i])*fp->m_w[i];
+		return s;
+	}
+
 	// get the local coordinate systems
 	mat3d QT = GetLocalCS(mp).transpose();
 
-	double IFD = IntegratedFiberDensity(mp);
+	double IFD = (fp ? fp->m_IFD : IntegratedFiberDensity(mp));
 
 	// obtain an integration point iterator
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
@@ -108,7 +208,16 @@ tens4ds FEContinuousFiberDistributionUC::DevTangent(FEMaterialPoint& mp)
 	tens4ds c;
 	c.zero();
 
-	double IFD = IntegratedFiberDensity(pt);
+	// use the cached weights if the integration points are fixed
+	FEFiberMaterialPoint* fp = FiberData(mp);
+	if (fp && m_bfixed)
+	{
+		const int nf = (int)m_fiber.size();
+		for (int i = 0; i < nf; ++i) c += m_pFmat->DevFiberTangent(mp, m_fiber[i])*fp->m_w[i];
+		return c;
+	}
+
+	double IFD = (fp ? fp->m_IFD : IntegratedFiberDensity(pt));
 
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
 	if (it->IsValid())
@@ -144,8 +253,18 @@ double FEContinuousFiberDistributionUC::DevStrainEnergyDensity(FEMaterialPoint&
 	// get the local coordinate systems
 	mat3d QT = GetLocalCS(mp).transpose();
 
-	double IFD = IntegratedFiberDensity(mp);
 	double sed = 0.0;
+
+	// use the cached weights if the integration points are fixed
+	FEFiberMaterialPoint* fp = FiberData(mp);
+	if (fp && m_bfixed)
+	{
+		const int nf = (int)m_fiber.size();
+		for (int i = 0; i < nf; ++i) sed += m_pFmat->DevFiberStrainEnergyDensity(mp, m_fiber[i])*fp->m_w[i];
+		return sed;
+	}
+
+	double IFD = (fp ? fp->m_IFD : IntegratedFiberDensity(mp));
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&pt);
 	if (it->IsValid())
 	{
@@ -55,13 +55,30 @@ public:
 	// returns a pointer to a new material point object
 	FEMaterialPoint* CreateMaterialPointData() override;
 
+	// Initialization
+	bool Init() override;
+
+	//! Serialization
+	void Serialize(DumpStream& ar) override;
+
 private:
 	double IntegratedFiberDensity(FEMaterialPoint& pt);
 
+	// update the cached fiber data at a material point
+	FEFiberMaterialPoint* FiberData(FEMaterialPoint& mp);
+
+	// evaluate the integration points of the fiber integration scheme
+	void InitFibers();
+
 public:
     FEElasticFiberMaterialUC*   m_pFmat;    // pointer to fiber material
 	FEFiberDensityDistribution* m_pFDD;     // pointer to fiber density distribution
 	FEFiberIntegrationScheme*	m_pFint;    // pointer to fiber integration scheme
 
+private:
+	vector<vec3d>	m_fiber;	// fiber directions of the integration scheme (undeformed)
+	vector<double>	m_weight;	// integration weights of the fiber directions
+	bool			m_bfixed;	// true if the integration scheme does not depend on the deformation
+
 	DECLARE_FECORE_CLASS();
 };
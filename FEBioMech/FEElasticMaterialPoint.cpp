@@ -30,7 +30,17 @@ SOFTWARE.*/
 #include "FEElasticMaterialPoint.h"
 
 //-----------------------------------------------------------------------------
-FEElasticMaterialPoint::FEElasticMaterialPoint()
+// fields that are stored in the arena
+static const int FIELD_F = FEMaterialPointArena::NewField();
+static const int FIELD_J = FEMaterialPointArena::NewField();
+static const int FIELD_S = FEMaterialPointArena::NewField();
+
+//-----------------------------------------------------------------------------
+FEElasticMaterialPoint::FEElasticMaterialPoint() : 
+	m_local(FEMaterialPointArena::Active() ? nullptr : new FIELDS),
+	m_F(FEMaterialPointArena::FieldEntry<mat3d >(FIELD_F, m_local ? &m_local->F : nullptr)),
+	m_J(FEMaterialPointArena::FieldEntry<double>(FIELD_J, m_local ? &m_local->J : nullptr)),
+	m_s(FEMaterialPointArena::FieldEntry<mat3ds>(FIELD_S, m_local ? &m_local->s : nullptr))
 {
 	m_F.unit();
 	m_J = 1;
@@ -40,6 +50,32 @@ FEElasticMaterialPoint::FEElasticMaterialPoint()
     m_Wt = m_Wp = 0;
 }
 
+//-----------------------------------------------------------------------------
+FEElasticMaterialPoint::FEElasticMaterialPoint(const FEElasticMaterialPoint& pt) : FEMaterialPoint(pt),
+	m_local(FEMaterialPointArena::Active() ? nullptr : new FIELDS),
+	m_F(FEMaterialPointArena::FieldEntry<mat3d >(FIELD_F, m_local ? &m_local->F : nullptr)),
+	m_J(FEMaterialPointArena::FieldEntry<double>(FIELD_J, m_local ? &m_local->J : nullptr)),
+	m_s(FEMaterialPointArena::FieldEntry<mat3ds>(FIELD_S, m_local ? &m_local->s : nullptr))
+{
+	m_buncoupled = pt.m_buncoupled;
+	m_rt = pt.m_rt;
+	m_F = pt.m_F;
+	m_J = pt.m_J;
+	m_gradJ = pt.m_gradJ;
+	m_v = pt.m_v;
+	m_a = pt.m_a;
+	m_L = pt.m_L;
+	m_s = pt.m_s;
+	m_Wt = pt.m_Wt;
+	m_Wp = pt.m_Wp;
+}
+
+//-----------------------------------------------------------------------------
+FEElasticMaterialPoint::~FEElasticMaterialPoint()
+{
+	delete m_local;
+}
+
 //-----------------------------------------------------------------------------
 FEMaterialPoint* FEElasticMaterialPoint::Copy()
 {
@@ -34,12 +34,22 @@ SOFTWARE.*/
 
 //-----------------------------------------------------------------------------
 //! This class defines material point data for elastic materials.
+//! The deformation gradient, its determinant, and the stress are stored in the
+//! field arrays of the domain's arena (see FEMaterialPointArena), and the point
+//! refers to its entries in these arrays. Points that are created outside of 
+//! an arena (e.g. temporary points) store these fields themselves.
 class FEBIOMECH_API FEElasticMaterialPoint : public FEMaterialPoint
 {
 public:
 	//! constructor
 	FEElasticMaterialPoint();
 
+	//! copy constructor (the copy gets its own field entries)
+	FEElasticMaterialPoint(const FEElasticMaterialPoint& pt);
+
+	//! destructor
+	~FEElasticMaterialPoint();
+
 	//! Initialize material point data
 	void Init() override;
 
@@ -73,20 +83,32 @@ public:
 	tens4ds pull_back(const tens4ds& C) const;
 	tens4ds push_forward(const tens4ds& C) const;
 
+private:
+	// field storage for points that are not created in an arena
+	struct FIELDS
+	{
+		mat3d	F;
+		double	J;
+		mat3ds	s;
+	};
+	FIELDS*	m_local;	//!< (null for points in an arena)
+
+	void operator = (const FEElasticMaterialPoint&) = delete;
+
 public:
     bool    m_buncoupled;   //!< set to true if this material point was created by an uncoupled material
     
 	// deformation data at intermediate time
     vec3d   m_rt;   //!< spatial position
-	mat3d	m_F;	//!< deformation gradient
-	double	m_J;	//!< determinant of F
+	mat3d&	m_F;	//!< deformation gradient
+	double&	m_J;	//!< determinant of F
     vec3d   m_gradJ;  //!< gradient of J
     vec3d   m_v;    //!< velocity
     vec3d   m_a;    //!< acceleration
     mat3d   m_L;    //!< spatial velocity gradient
 
 	// solid material data
-	mat3ds		m_s;		//!< Cauchy stress
+	mat3ds&		m_s;		//!< Cauchy stress
     
     // current time data
     double      m_Wt;       //!< strain energy density at current time
@@ -50,6 +50,7 @@ BEGIN_FECORE_CLASS(FEFacet2FacetSliding, FEContactInterface)
 	ADD_PARAMETER(m_knmult   , "knmult"       );
 	ADD_PARAMETER(m_stol     , "search_tol"   );
 	ADD_PARAMETER(m_srad     , "search_radius");
+	ADD_PARAMETER(m_bprad    , "broad_phase_radius");
 	ADD_PARAMETER(m_dxtol    , "dxtol"        );
 	ADD_PARAMETER(m_mu       , "fric_coeff"   );
 	ADD_PARAMETER(m_epsf     , "fric_penalty" );
@@ -259,6 +260,7 @@ FEFacet2FacetSliding::FEFacet2FacetSliding(FEModel* pfem) : FEContactInterface(p
 	m_naugmin = 0;
 	m_naugmax = 10;
 	m_srad = 1.0;
+	m_bprad = 0.0;
 
 	m_dxtol = 0;
 
@@ -314,7 +316,7 @@ void FEFacet2FacetSliding::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (int l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						int* id = mesh.Node(sn[l]).m_ID;
 						lm[6*l  ] = id[dof_X];
 						lm[6*l+1] = id[dof_Y];
 						lm[6*l+2] = id[dof_Z];
@@ -325,7 +327,7 @@ void FEFacet2FacetSliding::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (int l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						int* id = mesh.Node(mn[l]).m_ID;
 						lm[6*(l+nseln)  ] = id[dof_X];
 						lm[6*(l+nseln)+1] = id[dof_Y];
 						lm[6*(l+nseln)+2] = id[dof_Z];
@@ -425,6 +427,10 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 	cpp.SetTolerance(m_stol);
 	cpp.Init();
 
+	// the broad phase is only used when a distance was specified
+	bool bbroad = (m_bprad > 0.0);
+	if (bbroad) ms.UpdateBroadPhase();
+
 	// if we need to project the nodes onto the secondary surface,
 	// let's do this first
 	if (bmove)
@@ -449,6 +455,9 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 		for (int i=0; i<NN; ++i) normal[i].unit();
 
 		// loop over all nodes
+		// (neighboring nodes project to nearby points, so we use the last
+		// closest node as a starting point for the next search)
+		int nhint = -1;
 		for (int i=0; i<NN; ++i)
 		{
 			FENode& node = ss.Node(i);
@@ -460,7 +469,7 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 			// project onto the secondary surface
 			vec3d q;
 			vec2d rs(0,0);
-			FESurfaceElement* pme = cpp.Project(rt, q, rs);
+			FESurfaceElement* pme = cpp.Project(rt, q, rs, nhint);
 			if (pme) 
 			{
 				double gap = (nu*(rt - q));
@@ -496,6 +505,13 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 			vec3d x(0,0,0), q;
 			for (int k=0; k<nn; ++k) x += re[k]*H[k];
 
+			// points that are far away from the secondary surface cannot be in contact
+			bool bnear = ((bbroad == false) || ms.BroadPhase(pt, x, m_bprad));
+			if (bnear == false) pt.m_pme = 0;
+
+			// the previous target element provides a good starting point for the search
+			int nhint = (pt.m_pme ? pt.m_pme->m_lnode[0] : -1);
+
 			// see if the point still projects to the same element
 			if (pt.m_pme)
 			{
@@ -509,16 +525,16 @@ void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlid
 					// if not, do a new search
 					pt.m_rs = vec2d(0,0);
 					FESurfaceElement* pme = 0;
-					pme = cpp.Project(x, q, pt.m_rs);
+					pme = cpp.Project(x, q, pt.m_rs, nhint);
 					pt.m_pme = pme;
 				}
 			}
-			if (bsegup)
+			if (bsegup && bnear)
 			{
 				// find the secondary surface segment this element belongs to
 				pt.m_rs = vec2d(0,0);
 				FESurfaceElement* pme = 0;
-				pme = cpp.Project(x, q, pt.m_rs);
+				pme = cpp.Project(x, q, pt.m_rs, nhint);
 				pt.m_pme = pme;
 			}
 
@@ -144,6 +144,7 @@ public:
 	bool	m_bautopen;		//!< auto-penalty flag
     bool    m_bupdtpen;     //!< update penalty at each time step
 	double	m_srad;			//!< search radius (% of model size)
+	double	m_bprad;		//!< broad-phase search distance (0 = no broad phase)
 	int		m_nsegup;		//!< segment update parameter
 	bool	m_breloc;       //!< node relocation on initialization
     bool    m_bsmaug;       //!< smooth augmentation
@@ -57,6 +57,9 @@ public:
 	// get iterator
 	virtual FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp) override;
 
+	// the integration points depend on the principal directions of the strain
+	bool IsDeformationDependent() const override { return true; }
+
 protected:
 	bool InitRule();
     
@@ -58,6 +58,9 @@ public:
 	// get the iterator
 	FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp) override;
 
+	// the integration points depend on the principal directions of the strain
+	bool IsDeformationDependent() const override { return true; }
+
 protected:
 	bool InitRule();
     
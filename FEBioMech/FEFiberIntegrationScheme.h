@@ -69,4 +69,8 @@ public:
 	// In general, the integration scheme may depend on the material point.
 	// The passed material point pointer will be zero when evaluating the integrated fiber density
 	virtual FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp = 0) = 0;
+
+	// Returns true if the integration points depend on the deformation at the material point.
+	// If not, the integration points are always the same and can be evaluated once.
+	virtual bool IsDeformationDependent() const { return false; }
 };
@@ -26,4 +26,58 @@ SOFTWARE.*/
 
 
 
+#include "stdafx.h"
 #include "FEFiberMaterialPoint.h"
+#include <FECore/DumpStream.h>
+
+//-----------------------------------------------------------------------------
+FEFiberMaterialPoint::FEFiberMaterialPoint(FEMaterialPoint* pt) : FEMaterialPoint(pt)
+{
+	m_IFD = 1.0;
+	m_bvalid = false;
+	m_time = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPoint* FEFiberMaterialPoint::Copy()
+{
+	FEFiberMaterialPoint* pt = new FEFiberMaterialPoint(*this);
+	if (m_pNext) pt->m_pNext = m_pNext->Copy();
+	return pt;
+}
+
+//-----------------------------------------------------------------------------
+void FEFiberMaterialPoint::Init()
+{
+	FEMaterialPoint::Init();
+
+	// the material parameters may have changed
+	Invalidate();
+}
+
+//-----------------------------------------------------------------------------
+void FEFiberMaterialPoint::Serialize(DumpStream& ar)
+{
+	FEMaterialPoint::Serialize(ar);
+
+	// the cached data is not stored, so it will be reevaluated after a restart
+	if (ar.IsLoading()) Invalidate();
+}
+
+//-----------------------------------------------------------------------------
+bool FEFiberMaterialPoint::IsValid(const mat3d& Q, double time) const
+{
+	if ((m_bvalid == false) || (time != m_time)) return false;
+	for (int i = 0; i < 3; ++i)
+		for (int j = 0; j < 3; ++j)
+			if (Q[i][j] != m_Q[i][j]) return false;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEFiberMaterialPoint::SetValid(const mat3d& Q, double time)
+{
+	m_Q = Q;
+	m_time = time;
+	m_bvalid = true;
+}
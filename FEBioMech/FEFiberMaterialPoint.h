@@ -28,3 +28,42 @@ SOFTWARE.*/
 
 #pragma once
 #include "FECore/FEMaterial.h"
+#include "febiomech_api.h"
+
+//-----------------------------------------------------------------------------
+// Material point data for continuous fiber distributions. It caches the
+// integrated fiber density and, for integration schemes that do not depend on
+// the deformation, the normalized weights (i.e. density times integration weight,
+// divided by the integrated fiber density) of all fiber directions. The fiber
+// density only depends on the local coordinate system and on the material
+// parameters, so the cache is only updated when either of these (or the time) changes.
+class FEBIOMECH_API FEFiberMaterialPoint : public FEMaterialPoint
+{
+public:
+	FEFiberMaterialPoint(FEMaterialPoint* pt);
+
+	FEMaterialPoint* Copy() override;
+
+	void Init() override;
+
+	void Serialize(DumpStream& ar) override;
+
+public:
+	//! see if the cached data is valid for this coordinate system and time
+	bool IsValid(const mat3d& Q, double time) const;
+
+	//! mark the cached data as valid for this coordinate system and time
+	void SetValid(const mat3d& Q, double time);
+
+	//! invalidate the cached data
+	void Invalidate() { m_bvalid = false; }
+
+public:
+	double			m_IFD;	//!< integrated fiber density
+	vector<double>	m_w;	//!< normalized fiber weights
+
+private:
+	bool	m_bvalid;	//!< is the cached data valid
+	mat3d	m_Q;		//!< local coordinate system the data was evaluated for
+	double	m_time;		//!< time the data was evaluated at
+};
@@ -37,6 +37,9 @@ FEMortarInterface::FEMortarInterface(FEModel* pfem) : FEContactInterface(pfem)
 {
 	// set the integration rule
 	m_pT = dynamic_cast<FESurfaceElementTraits*>(FEElementLibrary::GetElementTraits(FE_TRI3G7));
+
+	// by default the patches are recalculated whenever the surfaces deform
+	m_patch_tol = 0.0;
 }
 
 //-----------------------------------------------------------------------------
@@ -59,9 +62,11 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 	vector<double>& gr = m_pT->gr;
 	vector<double>& gs = m_pT->gs;
 
-	// calculate the mortar surface
-	MortarSurface mortar;
-	CalculateMortarSurface(ss, ms, mortar);
+	// update the mortar surface
+	// (only the patches of facets that moved are recalculated)
+	MortarSurface& mortar = m_mortar;
+	mortar.SetTolerance(m_patch_tol);
+	mortar.Update(ss, ms);
 
 	// These arrays will store the shape function values of the projection points 
 	// on the primary and secondary side when evaluating the integral over a pallet
@@ -72,11 +77,11 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 	for (int i=0; i<NP; ++i)
 	{
 		// get the next patch
-		Patch& pi = mortar.GetPatch(i);
+		const MortarSurface::PATCH& pi = mortar.GetPatch(i);
 
 		// get the facet ID's that generated this patch
-		int k = pi.GetPrimaryFacetID();
-		int l = pi.GetSecondaryFacetID();
+		int k = pi.primary;
+		int l = pi.secondary;
 
 		// get the non-mortar surface element
 		FESurfaceElement& se = ss.Element(k);
@@ -84,11 +89,11 @@ void FEMortarInterface::UpdateMortarWeights(FESurface& ss, FESurface& ms)
 		FESurfaceElement& me = ms.Element(l);
 
 		// loop over all patch triangles
-		int np = pi.Size();
+		int np = pi.count;
 		for (int j=0; j<np; ++j)
 		{
 			// get the next facet
-			Patch::FACET& fj = pi.Facet(j);
+			Patch::FACET& fj = mortar.Facet(pi, j);
 
 			// calculate the patch area
 			// (We multiply by two because the sum of the integration weights in FEBio sum up to the area
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEMortarContactSurface.h"
+#include <FECore/mortar.h>
 
 //-----------------------------------------------------------------------------
 // Base class for mortar-type contact formulations
@@ -48,6 +49,9 @@ protected:
 	matrix	m_n1;	//!< integration weights n1_AB
 	matrix	m_n2;	//!< integration weights n2_AB
 
+	MortarSurface	m_mortar;		//!< the mortar patches
+	double			m_patch_tol;	//!< relative motion below which patches are reused
+
 private:
 	// integration rule
 	FESurfaceElementTraits*	m_pT;
@@ -116,6 +116,7 @@ BEGIN_FECORE_CLASS(FEMortarSlidingContact, FEMortarInterface)
 	ADD_PARAMETER(m_eps    , "penalty"      );
 	ADD_PARAMETER(m_naugmin, "minaug"       );
 	ADD_PARAMETER(m_naugmax, "maxaug"       );
+	ADD_PARAMETER(m_patch_tol, "patch_tol"  );
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
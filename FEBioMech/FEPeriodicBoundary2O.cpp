@@ -146,7 +146,7 @@ void FEPeriodicBoundary2O::BuildMatrixProfile(FEGlobalMatrix& K)
 
 		for (int k=0; k<n; ++k)
 		{
-			vector<int>& id = mesh.Node(en[k]).m_ID;
+			int* id = mesh.Node(en[k]).m_ID;
 			lm[6*(k+1)  ] = id[dof_X];
 			lm[6*(k+1)+1] = id[dof_Y];
 			lm[6*(k+1)+2] = id[dof_Z];
@@ -180,10 +180,7 @@ void FEPeriodicBoundary2O::ProjectSurface(FEPeriodicSurface& ss, FEPeriodicSurfa
 	vec3d cn(cr); cn.unit();
 
 	// initialize projection data
-	FENormalProjection np(ms);
-	np.SetTolerance(m_stol);
-	np.SetSearchRadius(m_srad);
-	np.Init();
+	FENormalProjection& np = ms.GetNormalProjection(m_stol, m_srad);
 
 	// loop over all primary nodes
 	for (i=0; i<ss.Nodes(); ++i)
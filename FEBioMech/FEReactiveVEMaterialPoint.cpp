@@ -29,6 +29,13 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEReactiveVEMaterialPoint.h"
 #include "FEElasticMaterial.h"
+#include <FECore/FECounter.h>
+
+//-----------------------------------------------------------------------------
+// compaction statistics
+static FECounter s_genCreated("Reactive VE generations created");
+static FECounter s_genDropped("Reactive VE generations dropped");
+static FECounter s_genMerged ("Reactive VE generations merged");
 
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -67,29 +74,167 @@ void FEReactiveVEMaterialPoint::Update(const FETimeInfo& timeInfo)
 
 	// check if the current deformation gradient is different from that of
 	// the last generation, in which case store the current state
-	if (m_pRve) {
-	    if (m_pRve->NewGeneration(*this)) {
-		    m_Fi.push_back(pt.m_F.inverse());
-	        m_Ji.push_back(1./pt.m_J);
-			m_v.push_back(timeInfo.currentTime);
-			double w = m_pRve->ReformingBondMassFraction(*this);
-			m_w.push_back(w);
-		}
-	}
-	else {
-		if (m_pRuc->NewGeneration(*this)) {
-			m_Fi.push_back(pt.m_F.inverse());
-			m_Ji.push_back(1./pt.m_J);
-			m_v.push_back(timeInfo.currentTime);
-			double w = m_pRuc->ReformingBondMassFraction(*this);
-			m_w.push_back(w);
-		}
+	bool bnew = (m_pRve ? m_pRve->NewGeneration(*this) : m_pRuc->NewGeneration(*this));
+	if (bnew) {
+		m_Fi.push_back(pt.m_F.inverse());
+		m_Ji.push_back(1./pt.m_J);
+		m_v.push_back(timeInfo.currentTime);
+		double w = (m_pRve ? m_pRve->ReformingBondMassFraction(*this) : m_pRuc->ReformingBondMassFraction(*this));
+		m_w.push_back(w);
+		s_genCreated.Add();
+
+		// keep the history bounded
+		if (MergeEnabled()) CompactGenerations();
 	}
     
     // don't forget to initialize the base class
     FEMaterialPoint::Update(timeInfo);
 }
 
+//-----------------------------------------------------------------------------
+bool FEReactiveVEMaterialPoint::MergeEnabled() const
+{
+	if (m_pRve) return ((m_pRve->m_mtol > 0.0) || (m_pRve->m_nmax > 0));
+	else return ((m_pRuc->m_mtol > 0.0) || (m_pRuc->m_nmax > 0));
+}
+
+//-----------------------------------------------------------------------------
+//! The distance between two consecutive generations is measured by the
+//! Lagrangian strain of the relative deformation between them.
+double FEReactiveVEMaterialPoint::GenerationDistance(int ig) const
+{
+	mat3d Fu = m_Fi[ig + 1].inverse()*m_Fi[ig];
+	mat3ds E = ((Fu.transpose()*Fu).sym() - mat3dd(1)) / 2;
+	return E.norm();
+}
+
+//-----------------------------------------------------------------------------
+//! Evaluate the current mass fraction of generation ig
+double FEReactiveVEMaterialPoint::BondMassFraction(int ig)
+{
+	FEElasticMaterialPoint& ep = *ExtractData<FEElasticMaterialPoint>();
+	mat3ds D = ep.RateOfDeformation();
+	if (m_pRve) return m_pRve->BreakingBondMassFraction(*this, ig, D);
+	else return m_pRuc->BreakingBondMassFraction(*this, ig, D);
+}
+
+//-----------------------------------------------------------------------------
+//! remove generation ig
+void FEReactiveVEMaterialPoint::RemoveGeneration(int ig)
+{
+	m_Fi.erase(m_Fi.begin() + ig);
+	m_Ji.erase(m_Ji.begin() + ig);
+	m_v.erase(m_v.begin() + ig);
+	m_w.erase(m_w.begin() + ig);
+}
+
+//-----------------------------------------------------------------------------
+//! Merge generation ig into generation ig+1. The merged generation keeps the
+//! deformation state of generation ig+1 and carries the current mass fraction
+//! (wa + wb) of both generations.
+//! For kinetics of type 2 the mass fraction of a generation depends on the
+//! start time of the previous generation, so removing generation ig transfers
+//! its mass to generation ig+1 exactly. For type 1 the initial mass fraction of
+//! generation ig+1 is scaled, so that the merged generation has the correct mass
+//! fraction now. Since it then relaxes from the start time of generation ig+1,
+//! the mass fraction at later times is only approximated for type 1.
+void FEReactiveVEMaterialPoint::MergeGeneration(int ig, double wa, double wb)
+{
+	int btype = (m_pRve ? m_pRve->m_btype : m_pRuc->m_btype);
+	if ((btype == 1) && (wb > 0.0))
+	{
+		m_w[ig + 1] *= (wa + wb) / wb;
+	}
+
+	RemoveGeneration(ig);
+}
+
+//-----------------------------------------------------------------------------
+//! Compact the generation history. The mass fractions are evaluated for the
+//! current state of the material point. By default, only the oldest generations
+//! are culled once they have relaxed below wmin. If merge_tol or max_generations
+//! is set, compaction is done in three passes:
+//! (1) generations whose mass fraction dropped below wmin are removed;
+//! (2) consecutive generations that are closer than merge_tol are merged;
+//! (3) if more than max_generations generations remain, the pairs of generations
+//!     whose merging introduces the smallest error are merged.
+//! The newest generation is never removed since it is used to detect new generations.
+void FEReactiveVEMaterialPoint::CompactGenerations()
+{
+	double wmin, mtol; int nmax, btype;
+	if (m_pRve) { wmin = m_pRve->m_wmin; mtol = m_pRve->m_mtol; nmax = m_pRve->m_nmax; btype = m_pRve->m_btype; }
+	else { wmin = m_pRuc->m_wmin; mtol = m_pRuc->m_mtol; nmax = m_pRuc->m_nmax; btype = m_pRuc->m_btype; }
+
+	if (MergeEnabled() == false)
+	{
+		// always check oldest generation
+		while ((m_Fi.size() > 1) && (BondMassFraction(0) <= wmin))
+		{
+			m_Fi.pop_front();
+			m_Ji.pop_front();
+			m_v.pop_front();
+			m_w.pop_front();
+			s_genDropped.Add();
+		}
+		return;
+	}
+
+	// evaluate the current mass fractions
+	vector<double> wc(m_Fi.size());
+	for (int ig = 0; ig < (int)wc.size(); ++ig) wc[ig] = BondMassFraction(ig);
+
+	// drop relaxed generations
+	for (int ig = (int)m_Fi.size() - 2; ig >= 0; --ig)
+	{
+		if (wc[ig] <= wmin)
+		{
+			// for type 2 kinetics the next generation takes over the remaining mass
+			if (btype == 2) wc[ig + 1] += wc[ig];
+			RemoveGeneration(ig);
+			wc.erase(wc.begin() + ig);
+			s_genDropped.Add();
+		}
+	}
+
+	// merge generations that are nearly equal
+	if (mtol > 0.0)
+	{
+		for (int ig = (int)m_Fi.size() - 2; ig >= 0; --ig)
+		{
+			if (GenerationDistance(ig) <= mtol)
+			{
+				double wa = wc[ig], wb = wc[ig + 1];
+				MergeGeneration(ig, wa, wb);
+				wc.erase(wc.begin() + ig);
+				wc[ig] = wa + wb;
+				s_genMerged.Add();
+			}
+		}
+	}
+
+	// enforce the capacity
+	if (nmax > 0)
+	{
+		while ((int)m_Fi.size() > nmax)
+		{
+			// find the generation whose merging introduces the smallest error
+			int imin = 0;
+			double emin = wc[0]*GenerationDistance(0);
+			for (int ig = 1; ig < (int)m_Fi.size() - 1; ++ig)
+			{
+				double e = wc[ig]*GenerationDistance(ig);
+				if (e < emin) { emin = e; imin = ig; }
+			}
+
+			double wa = wc[imin], wb = wc[imin + 1];
+			MergeGeneration(imin, wa, wb);
+			wc.erase(wc.begin() + imin);
+			wc[imin] = wa + wb;
+			s_genMerged.Add();
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! Serialize data to the archive
 void FEReactiveVEMaterialPoint::Serialize(DumpStream& ar)
@@ -111,5 +256,6 @@ void FEReactiveVEMaterialPoint::Serialize(DumpStream& ar)
 		m_v.resize(n);
 		m_w.resize(n);
         for (int i=0; i<n; ++i) ar >> m_Fi[i] >> m_Ji[i] >> m_v[i] >> m_w[i];
+
     }
 }
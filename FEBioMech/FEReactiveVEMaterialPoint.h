@@ -55,7 +55,26 @@ public:
     
     //! Serialize data to archive
     void Serialize(DumpStream& ar);
-    
+
+    //! drop relaxed generations, merge similar generations and enforce the generation capacity
+    void CompactGenerations();
+
+private:
+    //! true if generations are merged (merge_tol or max_generations set)
+    bool MergeEnabled() const;
+
+    //! measure of the difference between generation ig and the next
+    double GenerationDistance(int ig) const;
+
+    //! merge generation ig into generation ig+1
+    void MergeGeneration(int ig, double wa, double wb);
+
+    //! remove generation ig
+    void RemoveGeneration(int ig);
+
+    //! current mass fraction of generation ig
+    double BondMassFraction(int ig);
+
 public:
     // multigenerational material data
     deque <mat3d>  m_Fi;	//!< inverse of relative deformation gradient
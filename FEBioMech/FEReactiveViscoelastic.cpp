@@ -42,6 +42,8 @@ SOFTWARE.*/
 // Material parameters for the FEMultiphasic material
 BEGIN_FECORE_CLASS(FEReactiveViscoelasticMaterial, FEElasticMaterial)
     ADD_PARAMETER(m_wmin , FE_RANGE_CLOSED(0.0, 1.0), "wmin");
+	ADD_PARAMETER(m_mtol , FE_RANGE_GREATER_OR_EQUAL(0.0), "merge_tol");
+	ADD_PARAMETER(m_nmax , FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
     ADD_PARAMETER(m_btype, FE_RANGE_CLOSED(1,2), "kinetics");
     ADD_PARAMETER(m_ttype, FE_RANGE_CLOSED(0,2), "trigger");
 
@@ -57,6 +59,8 @@ END_FECORE_CLASS();
 FEReactiveViscoelasticMaterial::FEReactiveViscoelasticMaterial(FEModel* pfem) : FEElasticMaterial(pfem)
 {
     m_wmin = 0;
+    m_mtol = 0;
+    m_nmax = 0;
     m_btype = 0;
     m_ttype = 0;
 
@@ -410,34 +414,11 @@ double FEReactiveViscoelasticMaterial::StrainEnergyDensity(FEMaterialPoint& mp)
 }
 
 //-----------------------------------------------------------------------------
-//! Cull generations that have relaxed below a threshold
+//! Cull generations that have relaxed below a threshold and compact the remaining ones
 void FEReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& mp)
 {
-    // get the elastic part
-    FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
-    
     // get the reactive viscoelastic point data
     FEReactiveVEMaterialPoint& pt = *mp.ExtractData<FEReactiveVEMaterialPoint>();
-    
-    mat3ds D = ep.RateOfDeformation();
-    
-    if (pt.m_Fi.empty()) return;
 
-    // culling termination flag
-    bool done = false;
-    
-    // always check oldest generation
-    while (!done) {
-        double w = BreakingBondMassFraction(mp, 0, D);
-        if ((w > m_wmin) || (pt.m_Fi.size() == 1))
-            done = true;
-        else {
-            pt.m_Fi.pop_front();
-            pt.m_Ji.pop_front();
-            pt.m_v.pop_front();
-            pt.m_w.pop_front();
-        }
-    }
-    
-    return;
+    pt.CompactGenerations();
 }
@@ -87,6 +87,8 @@ private:
     
 public:
     double	m_wmin;		//!< minimum value of relaxation
+    double	m_mtol;		//!< tolerance for merging generations
+    int		m_nmax;		//!< maximum number of generations (0 = unlimited)
     int     m_btype;    //!< bond kinetics type
     int     m_ttype;    //!< bond breaking trigger type
     
@@ -46,6 +46,8 @@ public:
 	//! destructor
 	~FEResidualVector();
 
+	using FEGlobalVector::Assemble;
+
 	//! Assemble the element vector into this global vector
 	void Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom = false) override;
 
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FECore/FEAnalysis.h"
 #include <FECore/FELinearSystem.h>
 #include <FECore/log.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 // Define sliding interface parameters
@@ -48,6 +49,8 @@ BEGIN_FECORE_CLASS(FESlidingElasticInterface, FEContactInterface)
 	ADD_PARAMETER(m_bsymm    , "symmetric_stiffness");
 	ADD_PARAMETER(m_srad     , "search_radius"      );
 	ADD_PARAMETER(m_nsegup   , "seg_up"             );
+	ADD_PARAMETER(m_bprad    , "broad_phase_radius" );
+	ADD_PARAMETER(m_prad     , "profile_radius"     );
 	ADD_PARAMETER(m_btension , "tension"            );
 	ADD_PARAMETER(m_naugmin  , "minaug"             );
 	ADD_PARAMETER(m_naugmax  , "maxaug"             );
@@ -285,6 +288,8 @@ FESlidingElasticInterface::FESlidingElasticInterface(FEModel* pfem) : FEContactI
     m_stol = 0.01;
     m_bsymm = true;
     m_srad = 1.0;
+    m_bprad = 0.0;
+    m_prad = 0.0;
     m_nsegup = 0;
     m_bautopen = false;
 	m_bupdtpen = false;
@@ -384,6 +389,12 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
     for (int np=0; np<npass; ++np)
     {
         FESlidingElasticSurface& ss = (np == 0? m_ss : m_ms);
+        FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
+        
+        // When a profile radius is given, each primary element is connected to all
+        // secondary elements in its neighborhood. This profile remains valid as long
+        // as the contact pairs stay within these neighborhoods (see ProfileChanged).
+        if (m_prad > 0) BuildProfileNeighborhood(ss, ms, np);
         
         int k, l;
         for (int j=0; j<ss.Elements(); ++j)
@@ -391,11 +402,16 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
             FESurfaceElement& se = ss.Element(j);
             int nint = se.GaussPoints();
             int* sn = &se.m_node[0];
-            for (k=0; k<nint; ++k)
+            int nk = (m_prad > 0 ? m_nbrOff[np][j+1] - m_nbrOff[np][j] : nint);
+            for (k=0; k<nk; ++k)
             {
-				FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(k));
-
-                FESurfaceElement* pe = data.m_pme;
+                FESurfaceElement* pe = 0;
+                if (m_prad > 0) pe = &ms.Element(m_nbr[np][m_nbrOff[np][j] + k]);
+                else
+                {
+                    FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(k));
+                    pe = data.m_pme;
+                }
                 
                 if (pe != 0)
                 {
@@ -409,7 +425,7 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nseln; ++l)
                     {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
+                        int* id = mesh.Node(sn[l]).m_ID;
                         lm[6*l  ] = id[dof_X];
                         lm[6*l+1] = id[dof_Y];
                         lm[6*l+2] = id[dof_Z];
@@ -420,7 +436,7 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nmeln; ++l)
                     {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
+                        int* id = mesh.Node(mn[l]).m_ID;
                         lm[6*(l+nseln)  ] = id[dof_X];
                         lm[6*(l+nseln)+1] = id[dof_Y];
                         lm[6*(l+nseln)+2] = id[dof_Z];
@@ -436,6 +452,69 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
     }
 }
 
+//-----------------------------------------------------------------------------
+void FESlidingElasticInterface::BuildProfileNeighborhood(FESlidingElasticSurface& ss, FESlidingElasticSurface& ms, int np)
+{
+    ms.UpdateBroadPhase();
+    
+    int NE = ss.Elements();
+    vector<int>& off = m_nbrOff[np];
+    vector<int>& nbr = m_nbr[np];
+    off.assign(NE + 1, 0);
+    nbr.clear();
+    
+    vector<int> sel;
+    for (int i=0; i<NE; ++i)
+    {
+        // get the box of this element, inflated by the profile radius
+        FESurfaceElement& el = ss.Element(i);
+        vec3d r0 = (ss.IsShellBottom() ? ss.Node(el.m_lnode[0]).m_st() : ss.Node(el.m_lnode[0]).m_rt);
+        vec3d cmin = r0, cmax = r0;
+        for (int j=1; j<el.Nodes(); ++j)
+        {
+            vec3d r = (ss.IsShellBottom() ? ss.Node(el.m_lnode[j]).m_st() : ss.Node(el.m_lnode[j]).m_rt);
+            cmin.x = std::min(cmin.x, r.x); cmax.x = std::max(cmax.x, r.x);
+            cmin.y = std::min(cmin.y, r.y); cmax.y = std::max(cmax.y, r.y);
+            cmin.z = std::min(cmin.z, r.z); cmax.z = std::max(cmax.z, r.z);
+        }
+        cmin -= vec3d(m_prad, m_prad, m_prad);
+        cmax += vec3d(m_prad, m_prad, m_prad);
+        
+        ms.FindElementsInBox(cmin, cmax, sel);
+        nbr.insert(nbr.end(), sel.begin(), sel.end());
+        off[i+1] = (int) nbr.size();
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool FESlidingElasticInterface::ProfileChanged()
+{
+    // without a profile radius, the profile only contains the current contact pairs
+    if (m_prad <= 0) return true;
+    
+    int npass = (m_btwo_pass?2:1);
+    for (int np=0; np<npass; ++np)
+    {
+        FESlidingElasticSurface& ss = (np == 0? m_ss : m_ms);
+        const vector<int>& off = m_nbrOff[np];
+        const vector<int>& nbr = m_nbr[np];
+        if ((int) off.size() != ss.Elements() + 1) return true;
+        
+        // every contact pair must be in the neighborhood of its primary element
+        for (int j=0; j<ss.Elements(); ++j)
+        {
+            FESurfaceElement& se = ss.Element(j);
+            for (int k=0; k<se.GaussPoints(); ++k)
+            {
+                FESlidingElasticSurface::Data& data = static_cast<FESlidingElasticSurface::Data&>(*se.GetMaterialPoint(k));
+                if (data.m_pme == 0) continue;
+                if (!std::binary_search(nbr.begin() + off[j], nbr.begin() + off[j+1], data.m_pme->m_lid)) return true;
+            }
+        }
+    }
+    return false;
+}
+
 //-----------------------------------------------------------------------------
 void FESlidingElasticInterface::CalcAutoPenalty(FESlidingElasticSurface& s)
 {
@@ -468,10 +547,11 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
     double R = m_srad*mesh.GetBoundingBox().radius();
     
     // initialize projection data
-    FENormalProjection np(ms);
-    np.SetTolerance(m_stol);
-    np.SetSearchRadius(R);
-    np.Init();
+    FENormalProjection& np = ms.GetNormalProjection(m_stol, R);
+    
+    // the broad phase is only used when a distance was specified
+    bool bbroad = (m_bprad > 0.0);
+    if (bbroad) ms.UpdateBroadPhase();
     
     double psf = GetPenaltyScaleFactor();
     
@@ -563,8 +643,12 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
             // calculate the normal at this integration point
             vec3d nu = ss.SurfaceNormal(el, j);
             
+            // points that are far away from the secondary surface cannot be in contact
+            bool bnear = ((bbroad == false) || ms.BroadPhase(data, r, m_bprad));
+            
             // first see if the old intersected face is still good enough
-            FESurfaceElement* pme = data.m_pme;
+            // (a point only loses its face when the segments can be updated)
+            FESurfaceElement* pme = ((bnear || (bupseg == false)) ? data.m_pme : 0);
             double rs[2] = {0,0};
             if (pme)
             {
@@ -583,7 +667,7 @@ void FESlidingElasticInterface::ProjectSurface(FESlidingElasticSurface& ss, FESl
             }
             
             // find the intersection point with the secondary surface
-            if (pme == 0 && bupseg) pme = np.Project(r, nu, rs);
+            if (pme == 0 && bupseg && bnear) pme = np.Project(r, nu, rs);
             
             data.m_pme = pme;
             data.m_nu = nu;
@@ -923,11 +1007,6 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
 {
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    
     m_ss.m_Ft = vec3d(0,0,0);
     m_ms.m_Ft = vec3d(0,0,0);
     
@@ -940,9 +1019,17 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(sLM, mLM, LM, en, fe, detJ, w, Hm, N)
-        for (int i=0; i<ss.Elements(); ++i)
+        // (the element buffers are thread-private and the residual is assembled atomically)
+        int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+        for (int i=0; i<NE; ++i)
         {
+            vector<int> sLM, mLM, LM, en;
+            vector<double> fe;
+            double detJ[MN], w[MN], Hm[MN];
+            double N[MN*6];
+            vec3d Fs(0,0,0), Fm(0,0,0);
+            
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
             
@@ -1050,12 +1137,12 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
                         {
-                            ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                            Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
                         }
                         
                         for (int k = 0; k<nmeln; ++k)
                         {
-                            ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                            Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
                         }
                         
                         // assemble the global residual
@@ -1063,6 +1150,13 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
                     }
                 }
             }
+            
+            // add to the net contact forces
+#pragma omp critical
+            {
+                ss.m_Ft += Fs;
+                ms.m_Ft += Fm;
+            }
         }
     }
 }
@@ -1075,11 +1169,6 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     double psf = GetPenaltyScaleFactor();
     
     // do single- or two-pass
@@ -1091,9 +1180,16 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(detJ, w, Hm, N, sLM, mLM, LM, en, ke)
-        for (int i=0; i<ss.Elements(); ++i)
+        // (the element buffers are thread-private and the stiffness is assembled atomically)
+        int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+        for (int i=0; i<NE; ++i)
         {
+            double detJ[MN], w[MN], Hm[MN];
+            double N[MN*6];
+            vector<int> sLM, mLM, LM, en;
+            FEElementMatrix ke;
+            
             // get ths primary element
             FESurfaceElement& se = ss.Element(i);
             
@@ -131,6 +131,9 @@ public:
     //! build the matrix profile for use in the stiffness matrix
     void BuildMatrixProfile(FEGlobalMatrix& K) override;
 
+    //! see if the contact pairs are still covered by the matrix profile
+    bool ProfileChanged() override;
+
 public:
 	//! calculate contact forces
 	void LoadVector(FEGlobalVector& R, const FETimeInfo& tp) override;
@@ -152,6 +155,9 @@ protected:
     
     void CalcAutoPenalty(FESlidingElasticSurface& s);
 
+    //! find the secondary elements within the profile radius of each primary element
+    void BuildProfileNeighborhood(FESlidingElasticSurface& ss, FESlidingElasticSurface& ms, int np);
+
 public:
     FESlidingElasticSurface	m_ss;	//!< primary surface
 	FESlidingElasticSurface	m_ms;	//!< secondary surface
@@ -163,6 +169,8 @@ public:
     double			m_stol;			//!< search tolerance
     bool			m_bsymm;		//!< use symmetric stiffness components only
     double			m_srad;			//!< contact search radius
+    double			m_bprad;		//!< broad-phase search distance (0 = no broad phase)
+    double			m_prad;			//!< matrix profile radius (0 = profile only contains current contact pairs)
     int				m_naugmax;		//!< maximum nr of augmentations
     int				m_naugmin;		//!< minimum nr of augmentations
     int				m_nsegup;		//!< segment update parameter
@@ -183,5 +191,11 @@ public:
 	bool            m_bshellbs;     //!< flag for prescribing pressure on shell bottom for primary surface
 	bool            m_bshellbm;     //!< flag for prescribing pressure on shell bottom for secondary surface
 
+private:
+    // neighborhoods used for the matrix profile (one for each pass), stored
+    // as a list of secondary elements for each primary element.
+    vector<int>		m_nbrOff[2];	//!< offset of each primary element into m_nbr
+    vector<int>		m_nbr[2];		//!< secondary elements within the profile radius
+
     DECLARE_FECORE_CLASS();
 };
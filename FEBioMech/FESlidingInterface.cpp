@@ -79,6 +79,7 @@ BEGIN_FECORE_CLASS(FESlidingInterface, FEContactInterface)
 	ADD_PARAMETER(m_nsegup       , "seg_up"       );
 	ADD_PARAMETER(m_bself_contact, "self_contact" );
 	ADD_PARAMETER(m_sradius      , "search_radius");
+	ADD_PARAMETER(m_bprad        , "broad_phase_radius");
 	ADD_PARAMETER(m_bupdtpen     , "update_penalty");
 END_FECORE_CLASS();
 
@@ -146,7 +147,7 @@ void FESlidingInterface::BuildMatrixProfile(FEGlobalMatrix& K)
 
 				for (int k=0; k<n; ++k)
 				{
-					vector<int>& id = mesh.Node(en[k]).m_ID;
+					int* id = mesh.Node(en[k]).m_ID;
 					lm[6*(k+1)  ] = id[dof_X];
 					lm[6*(k+1)+1] = id[dof_Y];
 					lm[6*(k+1)+2] = id[dof_Z];
@@ -408,6 +409,7 @@ FESlidingInterface::FESlidingInterface(FEModel* pfem) : FEContactInterface(pfem)
 	m_btwo_pass = false; // don't use two-pass
 	m_bself_contact = false;	// no self-contact
 	m_sradius = 0;				// no search radius limitation
+	m_bprad = 0;				// no broad phase
 
 	// set the siblings
 	m_ms.SetSibling(&m_ss);
@@ -509,6 +511,11 @@ void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface&
 	cpp.HandleSpecialCases(true);
 	cpp.Init();
 
+	// the broad phase is only used when a distance was specified
+	// (and not for self-contact, since then all nodes are on the surface)
+	bool bbroad = ((m_bprad > 0) && (m_bself_contact == false));
+	if (bbroad) ms.UpdateBroadPhase();
+
 	// loop over all primary surface nodes
 	for (int i=0; i<ss.Nodes(); ++i)
 	{
@@ -521,8 +528,12 @@ void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface&
 		// get the global node number
 		int m = ss.NodeIndex(i);
 
+		// nodes that are far away from the secondary surface cannot be in contact
+		bool bnear = ((bbroad == false) || ms.BroadPhase(ss.m_data[i], x, m_bprad));
+
 		// get the previous secondary surface element (if any)
-		FESurfaceElement* pme = ss.m_data[i].m_pme;
+		// (a node only loses its element when the segments can be updated)
+		FESurfaceElement* pme = ((bnear || (bupseg == false)) ? ss.m_data[i].m_pme : 0);
 
 		// If the node is in contact, let's see if the node still is 
 		// on the same element
@@ -571,7 +582,7 @@ void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface&
 				}
 			}
 		}
-		else if (bupseg)
+		else if (bupseg && bnear)
 		{
 			// get the secondary surface element
 			// don't forget to initialize the search for the first node!
@@ -665,25 +676,7 @@ void FESlidingInterface::Update()
 
 void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	// element contact force vector
-	vector<double> fe;
-
-	// the lm array for this force vector
-	vector<int> lm;
-
-	// the en array
-	vector<int> en;
-
-	// the elements LM vectors
-	vector<int> sLM;
-	vector<int> mLM;
-
 	const int MN = FEElement::MAX_NODES;
-	vec3d r0[MN];
-	double w[MN];
-	double* Gr, *Gs;
-	double detJ[MN];
-	vec3d dxr, dxs;
 
 	// do two-pass
 	int npass = (m_btwo_pass?2:1);
@@ -695,9 +688,30 @@ void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface& ms = (np==0? m_ms : m_ss);
 
 		// loop over all primary surface facets
+		// (the element buffers are thread-private and the residual is assembled atomically)
 		int ne = ss.Elements();
+#pragma omp parallel for shared(ne) schedule(dynamic)
 		for (int j=0; j<ne; ++j)
 		{
+			// element contact force vector
+			vector<double> fe;
+
+			// the lm array for this force vector
+			vector<int> lm;
+
+			// the en array
+			vector<int> en;
+
+			// the elements LM vectors
+			vector<int> sLM;
+			vector<int> mLM;
+
+			vec3d r0[MN];
+			double w[MN];
+			double* Gr, *Gs;
+			double detJ[MN];
+			vec3d dxr, dxs;
+
 			// get the next element
 			FESurfaceElement& sel = ss.Element(j);
 			int nseln = sel.Nodes();
@@ -1009,20 +1023,7 @@ void FESlidingInterface::ContactNodalForce(int m, FESlidingSurface& ss, FESurfac
 
 void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	FEElementMatrix ke;
-
 	const int MAXMN = FEElement::MAX_NODES;
-	vector<int> lm(3*(MAXMN + 1));
-	vector<int> en(MAXMN+1);
-
-	double *Gr, *Gs, w[6];
-	vec3d r0[6];
-
-	double detJ[6];
-	vec3d dxr, dxs;
-
-	vector<int> sLM;
-	vector<int> mLM;
 
 	// do two-pass
 	int npass = (m_btwo_pass?2:1);
@@ -1034,9 +1035,24 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 		FESlidingSurface& ms = (np==0?m_ms:m_ss);	
 
 		// loop over all primary surface elements
+		// (the element buffers are thread-private and the stiffness is assembled atomically)
 		int ne = ss.Elements();
+#pragma omp parallel for shared(ne) schedule(dynamic)
 		for (int j=0; j<ne; ++j)
 		{
+			FEElementMatrix ke;
+			vector<int> lm(3*(MAXMN + 1));
+			vector<int> en(MAXMN+1);
+
+			double *Gr, *Gs, w[6];
+			vec3d r0[6];
+
+			double detJ[6];
+			vec3d dxr, dxs;
+
+			vector<int> sLM;
+			vector<int> mLM;
+
 			// unpack the next element
 			FESurfaceElement& se = ss.Element(j);
 			int nseln = se.Nodes();
@@ -160,6 +160,7 @@ public:
 
 	bool			m_bself_contact;	//!< self-contact flag
 	double			m_sradius;			//!< search radius for self contact
+	double			m_bprad;			//!< broad-phase search distance (0 = no broad phase)
 
 	int				m_naugmax;	//!< maximum nr of augmentations
 	int				m_naugmin;	//!< minimum nr of augmentations
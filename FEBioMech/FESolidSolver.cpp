@@ -622,7 +622,11 @@ void FESolidSolver::ContactStiffness(FELinearSystem& LS)
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-		if (pci->IsActive()) pci->StiffnessMatrix(LS, tp);
+		if (pci->IsActive())
+		{
+			TimerTracker t(&pci->StiffnessTimer());
+			pci->StiffnessMatrix(LS, tp);
+		}
 	}
 }
 
@@ -635,7 +639,11 @@ void FESolidSolver::ContactForces(FEGlobalVector& R)
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
 	{
 		FEContactInterface* pci = dynamic_cast<FEContactInterface*>(fem.SurfacePairConstraint(i));
-		if (pci->IsActive()) pci->LoadVector(R, tp);
+		if (pci->IsActive())
+		{
+			TimerTracker t(&pci->LoadVectorTimer());
+			pci->LoadVector(R, tp);
+		}
 	}
 }
 
@@ -70,7 +70,7 @@ bool FESymmetryPlane::Init()
     // for a symmetry plane the constraint on (ux, uy, uz) is
     // nx*ux + ny*uy + nz*uz = 0
     for (int i=0; i<N; ++i) {
-        FENode node = m_surf.Node(i);
+        FENode& node = m_surf.Node(i);
         if (node.HasFlags(FENode::EXCLUDE) == false) {
             FEAugLagLinearConstraint* pLC = new FEAugLagLinearConstraint;
             for (int j=0; j<3; ++j) {
@@ -101,7 +101,7 @@ bool FESymmetryPlane::Init()
     
     // for nodes that belong to shells, also constraint the shell bottom face displacements
     for (int i=0; i<N; ++i) {
-        FENode node = m_surf.Node(i);
+        FENode& node = m_surf.Node(i);
         if ((node.HasFlags(FENode::EXCLUDE) == false) && (node.HasFlags(FENode::SHELL))) {
             FEAugLagLinearConstraint* pLC = new FEAugLagLinearConstraint;
             for (int j=0; j<3; ++j) {
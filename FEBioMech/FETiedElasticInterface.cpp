@@ -265,7 +265,7 @@ void FETiedElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nseln; ++l)
                     {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
+                        int* id = mesh.Node(sn[l]).m_ID;
                         lm[ndpn*l  ] = id[dof_X];
                         lm[ndpn*l+1] = id[dof_Y];
                         lm[ndpn*l+2] = id[dof_Z];
@@ -276,7 +276,7 @@ void FETiedElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nmeln; ++l)
                     {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
+                        int* id = mesh.Node(mn[l]).m_ID;
                         lm[ndpn*(l+nseln)  ] = id[dof_X];
                         lm[ndpn*(l+nseln)+1] = id[dof_Y];
                         lm[ndpn*(l+nseln)+2] = id[dof_Z];
@@ -348,10 +348,7 @@ void FETiedElasticInterface::InitialProjection(FETiedElasticSurface& ss, FETiedE
     double rs[2];
     
     // initialize projection data
-    FENormalProjection np(ms);
-    np.SetTolerance(m_stol);
-    np.SetSearchRadius(m_srad);
-    np.Init();
+    FENormalProjection& np = ms.GetNormalProjection(m_stol, m_srad);
     
     // loop over all integration points
     int n = 0;
@@ -41,6 +41,8 @@ SOFTWARE.*/
 // Material parameters for the FEUncoupledReactiveViscoelastic material
 BEGIN_FECORE_CLASS(FEUncoupledReactiveViscoelasticMaterial, FEUncoupledMaterial)
 	ADD_PARAMETER(m_wmin , FE_RANGE_CLOSED(0.0, 1.0), "wmin"    );
+	ADD_PARAMETER(m_mtol , FE_RANGE_GREATER_OR_EQUAL(0.0), "merge_tol");
+	ADD_PARAMETER(m_nmax , FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
 	ADD_PARAMETER(m_btype, FE_RANGE_CLOSED(1, 2), "kinetics");
 	ADD_PARAMETER(m_ttype, FE_RANGE_CLOSED(0, 2), "trigger" );
 
@@ -56,6 +58,8 @@ END_FECORE_CLASS();
 FEUncoupledReactiveViscoelasticMaterial::FEUncoupledReactiveViscoelasticMaterial(FEModel* pfem) : FEUncoupledMaterial(pfem)
 {
     m_wmin = 0;
+    m_mtol = 0;
+    m_nmax = 0;
     m_btype = 0;
     m_ttype = 0;
 
@@ -389,34 +393,11 @@ double FEUncoupledReactiveViscoelasticMaterial::DevStrainEnergyDensity(FEMateria
 }
 
 //-----------------------------------------------------------------------------
-//! Cull generations that have relaxed below a threshold
+//! Cull generations that have relaxed below a threshold and compact the remaining ones
 void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& mp)
 {
-    // get the elastic part
-    FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
-    
     // get the reactive viscoelastic point data
     FEReactiveVEMaterialPoint& pt = *mp.ExtractData<FEReactiveVEMaterialPoint>();
-    
-    mat3ds D = ep.RateOfDeformation();
-    
-    if (pt.m_Fi.empty()) return;
-    
-    // culling termination flag
-    bool done = false;
-    
-    // always check oldest generation
-    while (!done) {
-        double w = BreakingBondMassFraction(mp, 0, D);
-        if ((w > m_wmin) || (pt.m_Fi.size() == 1))
-            done = true;
-        else {
-            pt.m_Fi.pop_front();
-            pt.m_Ji.pop_front();
-            pt.m_v.pop_front();
-            pt.m_w.pop_front();
-        }
-    }
-    
-    return;
+
+    pt.CompactGenerations();
 }
@@ -154,7 +154,7 @@ void FEBiphasicShellDomain::UnpackLM(FEElement& el, vector<int>& lm)
     {
         int n = el.m_node[i];
         FENode& node = m_pMesh->Node(n);
-        vector<int>& id = node.m_ID;
+        int* id = node.m_ID;
         
         // first the displacement dofs
         lm[8*i  ] = id[m_dofU[0]];
@@ -558,7 +558,7 @@ void FESlidingInterface2::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						int* id = mesh.Node(sn[l]).m_ID;
 						lm[7*l  ] = id[dof_X];
 						lm[7*l+1] = id[dof_Y];
 						lm[7*l+2] = id[dof_Z];
@@ -570,7 +570,7 @@ void FESlidingInterface2::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						int* id = mesh.Node(mn[l]).m_ID;
 						lm[7*(l+nseln)  ] = id[dof_X];
 						lm[7*(l+nseln)+1] = id[dof_Y];
 						lm[7*(l+nseln)+2] = id[dof_Z];
@@ -725,10 +725,7 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 
     double psf = GetPenaltyScaleFactor();
     
-	FENormalProjection np(ms);
-	np.SetTolerance(m_stol);
-	np.SetSearchRadius(R);
-	np.Init();
+	FENormalProjection& np = ms.GetNormalProjection(m_stol, R);
 
 	// if we need to project the nodes onto the secondary surface,
 	// let's do this first
@@ -979,10 +976,7 @@ void FESlidingInterface2::Update()
 		// the secondary surface is trickier since we need
 		// to look at the primary surface's projection
 		if (ms.m_bporo && ((npass == 1) || m_bdupr)) {
-			FENormalProjection np(ss);
-			np.SetTolerance(m_stol);
-			np.SetSearchRadius(R);
-			np.Init();
+			FENormalProjection& np = ss.GetNormalProjection(m_stol, R);
 
 			for (int n=0; n<ms.Nodes(); ++n)
 			{
@@ -1029,12 +1023,7 @@ void FESlidingInterface2::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	int i, j, k;
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[4*MN*2]; // TODO: is the size correct?
 
 	FEModel& fem = *GetFEModel();
 
@@ -1056,8 +1045,18 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (the element buffers are thread-private and the residual is assembled atomically)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
+			int j, k;
+			vector<int> sLM, mLM, LM, en;
+			vector<double> fe;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double N[4*MN*2]; // TODO: is the size correct?
+			vec3d Fs(0,0,0), Fm(0,0,0);
+
 			// get the surface element
 			FESurfaceElement& se = ss.Element(i);
 
@@ -1177,12 +1176,12 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 					for (k=0; k<nseln; ++k)
 					{
-						ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+						Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
 					}
 
 					for (k = 0; k<nmeln; ++k)
 					{
-						ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+						Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
 					}
 
 					// assemble the global residual
@@ -1217,6 +1216,13 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					}
 				}
 			}
+
+			// add to the net contact forces
+#pragma omp critical
+			{
+				ss.m_Ft += Fs;
+				ms.m_Ft += Fm;
+			}
 		}
 	}
 }
@@ -1224,12 +1230,7 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN], pt[MN], dpr[MN], dps[MN];
-	double N[4*MN*2];
-	FEElementMatrix ke;
 
 	FEModel& fem = *GetFEModel();
 
@@ -1263,8 +1264,17 @@ void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (the element buffers are thread-private and the stiffness is assembled atomically)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
+			int j, k, l;
+			vector<int> sLM, mLM, LM, en;
+			double detJ[MN], w[MN], *Hs, Hm[MN], pt[MN], dpr[MN], dps[MN];
+			double N[4*MN*2];
+			FEElementMatrix ke;
+
 			// get the next element
 			FESurfaceElement& se = ss.Element(i);
 
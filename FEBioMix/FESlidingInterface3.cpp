@@ -135,7 +135,7 @@ void FESlidingSurface3::UnpackLM(FEElement& el, vector<int>& lm)
 		int n = el.m_node[i];
 
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		int* id = node.m_ID;
 
 		// first the displacement dofs
 		lm[3*i  ] = id[m_dofX];
@@ -533,7 +533,7 @@ void FESlidingInterface3::BuildMatrixProfile(FEGlobalMatrix& K)
 									
 					for (l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						int* id = mesh.Node(sn[l]).m_ID;
 						lm[8*l  ] = id[dof_X];
 						lm[8*l+1] = id[dof_Y];
 						lm[8*l+2] = id[dof_Z];
@@ -546,7 +546,7 @@ void FESlidingInterface3::BuildMatrixProfile(FEGlobalMatrix& K)
 									
 					for (l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						int* id = mesh.Node(mn[l]).m_ID;
 						lm[8*(l+nseln)  ] = id[dof_X];
 						lm[8*(l+nseln)+1] = id[dof_Y];
 						lm[8*(l+nseln)+2] = id[dof_Z];
@@ -795,23 +795,13 @@ double FESlidingInterface3::AutoConcentrationPenalty(FESurfaceElement& el, FESli
 void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface3& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-	
-	double ps[FEElement::MAX_NODES], p1;
-	double cs[FEElement::MAX_NODES], c1;
 	
 	double R = m_srad*mesh.GetBoundingBox().radius();
 	
     double psf = GetPenaltyScaleFactor();
     
 	// initialize projection data
-	FENormalProjection np(ms);
-	np.SetTolerance(m_stol);
-	np.SetSearchRadius(m_srad);
-	np.Init();
+	FENormalProjection& np = ms.GetNormalProjection(m_stol, m_srad);
 
     // if we need to project the nodes onto the secondary surface,
     // let's do this first
@@ -866,9 +856,19 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
     }
     
 	// loop over all integration points
-//    #pragma omp parallel for shared(R, bupseg)
-	for (int i=0; i<ss.Elements(); ++i)
+	// (each element only updates its own integration point data)
+	int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+	for (int i=0; i<NE; ++i)
 	{
+		FESurfaceElement* pme;
+		vec3d r, nu;
+		double rs[2] = {0,0};
+		double Ln;
+		
+		double ps[FEElement::MAX_NODES], p1;
+		double cs[FEElement::MAX_NODES], c1;
+		
 		FESurfaceElement& el = ss.Element(i);
 
 		bool sporo = ss.m_poro[i];
@@ -1095,10 +1095,7 @@ void FESlidingInterface3::Update()
 		// to look at the primary's surface projection
 		if (ms.m_bporo) {
             // initialize projection data
-            FENormalProjection np(ss);
-            np.SetTolerance(m_stol);
-            np.SetSearchRadius(m_srad);
-            np.Init();
+            FENormalProjection& np = ss.GetNormalProjection(m_stol, m_srad);
             
 			for (int n = 0; n<ms.Nodes(); ++n)
 			{
@@ -1151,11 +1148,7 @@ void FESlidingInterface3::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[10*MN];
 
 	FEModel& fem = *GetFEModel();
 
@@ -1175,8 +1168,17 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
-		for (int i = 0; i<ss.Elements(); ++i)
+		// (the element buffers are thread-private and the residual is assembled atomically)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int i = 0; i<NE; ++i)
 		{
+			vector<int> sLM, mLM, LM, en;
+			vector<double> fe;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double N[10*MN];
+			vec3d Fs(0,0,0), Fm(0,0,0);
+
 			// get the surface element
 			FESurfaceElement& se = ss.Element(i);
 
@@ -1298,12 +1300,12 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					
                     for (int k=0; k<nseln; ++k)
                     {
-                        ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                        Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
                     }
                     
                     for (int k = 0; k<nmeln; ++k)
                     {
-                        ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                        Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
                     }
                     
 					// assemble the global residual
@@ -1367,6 +1369,13 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					}
 				}
 			}
+
+			// add to the net contact forces
+#pragma omp critical
+			{
+				ss.m_Ft += Fs;
+				ms.m_Ft += Fm;
+			}
 		}
 	}
 }
@@ -1374,14 +1383,7 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double pt[MN], dpr[MN], dps[MN];
-	double ct[MN], dcr[MN], dcs[MN];
-	double N[10*MN];
-	FEElementMatrix ke;
 
 	FEModel& fem = *GetFEModel();
 
@@ -1415,8 +1417,19 @@ void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (the element buffers are thread-private and the stiffness is assembled atomically)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
+			int j, k, l;
+			vector<int> sLM, mLM, LM, en;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double pt[MN], dpr[MN], dps[MN];
+			double ct[MN], dcr[MN], dcs[MN];
+			double N[10*MN];
+			FEElementMatrix ke;
+
 			// get the next element
 			FESurfaceElement& se = ss.Element(i);
 
@@ -1980,7 +1993,10 @@ void FESlidingInterface3::UpdateContactPressures()
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all elements of the primary surface
-		for (int n=0; n<ss.Elements(); ++n)
+		// (only the primary integration points are updated in each pass)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int n=0; n<NE; ++n)
 		{
 			FESurfaceElement& el = ss.Element(n);
 			int nint = el.GaussPoints();
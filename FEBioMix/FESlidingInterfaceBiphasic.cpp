@@ -595,7 +595,7 @@ void FESlidingInterfaceBiphasic::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nseln; ++l)
                     {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
+                        int* id = mesh.Node(sn[l]).m_ID;
                         lm[7*l  ] = id[dof_X];
                         lm[7*l+1] = id[dof_Y];
                         lm[7*l+2] = id[dof_Z];
@@ -607,7 +607,7 @@ void FESlidingInterfaceBiphasic::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nmeln; ++l)
                     {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
+                        int* id = mesh.Node(mn[l]).m_ID;
                         lm[7*(l+nseln)  ] = id[dof_X];
                         lm[7*(l+nseln)+1] = id[dof_Y];
                         lm[7*(l+nseln)+2] = id[dof_Z];
@@ -755,10 +755,7 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
     double R = m_srad*mesh.GetBoundingBox().radius();
     
     // initialize projection data
-    FENormalProjection np(ms);
-    np.SetTolerance(m_stol);
-    np.SetSearchRadius(R);
-    np.Init();
+    FENormalProjection& np = ms.GetNormalProjection(m_stol, R);
     
     // if we need to project the nodes onto the secondary surface,
     // let's do this first
@@ -813,7 +810,7 @@ void FESlidingInterfaceBiphasic::ProjectSurface(FESlidingSurfaceBiphasic& ss, FE
     }
     
     // loop over all integration points
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
     for (int i=0; i<ss.Elements(); ++i)
     {
         FESurfaceElement& el = ss.Element(i);
@@ -1030,10 +1027,7 @@ void FESlidingInterfaceBiphasic::Update()
         // the secondary surface is trickier since we need
         // to look at the primary surface's projection
         if (ms.m_bporo) {
-            FENormalProjection np(ss);
-            np.SetTolerance(m_stol);
-            np.SetSearchRadius(R);
-            np.Init();
+            FENormalProjection& np = ss.GetNormalProjection(m_stol, R);
             
             for (int n=0; n<ms.Nodes(); ++n)
             {
@@ -1385,11 +1379,6 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
 {
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[4*MN*2];
-    
     m_ss.m_Ft = vec3d(0,0,0);
     m_ms.m_Ft = vec3d(0,0,0);
     
@@ -1407,8 +1396,17 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingSurfaceBiphasic& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary surface elements
-        for (int i=0; i<ss.Elements(); ++i)
+        // (the element buffers are thread-private and the residual is assembled atomically)
+        int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+        for (int i=0; i<NE; ++i)
         {
+            vector<int> sLM, mLM, LM, en;
+            vector<double> fe;
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            double N[4*MN*2];
+            vec3d Fs(0,0,0), Fm(0,0,0);
+            
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
             
@@ -1519,10 +1517,10 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
                         
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                            Fs += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
                         
                         for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                            Fm += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
                         
                         // assemble the global residual
                         R.Assemble(en, LM, fe);
@@ -1557,6 +1555,13 @@ void FESlidingInterfaceBiphasic::LoadVector(FEGlobalVector& R, const FETimeInfo&
                     }
                 }
             }
+
+            // add to the net contact forces
+#pragma omp critical
+            {
+                ss.m_Ft += Fs;
+                ms.m_Ft += Fm;
+            }
         }
     }
 }
@@ -1569,11 +1574,6 @@ void FESlidingInterfaceBiphasic::StiffnessMatrix(FELinearSystem& LS, const FETim
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[4*MN*2];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     FEModel& fem = *GetFEModel();
     
     double psf = GetPenaltyScaleFactor();
@@ -1589,8 +1589,16 @@ void FESlidingInterfaceBiphasic::StiffnessMatrix(FELinearSystem& LS, const FETim
         FEMesh& mesh = *ms.GetMesh();
         
         // loop over all primary elements
-        for (int i=0; i<ss.Elements(); ++i)
+        // (the element buffers are thread-private and the stiffness is assembled atomically)
+        int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+        for (int i=0; i<NE; ++i)
         {
+            double detJ[MN], w[MN], *Hs, Hm[MN];
+            double N[4*MN*2];
+            vector<int> sLM, mLM, LM, en;
+            FEElementMatrix ke;
+            
             // get the primary element
             FESurfaceElement& se = ss.Element(i);
             
@@ -2221,7 +2229,10 @@ void FESlidingInterfaceBiphasic::UpdateContactPressures()
         FESlidingSurfaceBiphasic& ms = (np == 0? m_ms : m_ss);
         
         // loop over all elements of the primary surface
-        for (int n=0; n<ss.Elements(); ++n)
+        // (only the primary integration points are updated in each pass)
+        int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+        for (int n=0; n<NE; ++n)
         {
             FESurfaceElement& el = ss.Element(n);
             int nint = el.GaussPoints();
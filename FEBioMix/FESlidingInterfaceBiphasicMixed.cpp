@@ -531,7 +531,7 @@ void FESlidingSurfaceBiphasicMixed::UnpackLM(FEElement& el, vector<int>& lm)
 		int n = el.m_node[i];
 
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		int* id = node.m_ID;
 
 		// first the displacement dofs
 		lm[3 * i    ] = id[m_dofX];
@@ -642,7 +642,7 @@ void FESlidingInterfaceBiphasicMixed::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nseln; ++l)
                     {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
+                        int* id = mesh.Node(sn[l]).m_ID;
                         lm[7*l  ] = id[dof_X];
                         lm[7*l+1] = id[dof_Y];
                         lm[7*l+2] = id[dof_Z];
@@ -654,7 +654,7 @@ void FESlidingInterfaceBiphasicMixed::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nmeln; ++l)
                     {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
+                        int* id = mesh.Node(mn[l]).m_ID;
                         lm[7*(l+nseln)  ] = id[dof_X];
                         lm[7*(l+nseln)+1] = id[dof_Y];
                         lm[7*(l+nseln)+2] = id[dof_Z];
@@ -806,10 +806,7 @@ void FESlidingInterfaceBiphasicMixed::ProjectSurface(FESlidingSurfaceBiphasicMix
     double R = m_srad*mesh.GetBoundingBox().radius();
     
     // initialize projection data
-    FENormalProjection np(ms);
-    np.SetTolerance(m_stol);
-    np.SetSearchRadius(R);
-    np.Init();
+    FENormalProjection& np = ms.GetNormalProjection(m_stol, R);
     
     // if we need to project the nodes onto the secondary surface,
     // let's do this first
@@ -864,7 +861,7 @@ void FESlidingInterfaceBiphasicMixed::ProjectSurface(FESlidingSurfaceBiphasicMix
     }
     
     // loop over all integration points
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
     for (int i=0; i<ss.Elements(); ++i)
     {
         FESurfaceElement& el = ss.Element(i);
@@ -1086,10 +1083,7 @@ void FESlidingInterfaceBiphasicMixed::Update()
         // the secondary surface is trickier since we need
         // to look at the primary surface's projection
         if (ms.m_bporo) {
-            FENormalProjection np(ss);
-            np.SetTolerance(m_stol);
-            np.SetSearchRadius(R);
-            np.Init();
+            FENormalProjection& np = ss.GetNormalProjection(m_stol, R);
             
             for (int n=0; n<ms.Nodes(); ++n)
             {
@@ -1471,17 +1465,21 @@ void FESlidingInterfaceBiphasicMixed::LoadVector(FESlidingSurfaceBiphasicMixed&
 
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], *Hs, Hm[MN], Hmp[MN];
-    double N[4*MN*2];
-    
     // need to multiply biphasic force entries by the timestep
     double dt = tp.timeIncrement;
     
     // loop over all primary surface elements
-    for (int i=0; i<ss.Elements(); ++i)
+    // (the element buffers are thread-private and the residual is assembled atomically)
+    int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+    for (int i=0; i<NE; ++i)
     {
+        vector<int> sLM, mLM, LM, en;
+        vector<double> fe;
+        double detJ[MN], w[MN], *Hs, Hm[MN], Hmp[MN];
+        double N[4*MN*2];
+        vec3d Fs(0,0,0), Fm(0,0,0);
+        
         // get the surface element
         FESurfaceElement& se = ss.Element(i);
             
@@ -1594,10 +1592,10 @@ void FESlidingInterfaceBiphasicMixed::LoadVector(FESlidingSurfaceBiphasicMixed&
                         
                     // calculate contact forces
                     for (int k=0; k<nseln; ++k)
-                        ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                        Fs += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
                         
                     for (int k = 0; k<nmeln; ++k)
-                        ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                        Fm += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
                         
                     // assemble the global residual
                     R.Assemble(en, LM, fe);
@@ -1643,6 +1641,13 @@ void FESlidingInterfaceBiphasicMixed::LoadVector(FESlidingSurfaceBiphasicMixed&
                 }
             }
         }
+
+        // add to the net contact forces
+#pragma omp critical
+        {
+            ss.m_Ft += Fs;
+            ms.m_Ft += Fm;
+        }
     }
 }
 
@@ -1675,11 +1680,6 @@ void FESlidingInterfaceBiphasicMixed::StiffnessMatrix(FESlidingSurfaceBiphasicMi
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], *Hs, Hm[MN], Hmp[MN];
-    double N[4*MN*2], H[4*MN*2];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     FEModel& fem = *GetFEModel();
     
     double psf = GetPenaltyScaleFactor();
@@ -1687,8 +1687,16 @@ void FESlidingInterfaceBiphasicMixed::StiffnessMatrix(FESlidingSurfaceBiphasicMi
     FEMesh& mesh = *ms.GetMesh();
         
     // loop over all primary surface elements
-    for (int i=0; i<ss.Elements(); ++i)
+    // (the element buffers are thread-private and the stiffness is assembled atomically)
+    int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+    for (int i=0; i<NE; ++i)
     {
+        double detJ[MN], w[MN], *Hs, Hm[MN], Hmp[MN];
+        double N[4*MN*2], H[4*MN*2];
+        vector<int> sLM, mLM, LM, en;
+        FEElementMatrix ke;
+        
         // get the next element
         FESurfaceElement& se = ss.Element(i);
             
@@ -2342,7 +2350,10 @@ void FESlidingInterfaceBiphasicMixed::UpdateContactPressures()
 		FESlidingSurfaceBiphasicMixed& ms = (np == 0? m_ms : m_ss);
         
         // loop over all elements of the primary surface
-        for (int n=0; n<ss.Elements(); ++n)
+        // (only the primary integration points are updated in each pass)
+        int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+        for (int n=0; n<NE; ++n)
         {
             FESurfaceElement& el = ss.Element(n);
             int nint = el.GaussPoints();
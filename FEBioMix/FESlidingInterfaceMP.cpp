@@ -133,7 +133,7 @@ void FESlidingSurfaceMP::UnpackLM(FEElement& el, vector<int>& lm)
 		int n = el.m_node[i];
 
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		int* id = node.m_ID;
 
 		// first the displacement dofs
 		lm[3*i  ] = id[m_dofX];
@@ -609,7 +609,7 @@ void FESlidingInterfaceMP::BuildMatrixProfile(FEGlobalMatrix& K)
                     
 					for (l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						int* id = mesh.Node(sn[l]).m_ID;
 						lm[ndpn*l  ] = id[dof_X];
 						lm[ndpn*l+1] = id[dof_Y];
 						lm[ndpn*l+2] = id[dof_Z];
@@ -624,7 +624,7 @@ void FESlidingInterfaceMP::BuildMatrixProfile(FEGlobalMatrix& K)
                     
 					for (l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						int* id = mesh.Node(mn[l]).m_ID;
 						lm[ndpn*(l+nseln)  ] = id[dof_X];
 						lm[ndpn*(l+nseln)+1] = id[dof_Y];
 						lm[ndpn*(l+nseln)+2] = id[dof_Z];
@@ -921,26 +921,16 @@ double FESlidingInterfaceMP::AutoConcentrationPenalty(FESurfaceElement& el,
 void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfaceMP& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
 	
 	const int MN = FEElement::MAX_NODES;
 	int nsol = (int)m_sid.size();
-	double ps[MN], p1;
-	vector< vector<double> > cs(nsol, vector<double>(MN));
-	vector<double> c1(nsol);
 	
 	double R = m_srad*mesh.GetBoundingBox().radius();
 
     double psf = GetPenaltyScaleFactor();
     
 	// initialize projection data
-	FENormalProjection np(ms);
-	np.SetTolerance(m_stol);
-	np.SetSearchRadius(m_srad);
-	np.Init();
+	FENormalProjection& np = ms.GetNormalProjection(m_stol, m_srad);
 	
     // if we need to project the nodes onto the secondary surface,
     // let's do this first
@@ -995,9 +985,20 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
     }
     
 	// loop over all integration points
-//    #pragma omp parallel for shared(R, bupseg)
-	for (int i=0; i<ss.Elements(); ++i)
+	// (each element only updates its own integration point data)
+	int NE = ss.Elements();
+#pragma omp parallel for shared(NE, nsol) schedule(dynamic)
+	for (int i=0; i<NE; ++i)
 	{
+		FESurfaceElement* pme;
+		vec3d r, nu;
+		double rs[2] = {0,0};
+		double Ln;
+		
+		double ps[MN], p1;
+		vector< vector<double> > cs(nsol, vector<double>(MN));
+		vector<double> c1(nsol);
+		
 		FESurfaceElement& el = ss.Element(i);
 		
 		bool sporo = ss.m_bporo;
@@ -1199,10 +1200,7 @@ void FESlidingInterfaceMP::Update()
 		FESlidingSurfaceMP& ms = (np == 0? m_ms : m_ss);
 		
 		// initialize projection data
-		FENormalProjection project(ss);
-		project.SetTolerance(m_stol);
-		project.SetSearchRadius(m_srad);
-		project.Init();
+		FENormalProjection& project = ss.GetNormalProjection(m_stol, m_srad);
 
         // loop over all the nodes of the primary surface
         for (int n=0; n<ss.Nodes(); ++n) {
@@ -1277,14 +1275,8 @@ void FESlidingInterfaceMP::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[MN*10];
 	int nsol = (int)m_sid.size();
-    double tn[MN], wn[MN];
-    vector< vector<double> > jn(nsol,vector<double>(MN));
 	
 	FEModel& fem = *GetFEModel();
 	
@@ -1305,8 +1297,19 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		vector<int>& sl = (np == 0? m_ssl : m_msl);
 		
 		// loop over all primary surface elements
-		for (int i=0; i<ss.Elements(); ++i)
+		// (the element buffers are thread-private and the residual is assembled atomically)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
+			vector<int> sLM, mLM, LM, en;
+			vector<double> fe;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			double N[MN*10];
+			double tn[MN], wn[MN];
+			vector< vector<double> > jn(nsol,vector<double>(MN));
+			vec3d Fs(0,0,0), Fm(0,0,0);
+
 			// get the surface element
 			FESurfaceElement& se = ss.Element(i);
 			
@@ -1431,12 +1434,12 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					
                     for (int k=0; k<nseln; ++k)
                     {
-                        ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                        Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
                     }
                     
                     for (int k = 0; k<nmeln; ++k)
                     {
-                        ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                        Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
                     }
                     
 					// assemble the global residual
@@ -1494,6 +1497,13 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					}
 				}
 			}
+
+			// add to the net contact forces
+#pragma omp critical
+			{
+				ss.m_Ft += Fs;
+				ms.m_Ft += Fm;
+			}
 		}
 	}
 }
@@ -1501,16 +1511,8 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	FEElementMatrix ke;
 	int nsol = (int)m_sid.size();
-    double tn[MN], wn[MN];
-    vector< vector<double> > jn(nsol,vector<double>(MN));
-    vec3d pv[MN];
-    vector< vector<vec3d> > qv(nsol,vector<vec3d>(MN));
 	
 	FEModel& fem = *GetFEModel();
  	
@@ -1545,8 +1547,20 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		vector<int>& sl = (np == 0? m_ssl : m_msl);
 		
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		// (the element buffers are thread-private and the stiffness is assembled atomically)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
+			int j, k, l;
+			vector<int> sLM, mLM, LM, en;
+			double detJ[MN], w[MN], *Hs, Hm[MN];
+			FEElementMatrix ke;
+			double tn[MN], wn[MN];
+			vector< vector<double> > jn(nsol,vector<double>(MN));
+			vec3d pv[MN];
+			vector< vector<vec3d> > qv(nsol,vector<vec3d>(MN));
+
 			// get the next element
 			FESurfaceElement& se = ss.Element(i);
 			
@@ -1936,7 +1950,7 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::UpdateContactPressures()
 {
-	int np, n, i, j;
+	int np;
 	const int MN = FEElement::MAX_NODES;
 	int npass = (m_btwo_pass?2:1);
 	for (np=0; np<npass; ++np)
@@ -1945,8 +1959,13 @@ void FESlidingInterfaceMP::UpdateContactPressures()
 		FESlidingSurfaceMP& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all elements of the primary surface
-		for (n=0; n<ss.Elements(); ++n)
+		// (only the primary integration points are updated in each pass)
+		int NE = ss.Elements();
+#pragma omp parallel for shared(NE) schedule(dynamic)
+		for (int n=0; n<NE; ++n)
 		{
+			int i, j;
+
 			FESurfaceElement& el = ss.Element(n);
 			int nint = el.GaussPoints();
 			
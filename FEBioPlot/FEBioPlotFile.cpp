@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioPlotFile.h"
+#include "PltReader.h"
 #include "FECore/FECoreKernel.h"
 #include "FECore/FEDataExport.h"
 #include "FECore/FEModel.h"
@@ -42,6 +43,7 @@ FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM()
 	m_nfmt = 0;
 	m_arraySize = 0;
 	m_szname[0] = 0;
+	m_tol = 0.0;
 }
 
 FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM(const FEBioPlotFile::DICTIONARY_ITEM& item)
@@ -51,6 +53,7 @@ FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM(const FEBioPlotFile::DICTIONARY_
 	m_nfmt = item.m_nfmt;
 	m_arraySize = item.m_arraySize;
 	m_arrayNames = item.m_arrayNames;
+	m_tol = item.m_tol;
 	m_szname[0] = 0;
 	if (item.m_szname[0]) strcpy(m_szname, item.m_szname);
 }
@@ -586,6 +589,8 @@ void FEBioPlotFile::PlotObject::AddData(const char* szname, Var_Type type, FEPlo
 FEBioPlotFile::FEBioPlotFile(FEModel& fem) : m_fem(fem)
 {
 	m_ncompress = 0;
+	m_bindex = false;
+	m_nindex0 = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -634,9 +639,38 @@ bool FEBioPlotFile::AddVariable(const char* sz)
 }
 
 //-----------------------------------------------------------------------------
-bool FEBioPlotFile::AddVariable(const char* sz, vector<int>& item, const char* szdom)
+// The optional tolerance quantizes the variable's values to multiples of tol. This 
+// doesn't change the format of the plot file, but it makes the data compress much better.
+bool FEBioPlotFile::AddVariable(const char* sz, vector<int>& item, const char* szdom, double tol)
 { 
-	return m_dic.AddVariable(&m_fem, sz, item, szdom); 
+	size_t nn = m_dic.m_Node.size();
+	size_t ne = m_dic.m_Elem.size();
+	size_t nf = m_dic.m_Face.size();
+	if (m_dic.AddVariable(&m_fem, sz, item, szdom) == false) return false;
+
+	// assign the tolerance to the variable that was just added
+	if (tol > 0.0)
+	{
+		if      (m_dic.m_Node.size() > nn) m_dic.m_Node.back().m_tol = tol;
+		else if (m_dic.m_Elem.size() > ne) m_dic.m_Elem.back().m_tol = tol;
+		else if (m_dic.m_Face.size() > nf) m_dic.m_Face.back().m_tol = tol;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// This is used to restore the tolerances when a plot file is appended, since the
+// tolerances are not stored in the plot file.
+void FEBioPlotFile::SetTolerance(const char* sz, double tol)
+{
+	list<DICTIONARY_ITEM>* lists[] = { &m_dic.m_Node, &m_dic.m_Elem, &m_dic.m_Face };
+	for (list<DICTIONARY_ITEM>* pl : lists)
+	{
+		for (DICTIONARY_ITEM& it : *pl)
+		{
+			if (strcmp(it.m_szname, sz) == 0) it.m_tol = tol;
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -691,6 +725,18 @@ void FEBioPlotFile::SetCompression(int n)
 	m_ncompress = n;
 }
 
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::SetAsync(int n)
+{
+	m_ar.SetAsync(n);
+}
+
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::SetIndexing(bool b)
+{
+	m_bindex = b;
+}
+
 //-----------------------------------------------------------------------------
 bool FEBioPlotFile::IsValid() const
 {
@@ -700,9 +746,69 @@ bool FEBioPlotFile::IsValid() const
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::Close()
 {
+	if (m_bindex && m_ar.IsValid()) WriteIndex();
 	m_ar.Close();
 }
 
+//-----------------------------------------------------------------------------
+// The index stores the file position of each state and the position of each 
+// variable inside the (uncompressed) state, so that readers can go straight to
+// the data they need. The file position of the index is the last item in the 
+// file, so readers can find the index from the end of the file.
+void FEBioPlotFile::WriteIndex()
+{
+	// wait for the writer, so that we know where all the states went
+	m_ar.SetAsync(0);
+
+	vector<PltArchive::ROOT_CHUNK> roots = m_ar.RootChunks();
+	size_t n = m_nindex0;
+	for (size_t i = 0; i < roots.size(); ++i)
+	{
+		PltArchive::ROOT_CHUNK& rc = roots[i];
+		if ((rc.id == PLT_STATE) && (n < m_index.size()))
+		{
+			m_index[n].pos = rc.pos;
+			m_index[n].ncompress = rc.ncompress;
+			n++;
+		}
+	}
+	assert(n == m_index.size());
+	if (n != m_index.size()) return;
+
+	unsigned int nvar = (unsigned int)(m_dic.m_Node.size() + m_dic.m_Elem.size() + m_dic.m_Face.size());
+	int ns = (int) m_index.size();
+	vector<unsigned long long> pos(ns);
+	vector<unsigned int> fmt(ns);
+	vector<float> time(ns);
+	vector<unsigned int> varPos; varPos.reserve(ns*nvar);
+	for (int i = 0; i < ns; ++i)
+	{
+		STATE_INDEX& si = m_index[i];
+		pos[i] = si.pos;
+		fmt[i] = si.ncompress;
+		time[i] = si.time;
+		for (unsigned int j = 0; j < nvar; ++j) varPos.push_back(j < si.varPos.size() ? si.varPos[j] : 0);
+	}
+
+	// the index is never compressed
+	m_ar.SetCompression(0);
+	m_ar.BeginChunk(PLT_STATE_INDEX);
+	{
+		unsigned long long ipos = m_ar.RootChunks().back().pos;
+
+		m_ar.WriteChunk(PLT_INDEX_VARIABLES, nvar);
+		if (ns > 0)
+		{
+			m_ar.WriteChunk(PLT_INDEX_STATE_POS, pos);
+			m_ar.WriteChunk(PLT_INDEX_STATE_FMT, fmt);
+			m_ar.WriteChunk(PLT_INDEX_STATE_TIME, time);
+			if (varPos.empty() == false) m_ar.WriteChunk(PLT_INDEX_VAR_POS, varPos);
+		}
+		m_ar.WriteChunk(PLT_INDEX_POS, ipos);
+	}
+	m_ar.EndChunk();
+}
+
 //-----------------------------------------------------------------------------
 bool FEBioPlotFile::Open(FEModel &fem, const char *szfile)
 {
@@ -757,6 +863,7 @@ bool FEBioPlotFile::WriteHeader(FEModel& fem)
 {
 	// setup the header
 	unsigned int nversion = PLT_VERSION;
+	if ((m_ncompress == PltArchive::COMPRESS_BLOCKS) || (m_ncompress == PltArchive::COMPRESS_BLOCKS_SHUFFLE)) nversion = PLT_VERSION_BLOCKS;
 
 	// output header
 	m_ar.WriteChunk(PLT_HDR_VERSION, nversion);
@@ -1381,6 +1488,16 @@ bool FEBioPlotFile::Write(FEModel &fem, float ftime)
 	// store the fem pointer
 	m_pfem = &fem;
 
+	// add an index entry (the file position is filled in when the index is written)
+	if (m_bindex)
+	{
+		STATE_INDEX si;
+		si.pos = 0;
+		si.ncompress = 0;
+		si.time = ftime;
+		m_index.push_back(si);
+	}
+
 	// compress these sections if requested
 	m_ar.SetCompression(m_ncompress);
 	m_ar.BeginChunk(PLT_STATE);
@@ -1466,65 +1583,107 @@ void FEBioPlotFile::WriteGlobalData(FEModel& fem)
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::WriteNodeData(FEModel& fem)
 {
-	list<DICTIONARY_ITEM>::iterator it = m_dic.m_Node.begin();
-	for (int i=0; i<(int) m_dic.m_Node.size(); ++i, ++it)
-	{
-		m_ar.BeginChunk(PLT_STATE_VARIABLE);
-		{
-			unsigned int nid = i+1;
-			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
-			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
-			{
-				if (it->m_psave) WriteNodeDataField(fem, it->m_psave);
-			}
-			m_ar.EndChunk();
-		}
-		m_ar.EndChunk();
-	}
+	WriteDataFields(fem, m_dic.m_Node, &FEBioPlotFile::EvalNodeDataField);
 }
 
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::WriteDomainData(FEModel& fem)
 {
-	list<DICTIONARY_ITEM>::iterator it = m_dic.m_Elem.begin();
-	for (int i=0; i<(int) m_dic.m_Elem.size(); ++i, ++it)
+	WriteDataFields(fem, m_dic.m_Elem, &FEBioPlotFile::EvalDomainDataField);
+}
+
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
+{
+	WriteDataFields(fem, m_dic.m_Face, &FEBioPlotFile::EvalSurfaceDataField);
+}
+
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::FIELD_DATA::Add(int id, FEDataStream& a)
+{
+	m_id.push_back(id);
+	m_data.push_back(FEDataStream());
+	m_data.back().data().swap(a.data());
+}
+
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::FIELD_DATA::Quantize(double tol)
+{
+	for (size_t i = 0; i < m_data.size(); ++i)
 	{
-		m_ar.BeginChunk(PLT_STATE_VARIABLE);
+		vector<float>& v = m_data[i].data();
+		for (size_t j = 0; j < v.size(); ++j)
 		{
-			unsigned int nid = i+1;
-			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
-			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
-			{
-				if (it->m_psave) WriteDomainDataField(fem, it->m_psave);
-			}
-			m_ar.EndChunk();
+			v[j] = (float)(tol*floor(v[j] / tol + 0.5));
 		}
-		m_ar.EndChunk();
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
+// Evaluates and writes the variables of a dictionary list. When there are enough 
+// variables to keep all threads busy, the variables are evaluated in parallel 
+// before they are written. Otherwise, they are evaluated one at a time, so that 
+// the plot data can use all threads itself. Either way, the variables are written
+// in the order of the dictionary.
+void FEBioPlotFile::WriteDataFields(FEModel& fem, list<DICTIONARY_ITEM>& dic, EvalFunction eval)
 {
-	list<DICTIONARY_ITEM>::iterator it = m_dic.m_Face.begin();
-	for (int i=0; i<(int) m_dic.m_Face.size(); ++i, ++it)
+	int NF = (int)dic.size();
+	vector<FEPlotData*> pd; pd.reserve(NF);
+	vector<double> tol; tol.reserve(NF);
+	for (list<DICTIONARY_ITEM>::iterator it = dic.begin(); it != dic.end(); ++it)
+	{
+		pd.push_back(it->m_psave);
+		tol.push_back(it->m_tol);
+	}
+
+	// (This counts the threads without calling the OpenMP runtime, so it also works without OpenMP.)
+	int nthreads = 0;
+	#pragma omp parallel reduction(+:nthreads)
+	nthreads++;
+
+	vector<FIELD_DATA> data(NF);
+	bool bpar = (NF > 1) && (NF >= nthreads);
+	if (bpar)
+	{
+		// Note that each variable is evaluated by one thread only.
+		#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < NF; ++i)
+		{
+			if (pd[i]) (this->*eval)(fem, pd[i], data[i]);
+			if (tol[i] > 0.0) data[i].Quantize(tol[i]);
+		}
+	}
+
+	for (int i=0; i<NF; ++i)
 	{
+		if (bpar == false)
+		{
+			if (pd[i]) (this->*eval)(fem, pd[i], data[i]);
+			if (tol[i] > 0.0) data[i].Quantize(tol[i]);
+		}
+
+		if (m_bindex) m_index.back().varPos.push_back((unsigned int) m_ar.RootPosition());
+
 		m_ar.BeginChunk(PLT_STATE_VARIABLE);
 		{
 			unsigned int nid = i+1;
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteSurfaceDataField(fem, it->m_psave);
+				FIELD_DATA& d = data[i];
+				for (size_t j = 0; j < d.m_id.size(); ++j) m_ar.WriteData(d.m_id[j], d.m_data[j].data());
 			}
 			m_ar.EndChunk();
 		}
 		m_ar.EndChunk();
+
+		// we don't need this data anymore
+		data[i] = FIELD_DATA();
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::EvalNodeDataField(FEModel &fem, FEPlotData* pd, FIELD_DATA& data)
 {
 	// loop over all node sets
 	// right now there is only one, namely the node set of all mesh nodes
@@ -1536,12 +1695,12 @@ void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
 	if (pd->Save(fem.GetMesh(), a))
 	{
 		assert(a.size() == N*ndata);
-		m_ar.WriteData(0, a.data());
+		data.Add(0, a);
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
+void FEBioPlotFile::EvalSurfaceDataField(FEModel& fem, FEPlotData* pd, FIELD_DATA& data)
 {
 	// loop over all surfaces
 	FEMesh& m = fem.GetMesh();
@@ -1583,7 +1742,7 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 			if (a.size() == nsize)
 			{
 				// assumed padding is already there, or not needed
-				m_ar.WriteData(i + 1, a.data());
+				data.Add(i + 1, a);
 			}
 			else
 			{
@@ -1605,14 +1764,14 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 				}
 
 				// write the padded data
-				m_ar.WriteData(i + 1, b.data());
+				data.Add(i + 1, b);
 			}
 		}
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::EvalDomainDataField(FEModel &fem, FEPlotData* pd, FIELD_DATA& data)
 {
 	FEMesh& m = fem.GetMesh();
 	int ND = m.Domains();
@@ -1626,7 +1785,7 @@ void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
 
 	// loop over all domains in the item list
 	int N = (int)item.size();
-	for (int i = 0; i<ND; ++i)
+	for (int i = 0; i<N; ++i)
 	{
 		// get the domain
 		FEDomain& D = m.Domain(item[i]);
@@ -1661,7 +1820,7 @@ void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
 		if (pd->Save(D, a))
 		{
 			assert(a.size() == nsize);
-			m_ar.WriteData(item[i] + 1, a.data());
+			data.Add(item[i] + 1, a);
 		}
 	}
 }
@@ -1696,10 +1855,24 @@ bool FEBioPlotFile::Append(FEModel& fem, const char *szfile)
 	// rebuild the surface table
 	BuildSurfaceTable();
 
-	// ... and open for appending
-	if (bok) return m_ar.Append(szfile);
+	if (bok == false) return false;
 
-	return false;
+	// An existing state index is removed now, and rewritten with the new states when 
+	// the file is closed. (This also turns indexing on.)
+	size_t nend = (size_t)-1;
+	m_index.clear();
+	PltReader rd;
+	if (rd.Open(szfile))
+	{
+		if (rd.HasIndex()) { m_bindex = true; nend = rd.IndexPosition(); }
+		if (m_bindex) m_index = rd.GetStateIndex();
+	}
+	else m_bindex = false;
+	rd.Close();
+	m_nindex0 = m_index.size();
+
+	// ... and open for appending
+	return m_ar.Append(szfile, nend);
 }
 
 //-----------------------------------------------------------------------------
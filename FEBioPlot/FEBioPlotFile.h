@@ -45,7 +45,9 @@ class FEBioPlotFile : public PlotFile
 {
 public:
 	// file version
-	enum { PLT_VERSION = 0x0030 };
+	// Files with block compressed states (compression 2 and 3) get a higher
+	// version, so that readers that cannot decode them refuse the file.
+	enum { PLT_VERSION = 0x0030, PLT_VERSION_BLOCKS = 0x0031 };
 
 	// file tags
 	enum { 
@@ -139,7 +141,16 @@ public:
 				PLT_FACE_DATA			= 0x02020500,
 			PLT_MESH_STATE				= 0x02030000,
 				PLT_ELEMENT_STATE		= 0x02030001,
-			PLT_OBJECTS_STATE			= 0x02040000
+			PLT_OBJECTS_STATE			= 0x02040000,
+
+		// The (optional) state index is the last chunk of the file. It is rewritten when states are appended.
+		PLT_STATE_INDEX					= 0x04000000,
+			PLT_INDEX_VARIABLES			= 0x04000001,	// nr of variables (nodal, domain, and surface)
+			PLT_INDEX_STATE_POS			= 0x04000002,	// file position of each state chunk (64-bit)
+			PLT_INDEX_STATE_FMT			= 0x04000003,	// compression level that each state was written with
+			PLT_INDEX_STATE_TIME		= 0x04000004,	// time of each state
+			PLT_INDEX_VAR_POS			= 0x04000005,	// position of each variable chunk, relative to the start of the uncompressed state
+			PLT_INDEX_POS				= 0x04000006	// file position of the index chunk (64-bit). This must be the last chunk.
 	};
 	// --- element types ---
 	enum Elem_Type { 
@@ -182,6 +193,7 @@ public:
 		unsigned int	m_arraySize;	// size of arrays (only used by arrays)
 		vector<string>	m_arrayNames;	// names of array components (optional)
 		char			m_szname[STR_SIZE];
+		double			m_tol;		// quantization tolerance (0 = store values as is)
 	};
 
 	class Dictionary
@@ -265,6 +277,15 @@ public:
 		vec3d	m_r2;	// point 2
 	};
 
+	// state index entry
+	struct STATE_INDEX
+	{
+		unsigned long long		pos;		// file position of the state chunk
+		unsigned int			ncompress;	// compression level of the state
+		float					time;		// state time
+		vector<unsigned int>	varPos;		// position of the variables (0 = not written)
+	};
+
 public:
 	FEBioPlotFile(FEModel& fem);
 	~FEBioPlotFile(void);
@@ -284,11 +305,22 @@ public:
 	//! Add a variable to the dictionary
 	bool AddVariable(FEPlotData* ps, const char* szname);
 	bool AddVariable(const char* sz);
-	bool AddVariable(const char* sz, vector<int>& item, const char* szdom = "");
+	bool AddVariable(const char* sz, vector<int>& item, const char* szdom = "", double tol = 0.0);
+
+	//! Set the quantization tolerance of the variables with this name
+	void SetTolerance(const char* sz, double tol);
 
 	//! Set the compression level
+	//! 0 = none, 1 = zlib stream, 2 = parallel zlib blocks, 3 = parallel zlib blocks with byte shuffling
+	//! (see PltArchive for the block format)
 	void SetCompression(int n);
 
+	//! Write the states on a background thread (n = max nr of queued states, 0 = synchronous)
+	void SetAsync(int n);
+
+	//! Write a state index at the end of the file (see PltReader)
+	void SetIndexing(bool b);
+
 	//! see if the plot file is valid
 	virtual bool IsValid() const;
 
@@ -336,12 +368,30 @@ protected:
 	void WriteObjectsState();
 	void WriteObjectData(PlotObject* po);
 
-	void WriteNodeDataField(FEModel& fem, FEPlotData* pd);
-	void WriteDomainDataField(FEModel& fem, FEPlotData* pd);
-	void WriteSurfaceDataField(FEModel& fem, FEPlotData* pd);
+	// the evaluated data of a plot variable (one data stream for each region)
+	struct FIELD_DATA
+	{
+		void Add(int id, FEDataStream& a);
+
+		// round all values to the nearest multiple of tol
+		void Quantize(double tol);
+
+		vector<int>				m_id;	// region IDs
+		vector<FEDataStream>	m_data;	// region data
+	};
+
+	typedef void (FEBioPlotFile::*EvalFunction)(FEModel& fem, FEPlotData* pd, FIELD_DATA& data);
+
+	void WriteDataFields(FEModel& fem, list<DICTIONARY_ITEM>& dic, EvalFunction eval);
+
+	void EvalNodeDataField   (FEModel& fem, FEPlotData* pd, FIELD_DATA& data);
+	void EvalDomainDataField (FEModel& fem, FEPlotData* pd, FIELD_DATA& data);
+	void EvalSurfaceDataField(FEModel& fem, FEPlotData* pd, FIELD_DATA& data);
 
 	void WriteMeshState(FEMesh& mesh);
 
+	void WriteIndex();
+
 protected:
 	bool ReadDictionary();
 	bool ReadDicList();
@@ -357,6 +407,10 @@ protected:
 
 	vector<PointObject*>	m_Points;
 	vector<LineObject*>		m_Lines;
+
+	bool				m_bindex;	// write the state index?
+	vector<STATE_INDEX>	m_index;	// state index
+	size_t				m_nindex0;	// nr of states that were in the file before it was opened for appending
 };
 
 //-----------------------------------------------------------------------------
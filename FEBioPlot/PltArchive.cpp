@@ -29,6 +29,11 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "PltArchive.h"
 #include <assert.h>
+#ifdef WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #ifdef HAVE_ZLIB
 #include "zlib.h"
@@ -40,8 +45,10 @@ static z_stream strm;
 //=============================================================================
 FileStream::FileStream()
 {
+	m_fp = 0;
 	m_bufsize = 262144;	// = 256K
 	m_current = 0;
+	m_base = 0;
 	m_buf  = new unsigned char[m_bufsize];
 	m_pout = new unsigned char[m_bufsize];
 	m_ncompress = 0;
@@ -63,15 +70,39 @@ bool FileStream::Open(const char* szfile)
 	return true;
 }
 
-bool FileStream::Append(const char* szfile)
+// The file is not opened in append mode, since chunk sizes may need to be
+// patched after they are written.
+bool FileStream::Append(const char* szfile, size_t nend)
 {
-	m_fp = fopen(szfile, "a+b");
-	return (m_fp != 0);
+	m_fp = fopen(szfile, "r+b");
+	if (m_fp == 0) return false;
+
+	// discard the end of the file
+	if (nend != (size_t)-1)
+	{
+#ifdef WIN32
+		if (_chsize_s(_fileno(m_fp), (__int64) nend) != 0) { Close(); return false; }
+#else
+		if (ftruncate(fileno(m_fp), (off_t) nend) != 0) { Close(); return false; }
+#endif
+	}
+
+#ifdef WIN32
+	_fseeki64(m_fp, 0, SEEK_END);
+	m_base = (size_t) _ftelli64(m_fp);
+#else
+	fseeko(m_fp, 0, SEEK_END);
+	m_base = (size_t) ftello(m_fp);
+#endif
+	m_current = 0;
+	return true;
 }
 
 bool FileStream::Create(const char* szfile)
 {
 	m_fp = fopen(szfile, "wb");
+	m_base = 0;
+	m_current = 0;
 	return (m_fp != 0);
 }
 
@@ -112,6 +143,7 @@ void FileStream::EndStreaming()
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
 			int have = m_bufsize - strm.avail_out;
 			fwrite(m_pout, 1, have, m_fp);
+			m_base += have;
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
 
@@ -123,10 +155,19 @@ void FileStream::EndStreaming()
 #endif
 }
 
-void FileStream::Write(void* pd, size_t Size, size_t Count)
+void FileStream::Write(const void* pd, size_t Size, size_t Count)
 {
-	unsigned char* pdata = (unsigned char*) pd;
+	const unsigned char* pdata = (const unsigned char*) pd;
 	size_t nsize = Size*Count;
+
+	// large blocks are passed on directly, without copying them to the buffer first
+	if (nsize >= m_bufsize)
+	{
+		Flush();
+		WriteBlock(pdata, nsize);
+		return;
+	}
+
 	while (nsize > 0)
 	{
 		if (m_current + nsize < m_bufsize)
@@ -146,13 +187,13 @@ void FileStream::Write(void* pd, size_t Size, size_t Count)
 	}
 }
 
-void FileStream::Flush()
+void FileStream::WriteBlock(const unsigned char* pd, size_t nsize)
 {
 #ifdef HAVE_ZLIB
 	if (m_ncompress)
 	{
-		strm.avail_in = m_current;
-		strm.next_in = m_buf;
+		strm.avail_in = (uInt) nsize;
+		strm.next_in = (Bytef*) pd;
 
 		/* run deflate() on input until output buffer not full, finish
 		compression if all of source has been read in */
@@ -163,16 +204,19 @@ void FileStream::Flush()
 			assert(ret != Z_STREAM_ERROR);  /* state not clobbered */
 			int have = m_bufsize - strm.avail_out;
 			fwrite(m_pout, 1, have, m_fp);
+			m_base += have;
 		} while (strm.avail_out == 0);
 		assert(strm.avail_in == 0);     /* all input will be used */
+		return;
 	}
-	else
-	{
-		if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
-	}
-#else
-	if (m_fp) fwrite(m_buf, m_current, 1, m_fp);
 #endif
+	if (m_fp && nsize) fwrite(pd, nsize, 1, m_fp);
+	m_base += nsize;
+}
+
+void FileStream::Flush()
+{
+	WriteBlock(m_buf, m_current);
 
 	// flush the file
 	if (m_fp) fflush(m_fp);
@@ -181,6 +225,29 @@ void FileStream::Flush()
 	m_current = 0;
 }
 
+// Data that is still in the buffer is patched in place. Otherwise, the buffer is
+// flushed and the data is overwritten in the file.
+void FileStream::Patch(size_t pos, const void* pd, size_t size)
+{
+	if (pos >= m_base)
+	{
+		assert(pos + size <= m_base + m_current);
+		memcpy(m_buf + (pos - m_base), pd, size);
+		return;
+	}
+
+	assert(m_ncompress == 0);
+	Flush();
+	if (m_fp == 0) return;
+#ifdef WIN32
+	_fseeki64(m_fp, (__int64) pos, SEEK_SET);
+#else
+	fseeko(m_fp, (off_t) pos, SEEK_SET);
+#endif
+	fwrite(pd, size, 1, m_fp);
+	fseek(m_fp, 0, SEEK_END);
+}
+
 size_t FileStream::read(void* pd, size_t Size, size_t Count)
 {
 	return fread(pd, Size, Count, m_fp);
@@ -204,9 +271,15 @@ void FileStream::seek(long noff, int norigin)
 PltArchive::PltArchive()
 {
 	m_fp = 0;
-	m_pRoot = 0;
-	m_pChunk = 0;
+	m_pbuf = nullptr;
 	m_bSaving = true;
+	m_ncompress = 0;
+	m_rootId = 0;
+	m_rootStart = 0;
+
+	m_nqueue = 0;
+	m_writer = nullptr;
+	m_bstop = false;
 }
 
 PltArchive::~PltArchive()
@@ -218,7 +291,14 @@ void PltArchive::Close()
 {
 	if (m_bSaving)
 	{
-		if (m_pRoot) Flush();
+		// close any open chunks
+		while (m_open.empty() == false) EndChunk();
+
+		// wait for the writer to finish all pending chunks
+		StopWriter();
+
+		for (size_t i = 0; i < m_free.size(); ++i) delete m_free[i];
+		m_free.clear();
 	}
 	else 
 	{
@@ -235,22 +315,295 @@ void PltArchive::Close()
 	}
 }
 
+// The compression level is applied when the root chunk is written, since 
+// that may happen later on the writer thread.
 void PltArchive::SetCompression(int n)
 {
-	if (m_fp) m_fp->SetCompression(n);
+	m_ncompress = n;
+}
+
+void PltArchive::SetAsync(int nqueue)
+{
+	// finish what is still pending when switching modes
+	if (nqueue <= 0) StopWriter();
+	m_nqueue = (nqueue > 0 ? nqueue : 0);
 }
 
 void PltArchive::Flush()
 {
-	if (m_fp && m_pRoot)
+	// a root chunk that was streamed to the file only needs to be flushed
+	if (m_pbuf == nullptr)
+	{
+		if (m_fp) m_fp->Flush();
+		return;
+	}
+
+	PENDING p = { m_pbuf, m_ncompress, m_rootId };
+	m_pbuf = nullptr;
+
+	if (m_fp == 0)
+	{
+		ReleaseBuffer(p.buf);
+		return;
+	}
+
+	if (m_nqueue == 0)
+	{
+		WriteRoot(p);
+		return;
+	}
+
+	// hand the chunk data to the writer thread
+	std::unique_lock<std::mutex> lock(m_mtx);
+	if (m_writer == nullptr)
 	{
+		m_bstop = false;
+		m_writer = new std::thread(&PltArchive::WriterThread, this);
+	}
+
+	// wait until there is room in the queue
+	m_cv.wait(lock, [this]() { return ((int)m_queue.size() < m_nqueue); });
+	m_queue.push_back(p);
+	m_cv.notify_all();
+}
+
+void PltArchive::WriteRoot(PENDING& p)
+{
+	Buffer& buf = *p.buf;
+
+	ROOT_CHUNK rc = { p.id, p.ncompress, m_fp->WritePosition() };
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_roots.push_back(rc);
+	}
+
+	if ((p.ncompress == COMPRESS_BLOCKS) || (p.ncompress == COMPRESS_BLOCKS_SHUFFLE))
+	{
+		WriteBlocks(buf, (p.ncompress == COMPRESS_BLOCKS_SHUFFLE ? BLOCK_FILTER_SHUFFLE : BLOCK_FILTER_NONE));
+	}
+	else
+	{
+		m_fp->SetCompression(p.ncompress);
 		m_fp->BeginStreaming();
-		m_pRoot->Write(m_fp);
+		if (buf.empty() == false) m_fp->Write(&buf[0], 1, buf.size());
 		m_fp->EndStreaming();
 	}
-	delete m_pRoot;
-	m_pRoot = 0;
-	m_pChunk = 0;
+	ReleaseBuffer(p.buf);
+	p.buf = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// byte shuffle filter (see the description of the block format)
+static void shuffle(const unsigned char* src, unsigned char* dst, size_t n)
+{
+	size_t nw = n / 4;
+	for (size_t i = 0; i < nw; ++i)
+		for (int k = 0; k < 4; ++k) dst[k*nw + i] = src[4*i + k];
+	for (size_t i = 4*nw; i < n; ++i) dst[i] = src[i];
+}
+
+static void unshuffle(const unsigned char* src, unsigned char* dst, size_t n)
+{
+	size_t nw = n / 4;
+	for (size_t i = 0; i < nw; ++i)
+		for (int k = 0; k < 4; ++k) dst[4*i + k] = src[k*nw + i];
+	for (size_t i = 4*nw; i < n; ++i) dst[i] = src[i];
+}
+
+void PltArchive::WriteBlocks(Buffer& buf, int filter)
+{
+	size_t raw = buf.size();
+	int nblocks = (int)((raw + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+	// compress all blocks
+	vector<Buffer> out(nblocks);
+	#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < nblocks; ++i)
+	{
+		size_t n0 = (size_t)i * BLOCK_SIZE;
+		size_t n = (raw - n0 < BLOCK_SIZE ? raw - n0 : BLOCK_SIZE);
+		const unsigned char* src = &buf[n0];
+
+		Buffer tmp;
+		if (filter == BLOCK_FILTER_SHUFFLE)
+		{
+			tmp.resize(n);
+			shuffle(src, &tmp[0], n);
+			src = &tmp[0];
+		}
+
+		Buffer& dst = out[i];
+#ifdef HAVE_ZLIB
+		uLongf nc = compressBound((uLong)n);
+		dst.resize(nc);
+		if ((compress2(&dst[0], &nc, src, (uLong)n, Z_DEFAULT_COMPRESSION) == Z_OK) && (nc < n)) dst.resize(nc);
+		else dst.assign(src, src + n);
+#else
+		dst.assign(src, src + n);
+#endif
+	}
+
+	// write the chunk
+	unsigned int hdr[4] = { (unsigned int)filter, (unsigned int)raw, (unsigned int)BLOCK_SIZE, (unsigned int)nblocks };
+	size_t nsize = sizeof(hdr) + nblocks*sizeof(unsigned int);
+	for (int i = 0; i < nblocks; ++i) nsize += out[i].size();
+
+	unsigned int nid = BLOCK_CHUNK_ID;
+	unsigned int nchunk = (unsigned int) nsize;
+	m_fp->SetCompression(0);
+	m_fp->Write(&nid, sizeof(unsigned int), 1);
+	m_fp->Write(&nchunk, sizeof(unsigned int), 1);
+	m_fp->Write(hdr, sizeof(unsigned int), 4);
+	for (int i = 0; i < nblocks; ++i)
+	{
+		unsigned int nc = (unsigned int) out[i].size();
+		m_fp->Write(&nc, sizeof(unsigned int), 1);
+	}
+	for (int i = 0; i < nblocks; ++i) m_fp->Write(&(out[i])[0], 1, out[i].size());
+	m_fp->Flush();
+}
+
+bool PltArchive::DecodeBlocks(const unsigned char* pd, size_t nsize, std::vector<unsigned char>& out, size_t noff, size_t nlen)
+{
+	if (nsize < 4 * sizeof(unsigned int)) return false;
+	unsigned int hdr[4];
+	memcpy(hdr, pd, sizeof(hdr));
+	unsigned int filter = hdr[0];
+	size_t raw = hdr[1];
+	size_t bsize = hdr[2];
+	int nblocks = (int)hdr[3];
+	if ((bsize == 0) || (nblocks != (int)((raw + bsize - 1) / bsize))) return false;
+
+	size_t noffset = sizeof(hdr) + nblocks*sizeof(unsigned int);
+	if (noffset > nsize) return false;
+
+	// find the start of each compressed block
+	vector<size_t> start(nblocks + 1);
+	start[0] = noffset;
+	for (int i = 0; i < nblocks; ++i)
+	{
+		unsigned int nc;
+		memcpy(&nc, pd + sizeof(hdr) + i*sizeof(unsigned int), sizeof(unsigned int));
+		start[i + 1] = start[i] + nc;
+	}
+	if (start[nblocks] > nsize) return false;
+
+	// the requested range
+	if (noff > raw) return false;
+	size_t nend = (nlen > raw - noff ? raw : noff + nlen);
+	out.resize(nend - noff);
+	if (nend == noff) return true;
+	int b0 = (int)(noff / bsize);
+	int b1 = (int)((nend - 1) / bsize);
+
+	int nerr = 0;
+	#pragma omp parallel for schedule(dynamic) reduction(+:nerr)
+	for (int i = b0; i <= b1; ++i)
+	{
+		size_t n0 = (size_t)i * bsize;
+		size_t n = (raw - n0 < bsize ? raw - n0 : bsize);
+		size_t nc = start[i + 1] - start[i];
+		const unsigned char* src = pd + start[i];
+
+		// decode the block in place if it is entirely in range and doesn't need to be unshuffled
+		Buffer tmp;
+		bool inplace = ((n0 >= noff) && (n0 + n <= nend) && (filter != BLOCK_FILTER_SHUFFLE));
+		unsigned char* dst = nullptr;
+		if (inplace) dst = &out[n0 - noff];
+		else { tmp.resize(n); dst = &tmp[0]; }
+
+		if (nc == n) memcpy(dst, src, n);
+		else
+		{
+#ifdef HAVE_ZLIB
+			uLongf nd = (uLongf)n;
+			if ((uncompress(dst, &nd, src, (uLong)nc) != Z_OK) || (nd != n)) nerr++;
+#else
+			nerr++;
+#endif
+		}
+
+		if (inplace == false)
+		{
+			if (filter == BLOCK_FILTER_SHUFFLE)
+			{
+				Buffer tmp2(n);
+				unshuffle(dst, &tmp2[0], n);
+				tmp.swap(tmp2);
+			}
+
+			// copy the part that is in range
+			size_t m0 = (n0 < noff ? noff : n0);
+			size_t m1 = (n0 + n > nend ? nend : n0 + n);
+			memcpy(&out[m0 - noff], &tmp[m0 - n0], m1 - m0);
+		}
+	}
+
+	return (nerr == 0);
+}
+
+std::vector<PltArchive::ROOT_CHUNK> PltArchive::RootChunks()
+{
+	std::lock_guard<std::mutex> lock(m_mtx);
+	return m_roots;
+}
+
+PltArchive::Buffer* PltArchive::NewBuffer()
+{
+	Buffer* buf = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		if (m_free.empty() == false)
+		{
+			buf = m_free.back();
+			m_free.pop_back();
+		}
+	}
+	if (buf == nullptr) buf = new Buffer;
+
+	// (this keeps the capacity of a reused buffer)
+	buf->clear();
+	return buf;
+}
+
+void PltArchive::ReleaseBuffer(Buffer* buf)
+{
+	std::lock_guard<std::mutex> lock(m_mtx);
+	m_free.push_back(buf);
+}
+
+void PltArchive::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_mtx);
+	while (true)
+	{
+		m_cv.wait(lock, [this]() { return (m_bstop || (m_queue.empty() == false)); });
+		if (m_queue.empty()) break;
+
+		PENDING p = m_queue.front();
+		m_queue.pop_front();
+
+		// write the chunk without holding the lock, so that the next 
+		// chunk can be queued in the meantime
+		lock.unlock();
+		m_cv.notify_all();
+		WriteRoot(p);
+		lock.lock();
+	}
+}
+
+void PltArchive::StopWriter()
+{
+	if (m_writer == nullptr) return;
+	{
+		std::lock_guard<std::mutex> lock(m_mtx);
+		m_bstop = true;
+	}
+	m_cv.notify_all();
+	m_writer->join();
+	delete m_writer;
+	m_writer = nullptr;
+	m_bstop = false;
 }
 
 bool PltArchive::Create(const char* szfile)
@@ -259,6 +612,7 @@ bool PltArchive::Create(const char* szfile)
 	assert(m_fp == 0);
 	m_fp = new FileStream();
 	if (m_fp->Create(szfile) == false) return false;
+	m_roots.clear();
 
 	// write the root tag 
 	unsigned int ntag = 0x00464542;
@@ -271,35 +625,83 @@ bool PltArchive::Create(const char* szfile)
 
 void PltArchive::BeginChunk(unsigned int id)
 {
-	if (m_pRoot == 0)
+	if (m_open.empty())
 	{
-		m_pRoot = new OBranch(id);
-		m_pChunk = m_pRoot;
+		// A root chunk can be streamed straight to the file, if it is written 
+		// synchronously and uncompressed. Otherwise, it is collected in a buffer.
+		assert(m_pbuf == nullptr);
+		m_rootId = id;
+		if ((m_nqueue > 0) || (m_ncompress != 0)) m_pbuf = NewBuffer();
+		else if (m_fp)
+		{
+			m_fp->SetCompression(0);
+			ROOT_CHUNK rc = { id, 0, m_fp->WritePosition() };
+			std::lock_guard<std::mutex> lock(m_mtx);
+			m_roots.push_back(rc);
+		}
+		m_rootStart = position();
 	}
-	else
-	{
-		// create a new branch
-		OBranch* pbranch = new OBranch(id);
 
-		// attach it to the current branch
-		m_pChunk->AddChild(pbranch);
-
-		// move the current branch pointer
-		m_pChunk = pbranch;
-	}
+	// write the header with a placeholder size
+	unsigned int nsize = 0;
+	write(&id, sizeof(unsigned int));
+	m_open.push_back(position());
+	write(&nsize, sizeof(unsigned int));
 }
 
 void PltArchive::EndChunk()
 {
-	if (m_pChunk != m_pRoot)
-		m_pChunk = m_pChunk->GetParent();
-	else 
+	assert(m_open.empty() == false);
+	if (m_open.empty()) return;
+
+	// patch the chunk size
+	size_t pos = m_open.back(); m_open.pop_back();
+	size_t nsize = position() - pos - sizeof(unsigned int);
+	patch(pos, (unsigned int) nsize);
+
+	// write the root chunk when it's done
+	if (m_open.empty()) Flush();
+}
+
+void PltArchive::WriteChunk(unsigned int nid, const char* sz)
+{
+	int l = (int)strlen(sz);
+	unsigned int nsize = l + sizeof(int);
+	write(&nid  , sizeof(unsigned int));
+	write(&nsize, sizeof(unsigned int));
+	write(&l    , sizeof(int));
+	write(sz    , l);
+}
+
+void PltArchive::WriteLeaf(unsigned int nid, const void* pd, size_t nsize)
+{
+	unsigned int n = (unsigned int) nsize;
+	write(&nid, sizeof(unsigned int));
+	write(&n  , sizeof(unsigned int));
+	if (nsize > 0) write(pd, nsize);
+}
+
+void PltArchive::write(const void* pd, size_t nsize)
+{
+	if (m_pbuf)
 	{
-		Flush();
+		const unsigned char* pc = (const unsigned char*) pd;
+		m_pbuf->insert(m_pbuf->end(), pc, pc + nsize);
 	}
+	else if (m_fp) m_fp->Write(pd, 1, nsize);
 }
 
+size_t PltArchive::position() const
+{
+	if (m_pbuf) return m_pbuf->size();
+	return (m_fp ? m_fp->WritePosition() : 0);
+}
 
+void PltArchive::patch(size_t pos, unsigned int n)
+{
+	if (m_pbuf) memcpy(&(*m_pbuf)[pos], &n, sizeof(unsigned int));
+	else if (m_fp) m_fp->Patch(pos, &n, sizeof(unsigned int));
+}
 
 //-----------------------------------------------------------------------------
 
@@ -321,13 +723,14 @@ bool PltArchive::Open(const char* szfile)
 	return true;
 }
 
-bool PltArchive::Append(const char* szfile)
+bool PltArchive::Append(const char* szfile, size_t nend)
 {
 	// reopen the plot file for appending
 	assert(m_fp == 0);
 	m_fp = new FileStream();
-	if (m_fp->Append(szfile) == false) return false;
+	if (m_fp->Append(szfile, nend) == false) { delete m_fp; m_fp = 0; return false; }
 	m_bSaving = true;
+	m_roots.clear();
 	return true;
 }
 
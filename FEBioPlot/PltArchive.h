@@ -35,6 +35,10 @@ SOFTWARE.*/
 #include <list>
 #include <vector>
 #include <stack>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -47,13 +51,20 @@ public:
 
 	bool Create(const char* szfile);
 	bool Open(const char* szfile);
-	bool Append(const char* szfile);
+	bool Append(const char* szfile, size_t nend = (size_t)-1);
 	void Close();
 
-	void Write(void* pd, size_t Size, size_t Count);
+	void Write(const void* pd, size_t Size, size_t Count);
 
 	void Flush();
 
+	// position (in bytes from the start of the file) where the next Write will go
+	// (For compressed streams this is only valid between streams.)
+	size_t WritePosition() const { return m_base + m_current; }
+
+	// overwrite data that was written before (only for uncompressed streams)
+	void Patch(size_t pos, const void* pd, size_t size);
+
 	// \todo temporary reading functions. Needs to be replaced with buffered functions
 	size_t read(void* pd, size_t Size, size_t Count);
 	long tell();
@@ -64,173 +75,19 @@ public:
 
 	void SetCompression(int n) { m_ncompress = n; }
 
+private:
+	void WriteBlock(const unsigned char* pd, size_t nsize);
+
 private:
 	FILE*	m_fp;
 	size_t	m_bufsize;		//!< buffer size
 	size_t	m_current;		//!< current index
+	size_t	m_base;			//!< file position of the start of the buffer
 	unsigned char*	m_buf;	//!< buffer
 	unsigned char*	m_pout;	//!< temp buffer when writing
 	int		m_ncompress;	//!< compression level
 };
 
-class OBranch;
-
-class OChunk
-{
-public:
-	OChunk(unsigned int nid) { m_nID = nid; m_pParent = 0; }
-	virtual ~OChunk(){}
-
-	unsigned int GetID() { return m_nID; }
-
-	virtual void Write(FileStream* fp) = 0;
-	virtual int Size() = 0;
-
-	void SetParent(OBranch* pparent) { m_pParent = pparent; }
-	OBranch* GetParent() { return m_pParent; }
-
-protected:
-	int			m_nID;
-	OBranch*	m_pParent;
-};
-
-class OBranch : public OChunk
-{
-public:
-	OBranch(unsigned int nid) : OChunk(nid) {}
-	~OBranch()
-	{
-		list<OChunk*>::iterator pc;
-		for (pc = m_child.begin(); pc != m_child.end(); ++pc) delete (*pc);
-		m_child.clear();
-	}
-
-	int Size()
-	{
-		int nsize = 0;
-		list<OChunk*>::iterator pc;
-		for (pc = m_child.begin(); pc != m_child.end(); ++pc) nsize += (*pc)->Size() + 2*sizeof(unsigned int);
-		return nsize;
-	}
-
-	void Write(FileStream* fp)
-	{
-		fp->Write(&m_nID  , sizeof(unsigned int), 1);
-
-		unsigned int nsize = Size();
-		fp->Write(&nsize, sizeof(unsigned int), 1);
-
-		list<OChunk*>::iterator pc;
-		for (pc = m_child.begin(); pc != m_child.end(); ++pc) (*pc)->Write(fp);
-	}
-
-	void AddChild(OChunk* pc) { m_child.push_back(pc); pc->SetParent(this); }
-
-protected:
-	list<OChunk*>	m_child;
-};
-
-template <typename T>
-class OLeaf : public OChunk
-{
-public:
-	OLeaf(unsigned int nid, const T& d) : OChunk(nid) { m_d = d; }
-
-	int Size() { return sizeof(T); }
-
-	void Write(FileStream* fp)
-	{
-		fp->Write(&m_nID  , sizeof(unsigned int), 1);
-		unsigned int nsize = sizeof(T);
-		fp->Write(&nsize, sizeof(unsigned int), 1);
-		fp->Write(&m_d, sizeof(T), 1);
-	}
-
-protected:
-	T	m_d;
-};
-
-template <typename T>
-class OLeaf<T*> : public OChunk
-{
-public:
-	OLeaf(unsigned int nid, const T* pd, int nsize) : OChunk(nid)
-	{
-		assert(nsize > 0);
-		m_pd = new T[nsize];
-		memcpy(m_pd, pd, sizeof(T)*nsize);
-		m_nsize = nsize;
-	}
-	~OLeaf() { delete m_pd; }
-
-	int Size() { return sizeof(T)*m_nsize; }
-	void Write(FileStream* fp)
-	{
-		fp->Write(&m_nID , sizeof(unsigned int), 1);
-		unsigned int nsize = Size();
-		fp->Write(&nsize , sizeof(unsigned int), 1);
-		fp->Write(m_pd   , sizeof(T), m_nsize);
-	}
-
-protected:
-	T*		m_pd;
-	int		m_nsize;
-};
-
-template <>
-class OLeaf<const char*> : public OChunk
-{
-public:
-	OLeaf(unsigned int nid, const char* sz) : OChunk(nid)
-	{
-		int l = (int)strlen(sz);
-		m_psz = new char[l+1];
-		memcpy(m_psz, sz, l+1);
-	}
-	~OLeaf() { delete m_psz; }
-
-	int Size() { return (int)strlen(m_psz)+sizeof(int); }
-	void Write(FileStream* fp)
-	{
-		fp->Write(&m_nID , sizeof(unsigned int), 1);
-		unsigned int nsize = Size();
-		fp->Write(&nsize , sizeof(unsigned int), 1);
-		int l = nsize - sizeof(int);
-		fp->Write(&l, sizeof(int), 1);
-		fp->Write(m_psz, sizeof(char), l);
-	}
-
-protected:
-	char*	m_psz;
-};
-
-template <typename T>
-class OLeaf<vector<T> > : public OChunk
-{
-public:
-	OLeaf(unsigned int nid, vector<T>& a) : OChunk(nid)
-	{
-		m_nsize = (int)a.size();
-		assert(m_nsize > 0);
-		m_pd = new T[m_nsize];
-		memcpy(m_pd, &a[0], sizeof(T)*m_nsize);
-	}
-	~OLeaf() { delete m_pd; }
-
-	int Size() { return sizeof(T)*m_nsize; }
-	void Write(FileStream* fp)
-	{
-		fp->Write(&m_nID , sizeof(unsigned int), 1);
-		unsigned int nsize = Size();
-		fp->Write(&nsize , sizeof(unsigned int), 1);
-		fp->Write(m_pd   , sizeof(T), m_nsize);
-	}
-
-protected:
-	T*		m_pd;
-	int		m_nsize;
-};
-
 //-----------------------------------------------------------------------------
 //! Implementation of an archiving class. Will be used by the FEBioPlotFile class.
 class PltArchive : public Archive
@@ -257,6 +114,12 @@ public:
 	// flush data to file
 	void Flush();
 
+	// Write the root chunks on a background thread. The parameter is the max
+	// nr of root chunks that can be waiting to be written. When the queue is
+	// full, the next root chunk waits until the writer has caught up. 
+	// A value of zero writes synchronously (default).
+	void SetAsync(int nqueue);
+
 public:
 	// --- Writing ---
 
@@ -271,27 +134,26 @@ public:
 
 	template <typename T> void WriteChunk(unsigned int nid, T& o)
 	{
-		m_pChunk->AddChild(new OLeaf<T>(nid, o));
+		WriteLeaf(nid, &o, sizeof(T));
 	}
 
-	void WriteChunk(unsigned int nid, const char* sz)
-	{
-		m_pChunk->AddChild(new OLeaf<const char*>(nid, sz));
-	}
+	void WriteChunk(unsigned int nid, const char* sz);
 
 	void WriteChunk(unsigned int nid, const std::string& s)
 	{
-		m_pChunk->AddChild(new OLeaf<const char*>(nid, s.c_str()));
+		WriteChunk(nid, s.c_str());
 	}
 
 	template <typename T> void WriteChunk(unsigned int nid, T* po, int n)
 	{
-		m_pChunk->AddChild(new OLeaf<T*>(nid, po, n));
+		assert(n > 0);
+		WriteLeaf(nid, po, sizeof(T)*n);
 	}
 
 	template <typename T> void WriteChunk(unsigned int nid, vector<T>& a)
 	{
-		m_pChunk->AddChild(new OLeaf<vector<T> >(nid, a));
+		assert(a.empty() == false);
+		WriteLeaf(nid, (a.empty() ? nullptr : &a[0]), sizeof(T)*a.size());
 	}
 
 	// (overridden from Archive)
@@ -300,13 +162,14 @@ public:
 		WriteChunk(nid, data);
 	}
 
-
 public:
 	// --- Reading ---
 
 	// Open for reading
 	bool Open(const char* sfile);
-	bool Append(const char* szfile);
+
+	// Open for appending. If nend is given, everything after that file position is discarded first.
+	bool Append(const char* szfile, size_t nend = (size_t)-1);
 
 	// Open a chunk
 	int OpenChunk();
@@ -346,13 +209,109 @@ public:
 
 	bool IsValid() const { return (m_fp != 0); }
 
+public:
+	// --- Root chunk positions ---
+
+	// a root chunk that was written to the file
+	struct ROOT_CHUNK
+	{
+		unsigned int	id;			// chunk ID (before compression)
+		int				ncompress;	// compression level it was written with
+		size_t			pos;		// file position
+	};
+
+	// the root chunks that were written since the file was created or opened for appending
+	// (Chunks that are still waiting for the writer thread are not included.)
+	std::vector<ROOT_CHUNK> RootChunks();
+
+	// position of the next write, relative to the start of the current (uncompressed) root chunk
+	size_t RootPosition() const { return position() - m_rootStart; }
+
+public:
+	// --- Block compression ---
+
+	// Compression levels. With block compression a root chunk is split in blocks
+	// of BLOCK_SIZE bytes that are compressed independently (and in parallel). The 
+	// compressed root chunk is written as a chunk with ID BLOCK_CHUNK_ID, which 
+	// contains:
+	//		filter		: (uint) BLOCK_FILTER_NONE or BLOCK_FILTER_SHUFFLE
+	//		raw size	: (uint) size of the original root chunk (including its header)
+	//		block size	: (uint) size of the uncompressed blocks (the last one can be smaller)
+	//		blocks		: (uint) number of blocks
+	//		sizes		: (uint[blocks]) compressed size of each block
+	//		data		: the compressed blocks
+	// A block whose compressed size equals its uncompressed size is stored as is.
+	// The shuffle filter stores the k-th byte of all 4-byte words of a block together, 
+	// which makes float data compress better.
+	// Plot files with block compressed states have version FEBioPlotFile::PLT_VERSION_BLOCKS.
+	// The format is described in Documentation/FEBioBinaryDatabaseSpecification.
+	enum {
+		COMPRESS_NONE			= 0,	// no compression
+		COMPRESS_STREAM			= 1,	// each root chunk is one deflate stream
+		COMPRESS_BLOCKS			= 2,	// block compression
+		COMPRESS_BLOCKS_SHUFFLE	= 3		// block compression with shuffle filter
+	};
+
+	enum { BLOCK_CHUNK_ID = 0x03000000 };
+	enum { BLOCK_FILTER_NONE = 0, BLOCK_FILTER_SHUFFLE = 1 };
+	enum { BLOCK_SIZE = 1048576 };
+
+	// decode the data of a block chunk (i.e. without the chunk header)
+	// Only the nlen bytes starting at noff (in the uncompressed data) are returned,
+	// and only the blocks that contain these bytes are decompressed.
+	// Returns false if the data cannot be decoded.
+	static bool DecodeBlocks(const unsigned char* pd, size_t nsize, std::vector<unsigned char>& out, size_t noff = 0, size_t nlen = (size_t)-1);
+
+protected:
+	// The chunks are streamed as they are written. A chunk header is written 
+	// with a zero size, which is patched when the chunk is closed. A root chunk
+	// is written directly to the file, unless it needs to be compressed or 
+	// written on the background thread. In that case it is collected in a 
+	// memory buffer first.
+	typedef std::vector<unsigned char>	Buffer;
+
+	void WriteLeaf(unsigned int nid, const void* pd, size_t nsize);
+	void write(const void* pd, size_t nsize);
+	size_t position() const;
+	void patch(size_t pos, unsigned int n);
+
+	Buffer* NewBuffer();
+	void ReleaseBuffer(Buffer* buf);
+
+	// a root chunk that is waiting to be written
+	struct PENDING
+	{
+		Buffer*			buf;		// the chunk data
+		int				ncompress;	// compression level for this chunk
+		unsigned int	id;			// chunk ID
+	};
+
+	void WriteRoot(PENDING& p);
+	void WriteBlocks(Buffer& buf, int filter);
+
+	void WriterThread();
+	void StopWriter();
+
 protected:
 	FileStream*	m_fp;		// pointer to file stream
 	bool		m_bSaving;	// read or write mode?
+	int			m_ncompress;	// compression level of next root chunk
 
 	// write data
-	OBranch*	m_pRoot;	// chunk tree root
-	OBranch*	m_pChunk;	// current chunk
+	std::vector<size_t>		m_open;		// positions of the size fields of the open chunks
+	Buffer*					m_pbuf;		// buffer of the current root chunk (null when writing directly to file)
+	std::vector<Buffer*>	m_free;		// buffers that can be reused
+	unsigned int			m_rootId;	// ID of the current root chunk
+	size_t					m_rootStart;	// position() at the start of the current root chunk
+	std::vector<ROOT_CHUNK>	m_roots;	// root chunks written so far (protected by m_mtx)
+
+	// background writer
+	int						m_nqueue;	// max nr of pending root chunks (0 = synchronous)
+	std::thread*			m_writer;	// the writer thread
+	std::mutex				m_mtx;		// protects the queue
+	std::condition_variable	m_cv;		// signals changes to the queue
+	std::deque<PENDING>		m_queue;	// root chunks waiting to be written
+	bool					m_bstop;	// tells the writer to stop
 
 	// read data
 	bool			m_bend;		// chunk end flag
@@ -0,0 +1,590 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "PltReader.h"
+#include "PltArchive.h"
+#include <string.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_ZLIB
+#include "zlib.h"
+#endif
+
+typedef FEBioPlotFile PLT;
+
+//-----------------------------------------------------------------------------
+// Reads the header of the chunk at position pos. Returns false if the chunk
+// does not fit in the data.
+static bool getChunk(const unsigned char* pd, size_t nsize, size_t pos, unsigned int& id, size_t& n)
+{
+	if (pos + 2*sizeof(unsigned int) > nsize) return false;
+	unsigned int m;
+	memcpy(&id, pd + pos, sizeof(unsigned int));
+	memcpy(&m , pd + pos + sizeof(unsigned int), sizeof(unsigned int));
+	n = m;
+	return (pos + 2*sizeof(unsigned int) + n <= nsize);
+}
+
+//-----------------------------------------------------------------------------
+// Decompresses a zlib stream until nmax bytes are decoded or the stream ends.
+// nused returns the number of compressed bytes that were read.
+static bool inflateStream(const unsigned char* src, size_t nsrc, size_t nmax, std::vector<unsigned char>& out, size_t& nused)
+{
+	out.clear();
+	nused = 0;
+#ifdef HAVE_ZLIB
+	z_stream strm;
+	memset(&strm, 0, sizeof(strm));
+	if (inflateInit(&strm) != Z_OK) return false;
+
+	const size_t nchunk = 262144;
+	size_t nin = 0;
+	int ret = Z_OK;
+	while ((ret == Z_OK) && (out.size() < nmax))
+	{
+		// (avail_in is only 32 bits)
+		if (strm.avail_in == 0)
+		{
+			size_t n = nsrc - nin;
+			if (n > nchunk) n = nchunk;
+			if (n == 0) break;
+			strm.next_in = (Bytef*)(src + nin);
+			strm.avail_in = (uInt) n;
+			nin += n;
+		}
+
+		size_t n0 = out.size();
+		out.resize(n0 + nchunk);
+		strm.next_out = &out[n0];
+		strm.avail_out = (uInt) nchunk;
+		ret = inflate(&strm, Z_NO_FLUSH);
+		out.resize(n0 + nchunk - strm.avail_out);
+	}
+	nused = nin - strm.avail_in;
+	inflateEnd(&strm);
+	return ((ret == Z_STREAM_END) || (out.size() >= nmax));
+#else
+	return false;
+#endif
+}
+
+//=============================================================================
+PltReader::PltReader()
+{
+	m_pd = nullptr;
+	m_nsize = 0;
+	m_hfile = nullptr;
+	m_hmap = nullptr;
+
+	m_nversion = 0;
+	m_ncompress = 0;
+	m_bindex = false;
+	m_indexPos = 0;
+}
+
+PltReader::~PltReader()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+bool PltReader::Open(const char* szfile)
+{
+	Close();
+	if (Map(szfile) == false) return false;
+
+	// check the file tag
+	unsigned int ntag = 0;
+	if (m_nsize >= sizeof(unsigned int)) memcpy(&ntag, m_pd, sizeof(unsigned int));
+	if (ntag != 0x00464542) { Close(); return false; }
+
+	// read the header and dictionary
+	if (ReadRoot() == false) { Close(); return false; }
+
+	// read the index, or build it if the file doesn't have one
+	m_bindex = ReadIndex();
+	if (m_bindex == false)
+	{
+		m_index.clear();
+		m_indexPos = m_nsize;
+		if (ScanStates() == false) { Close(); return false; }
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void PltReader::Close()
+{
+	Unmap();
+	m_nversion = 0;
+	m_ncompress = 0;
+	m_var.clear();
+	m_bindex = false;
+	m_indexPos = 0;
+	m_index.clear();
+}
+
+//-----------------------------------------------------------------------------
+int PltReader::FindVariable(const char* szname) const
+{
+	for (size_t i = 0; i < m_var.size(); ++i)
+	{
+		if (m_var[i].name == szname) return (int)i;
+	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+// The root chunk is never compressed.
+bool PltReader::ReadRoot()
+{
+	const size_t n0 = sizeof(unsigned int);
+	unsigned int id; size_t nroot;
+	if ((getChunk(m_pd, m_nsize, n0, id, nroot) == false) || (id != PLT::PLT_ROOT)) return false;
+
+	const unsigned char* pd = m_pd + n0 + 8;
+	bool bdic = false;
+	size_t nc;
+	for (size_t pos = 0; getChunk(pd, nroot, pos, id, nc); pos += 8 + nc)
+	{
+		const unsigned char* pc = pd + pos + 8;
+		if (id == PLT::PLT_HEADER)
+		{
+			unsigned int lid; size_t nl;
+			for (size_t l = 0; getChunk(pc, nc, l, lid, nl); l += 8 + nl)
+			{
+				if      ((lid == PLT::PLT_HDR_VERSION    ) && (nl == 4)) memcpy(&m_nversion , pc + l + 8, 4);
+				else if ((lid == PLT::PLT_HDR_COMPRESSION) && (nl == 4)) memcpy(&m_ncompress, pc + l + 8, 4);
+			}
+
+			// don't read files of a newer version
+			if (m_nversion > PLT::PLT_VERSION_BLOCKS) return false;
+		}
+		else if (id == PLT::PLT_DICTIONARY)
+		{
+			bdic = ReadDictionary(pc, nc);
+		}
+	}
+
+	return bdic;
+}
+
+//-----------------------------------------------------------------------------
+bool PltReader::ReadDictionary(const unsigned char* pd, size_t nsize)
+{
+	m_var.clear();
+	unsigned int id; size_t n;
+	for (size_t pos = 0; getChunk(pd, nsize, pos, id, n); pos += 8 + n)
+	{
+		int region = -1;
+		switch (id)
+		{
+		case PLT::PLT_DIC_NODAL  : region = NODE_DATA; break;
+		case PLT::PLT_DIC_DOMAIN : region = DOMAIN_DATA; break;
+		case PLT::PLT_DIC_SURFACE: region = SURFACE_DATA; break;
+		default:
+			// global variables are not stored in the states
+			continue;
+		}
+
+		const unsigned char* pl = pd + pos + 8;
+		unsigned int iid; size_t ni;
+		for (size_t i = 0; getChunk(pl, n, i, iid, ni); i += 8 + ni)
+		{
+			if (iid != PLT::PLT_DIC_ITEM) return false;
+
+			VARIABLE var;
+			var.region = region;
+			var.type = 0;
+			var.fmt = 0;
+			var.arraySize = 0;
+
+			const unsigned char* pi = pl + i + 8;
+			unsigned int lid; size_t nl;
+			for (size_t l = 0; getChunk(pi, ni, l, lid, nl); l += 8 + nl)
+			{
+				const unsigned char* pv = pi + l + 8;
+				switch (lid)
+				{
+				case PLT::PLT_DIC_ITEM_TYPE     : if (nl == 4) memcpy(&var.type     , pv, 4); break;
+				case PLT::PLT_DIC_ITEM_FMT      : if (nl == 4) memcpy(&var.fmt      , pv, 4); break;
+				case PLT::PLT_DIC_ITEM_ARRAYSIZE: if (nl == 4) memcpy(&var.arraySize, pv, 4); break;
+				case PLT::PLT_DIC_ITEM_NAME:
+					{
+						size_t m = 0;
+						while ((m < nl) && pv[m]) m++;
+						var.name.assign((const char*)pv, m);
+					}
+					break;
+				}
+			}
+			m_var.push_back(var);
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The last chunk of the file contains the position of the index chunk.
+bool PltReader::ReadIndex()
+{
+	const size_t ntail = 8 + sizeof(unsigned long long);
+	if (m_nsize < sizeof(unsigned int) + ntail) return false;
+
+	unsigned int id; size_t n;
+	if ((getChunk(m_pd, m_nsize, m_nsize - ntail, id, n) == false) || (id != PLT::PLT_INDEX_POS) || (n != sizeof(unsigned long long))) return false;
+	unsigned long long ipos;
+	memcpy(&ipos, m_pd + m_nsize - sizeof(unsigned long long), sizeof(unsigned long long));
+
+	size_t nindex;
+	if ((getChunk(m_pd, m_nsize, (size_t)ipos, id, nindex) == false) || (id != PLT::PLT_STATE_INDEX)) return false;
+	if ((size_t)ipos + 8 + nindex != m_nsize) return false;
+
+	const unsigned char* pd = m_pd + (size_t)ipos + 8;
+	unsigned int nvar = 0;
+	const unsigned char* ppos = nullptr; size_t npos = 0;
+	const unsigned char* pfmt = nullptr; size_t nfmt = 0;
+	const unsigned char* ptim = nullptr; size_t ntim = 0;
+	const unsigned char* pvar = nullptr; size_t nvp = 0;
+	for (size_t pos = 0; getChunk(pd, nindex, pos, id, n); pos += 8 + n)
+	{
+		const unsigned char* pc = pd + pos + 8;
+		switch (id)
+		{
+		case PLT::PLT_INDEX_VARIABLES : if (n == 4) memcpy(&nvar, pc, 4); break;
+		case PLT::PLT_INDEX_STATE_POS : ppos = pc; npos = n; break;
+		case PLT::PLT_INDEX_STATE_FMT : pfmt = pc; nfmt = n; break;
+		case PLT::PLT_INDEX_STATE_TIME: ptim = pc; ntim = n; break;
+		case PLT::PLT_INDEX_VAR_POS   : pvar = pc; nvp  = n; break;
+		}
+	}
+	if (nvar != (unsigned int)m_var.size()) return false;
+
+	size_t ns = npos / sizeof(unsigned long long);
+	if ((nfmt != ns*sizeof(unsigned int)) || (ntim != ns*sizeof(float)) || (nvp != ns*nvar*sizeof(unsigned int))) return false;
+
+	m_index.resize(ns);
+	for (size_t i = 0; i < ns; ++i)
+	{
+		PLT::STATE_INDEX& si = m_index[i];
+		memcpy(&si.pos      , ppos + i*sizeof(unsigned long long), sizeof(unsigned long long));
+		memcpy(&si.ncompress, pfmt + i*sizeof(unsigned int), sizeof(unsigned int));
+		memcpy(&si.time     , ptim + i*sizeof(float), sizeof(float));
+		si.varPos.resize(nvar);
+		if (nvar > 0) memcpy(&si.varPos[0], pvar + i*nvar*sizeof(unsigned int), nvar*sizeof(unsigned int));
+	}
+	m_indexPos = (size_t)ipos;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Walk over all root chunks to find the states. Compressed chunks need to be
+// decompressed to see what they are, so this can take a while for large files.
+bool PltReader::ScanStates()
+{
+	std::vector<unsigned char> buf;
+	size_t pos = sizeof(unsigned int);
+	while (pos < m_nsize)
+	{
+		unsigned int id; size_t n;
+		bool braw = getChunk(m_pd, m_nsize, pos, id, n) &&
+			((id == PLT::PLT_ROOT) || (id == PLT::PLT_MESH) || (id == PLT::PLT_STATE) || (id == PltArchive::BLOCK_CHUNK_ID) || (id == PLT::PLT_STATE_INDEX));
+
+		if (braw)
+		{
+			PLT::STATE_INDEX si;
+			si.pos = pos;
+			si.ncompress = PltArchive::COMPRESS_NONE;
+			if (id == PLT::PLT_STATE)
+			{
+				if (ReadState(m_pd + pos, 8 + n, si) == false) return false;
+				m_index.push_back(si);
+			}
+			else if (id == PltArchive::BLOCK_CHUNK_ID)
+			{
+				unsigned int filter = 0;
+				if (n >= sizeof(unsigned int)) memcpy(&filter, m_pd + pos + 8, sizeof(unsigned int));
+				si.ncompress = (filter == PltArchive::BLOCK_FILTER_SHUFFLE ? PltArchive::COMPRESS_BLOCKS_SHUFFLE : PltArchive::COMPRESS_BLOCKS);
+				if (PltArchive::DecodeBlocks(m_pd + pos + 8, n, buf) == false) return false;
+				unsigned int cid; size_t nc;
+				if (getChunk(&buf[0], buf.size(), 0, cid, nc) && (cid == PLT::PLT_STATE))
+				{
+					if (ReadState(&buf[0], buf.size(), si) == false) return false;
+					m_index.push_back(si);
+				}
+			}
+			pos += 8 + n;
+		}
+		else
+		{
+			// this must be a stream-compressed chunk
+			size_t nused = 0;
+			if ((inflateStream(m_pd + pos, m_nsize - pos, (size_t)-1, buf, nused) == false) || (nused == 0)) return false;
+			unsigned int cid; size_t nc;
+			if (getChunk(&buf[0], buf.size(), 0, cid, nc) && (cid == PLT::PLT_STATE))
+			{
+				PLT::STATE_INDEX si;
+				si.pos = pos;
+				si.ncompress = PltArchive::COMPRESS_STREAM;
+				if (ReadState(&buf[0], buf.size(), si) == false) return false;
+				m_index.push_back(si);
+			}
+			pos += nused;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Finds the time and the positions of the variables of a state. pd points to
+// the (uncompressed) state chunk.
+bool PltReader::ReadState(const unsigned char* pd, size_t nsize, FEBioPlotFile::STATE_INDEX& si)
+{
+	unsigned int id; size_t n;
+	if ((getChunk(pd, nsize, 0, id, n) == false) || (id != PLT::PLT_STATE)) return false;
+
+	// the first variable of each region
+	int nbase[3] = { 0, 0, 0 };
+	for (int i = (int)m_var.size() - 1; i >= 0; --i) nbase[m_var[i].region] = i;
+
+	si.time = 0.f;
+	si.varPos.assign(m_var.size(), 0);
+	for (size_t pos = 8; getChunk(pd, 8 + n, pos, id, nsize); pos += 8 + nsize)
+	{
+		const unsigned char* pc = pd + pos + 8;
+		if (id == PLT::PLT_STATE_HEADER)
+		{
+			unsigned int lid; size_t nl;
+			for (size_t l = 0; getChunk(pc, nsize, l, lid, nl); l += 8 + nl)
+			{
+				if ((lid == PLT::PLT_STATE_HDR_TIME) && (nl == sizeof(float))) memcpy(&si.time, pc + l + 8, sizeof(float));
+			}
+		}
+		else if (id == PLT::PLT_STATE_DATA)
+		{
+			unsigned int rid; size_t nr;
+			for (size_t r = 0; getChunk(pc, nsize, r, rid, nr); r += 8 + nr)
+			{
+				int region = -1;
+				switch (rid)
+				{
+				case PLT::PLT_NODE_DATA   : region = NODE_DATA; break;
+				case PLT::PLT_ELEMENT_DATA: region = DOMAIN_DATA; break;
+				case PLT::PLT_FACE_DATA   : region = SURFACE_DATA; break;
+				default:
+					continue;
+				}
+
+				const unsigned char* pr = pc + r + 8;
+				unsigned int vid; size_t nv;
+				for (size_t v = 0; getChunk(pr, nr, v, vid, nv); v += 8 + nv)
+				{
+					if (vid != PLT::PLT_STATE_VARIABLE) continue;
+
+					// the variable ID is the first chunk
+					unsigned int lid; size_t nl;
+					unsigned int nid = 0;
+					if (getChunk(pr + v + 8, nv, 0, lid, nl) && (lid == PLT::PLT_STATE_VAR_ID) && (nl == 4)) memcpy(&nid, pr + v + 16, 4);
+
+					int nvar = nbase[region] + (int)nid - 1;
+					if ((nid == 0) || (nvar >= (int)m_var.size()) || (m_var[nvar].region != region)) return false;
+					si.varPos[nvar] = (unsigned int)((pr + v) - pd);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+const unsigned char* PltReader::GetStateBytes(int nstate, size_t noff, size_t nlen, std::vector<unsigned char>& buf)
+{
+	const PLT::STATE_INDEX& si = m_index[nstate];
+	size_t pos = (size_t)si.pos;
+	unsigned int id; size_t n;
+	switch (si.ncompress)
+	{
+	case PltArchive::COMPRESS_NONE:
+		if ((getChunk(m_pd, m_nsize, pos, id, n) == false) || (id != PLT::PLT_STATE)) return nullptr;
+		if (noff + nlen > 8 + n) return nullptr;
+		return m_pd + pos + noff;
+	case PltArchive::COMPRESS_STREAM:
+		{
+			size_t nused;
+			if (pos >= m_nsize) return nullptr;
+			inflateStream(m_pd + pos, m_nsize - pos, noff + nlen, buf, nused);
+			if (buf.size() < noff + nlen) return nullptr;
+			return &buf[noff];
+		}
+	case PltArchive::COMPRESS_BLOCKS:
+	case PltArchive::COMPRESS_BLOCKS_SHUFFLE:
+		if ((getChunk(m_pd, m_nsize, pos, id, n) == false) || (id != PltArchive::BLOCK_CHUNK_ID)) return nullptr;
+		if (PltArchive::DecodeBlocks(m_pd + pos + 8, n, buf, noff, nlen) == false) return nullptr;
+		if (buf.size() != nlen) return nullptr;
+		return (nlen > 0 ? &buf[0] : nullptr);
+	}
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+bool PltReader::GetStateData(int nstate, int nvar, std::vector<REGION_DATA>& data)
+{
+	data.clear();
+	if ((nstate < 0) || (nstate >= States())) return false;
+	if ((nvar < 0) || (nvar >= Variables())) return false;
+
+	size_t pos = m_index[nstate].varPos[nvar];
+	if (pos == 0) return false;
+
+	// read the chunk header first, to find out how much we need
+	std::vector<unsigned char> buf;
+	const unsigned char* ph = GetStateBytes(nstate, pos, 8, buf);
+	if (ph == nullptr) return false;
+	unsigned int id, nsize;
+	memcpy(&id   , ph, sizeof(unsigned int));
+	memcpy(&nsize, ph + sizeof(unsigned int), sizeof(unsigned int));
+	if (id != PLT::PLT_STATE_VARIABLE) return false;
+
+	const unsigned char* pd = GetStateBytes(nstate, pos + 8, nsize, buf);
+	if (pd == nullptr) return false;
+
+	size_t n;
+	for (size_t l = 0; getChunk(pd, nsize, l, id, n); l += 8 + n)
+	{
+		if (id != PLT::PLT_STATE_VAR_DATA) continue;
+
+		// each region is a chunk with the region ID as chunk ID
+		const unsigned char* pr = pd + l + 8;
+		unsigned int rid; size_t nr;
+		for (size_t r = 0; getChunk(pr, n, r, rid, nr); r += 8 + nr)
+		{
+			REGION_DATA rd;
+			rd.id = (int)rid;
+			rd.data.resize(nr / sizeof(float));
+			if (rd.data.empty() == false) memcpy(&rd.data[0], pr + r + 8, rd.data.size()*sizeof(float));
+			data.push_back(rd);
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool PltReader::GetTimeSeries(int nvar, int nregion, size_t noff, size_t ncount, std::vector<float>& data)
+{
+	int ns = States();
+	data.assign(ns*ncount, 0.f);
+
+	// the states are independent, so they can be read in parallel
+	int nerr = 0;
+	#pragma omp parallel for schedule(dynamic) reduction(+:nerr)
+	for (int i = 0; i < ns; ++i)
+	{
+		std::vector<REGION_DATA> d;
+		if (GetStateData(i, nvar, d) == false) { nerr++; continue; }
+
+		bool bfound = false;
+		for (size_t j = 0; j < d.size(); ++j)
+		{
+			if ((d[j].id == nregion) && (noff + ncount <= d[j].data.size()))
+			{
+				if (ncount > 0) memcpy(&data[i*ncount], &d[j].data[noff], ncount*sizeof(float));
+				bfound = true;
+				break;
+			}
+		}
+		if (bfound == false) nerr++;
+	}
+
+	return (nerr == 0);
+}
+
+//-----------------------------------------------------------------------------
+bool PltReader::Map(const char* szfile)
+{
+#ifdef WIN32
+	HANDLE hf = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hf == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER size;
+	if ((GetFileSizeEx(hf, &size) == FALSE) || (size.QuadPart == 0)) { CloseHandle(hf); return false; }
+
+	HANDLE hm = CreateFileMappingA(hf, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hm == NULL) { CloseHandle(hf); return false; }
+
+	void* pv = MapViewOfFile(hm, FILE_MAP_READ, 0, 0, 0);
+	if (pv == NULL) { CloseHandle(hm); CloseHandle(hf); return false; }
+
+	m_hfile = hf;
+	m_hmap = hm;
+	m_pd = (const unsigned char*)pv;
+	m_nsize = (size_t)size.QuadPart;
+#else
+	int fd = open(szfile, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0)) { close(fd); return false; }
+
+	void* pv = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (pv == MAP_FAILED) return false;
+
+	m_pd = (const unsigned char*)pv;
+	m_nsize = (size_t)st.st_size;
+#endif
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void PltReader::Unmap()
+{
+	if (m_pd == nullptr) return;
+#ifdef WIN32
+	UnmapViewOfFile(m_pd);
+	CloseHandle((HANDLE)m_hmap);
+	CloseHandle((HANDLE)m_hfile);
+	m_hmap = nullptr;
+	m_hfile = nullptr;
+#else
+	munmap((void*)m_pd, m_nsize);
+#endif
+	m_pd = nullptr;
+	m_nsize = 0;
+}
@@ -0,0 +1,134 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "FEBioPlotFile.h"
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Random access reader for plot files. The file is memory-mapped and the
+//! states and variables are found with the state index at the end of the file.
+//! Files without an index are scanned once when they are opened.
+//! Only the data of the requested variable is decoded, although for states that
+//! were written with stream compression (level 1), the state has to be
+//! decompressed up to the variable.
+class PltReader
+{
+public:
+	// regions a variable can be defined on
+	enum { NODE_DATA, DOMAIN_DATA, SURFACE_DATA };
+
+	// dictionary entry
+	struct VARIABLE
+	{
+		std::string		name;
+		int				region;		// NODE_DATA, DOMAIN_DATA, or SURFACE_DATA
+		unsigned int	type;		// data type (see Var_Type)
+		unsigned int	fmt;		// storage format (see Storage_Fmt)
+		unsigned int	arraySize;	// size of arrays (only used by arrays)
+	};
+
+	// the data of a variable on one region (i.e. mesh, domain, or surface)
+	struct REGION_DATA
+	{
+		int					id;		// region ID
+		std::vector<float>	data;
+	};
+
+public:
+	PltReader();
+	~PltReader();
+
+	// open a plot file
+	bool Open(const char* szfile);
+
+	// close the file
+	void Close();
+
+	unsigned int Version() const { return m_nversion; }
+	unsigned int Compression() const { return m_ncompress; }
+
+public:
+	// --- Dictionary ---
+	int Variables() const { return (int)m_var.size(); }
+	const VARIABLE& GetVariable(int n) const { return m_var[n]; }
+
+	// returns -1 if the variable is not found
+	int FindVariable(const char* szname) const;
+
+public:
+	// --- States ---
+	int States() const { return (int)m_index.size(); }
+	float StateTime(int n) const { return m_index[n].time; }
+
+	// get the data of variable nvar at state nstate (one entry for each region)
+	bool GetStateData(int nstate, int nvar, std::vector<REGION_DATA>& data);
+
+	// get ncount values (starting at value noff) of variable nvar in region nregion
+	// for all states. The values of a state follow each other in data.
+	bool GetTimeSeries(int nvar, int nregion, size_t noff, size_t ncount, std::vector<float>& data);
+
+public:
+	// --- Index ---
+
+	// was the index read from the file? (Otherwise it was built by scanning the file.)
+	bool HasIndex() const { return m_bindex; }
+
+	// file position of the index chunk
+	size_t IndexPosition() const { return m_indexPos; }
+
+	const std::vector<FEBioPlotFile::STATE_INDEX>& GetStateIndex() const { return m_index; }
+
+protected:
+	bool ReadRoot();
+	bool ReadDictionary(const unsigned char* pd, size_t nsize);
+	bool ReadIndex();
+	bool ScanStates();
+	bool ReadState(const unsigned char* pd, size_t nsize, FEBioPlotFile::STATE_INDEX& si);
+
+	// get nlen bytes at offset noff of state nstate (uncompressed)
+	const unsigned char* GetStateBytes(int nstate, size_t noff, size_t nlen, std::vector<unsigned char>& buf);
+
+	bool Map(const char* szfile);
+	void Unmap();
+
+protected:
+	const unsigned char*	m_pd;		// the mapped file
+	size_t					m_nsize;	// file size
+	void*					m_hfile;	// file handle (only used on Windows)
+	void*					m_hmap;		// mapping handle (only used on Windows)
+
+	unsigned int	m_nversion;
+	unsigned int	m_ncompress;
+	std::vector<VARIABLE>	m_var;
+
+	bool	m_bindex;
+	size_t	m_indexPos;
+	std::vector<FEBioPlotFile::STATE_INDEX>	m_index;
+};
@@ -44,6 +44,8 @@ class FEModel;
 class FEBModel
 {
 public:
+	// NOTE: NODE, ELEMENT and FACET are stored as raw data in the mesh cache
+	// (see FEBioMeshCache). Bump its CACHE_VERSION when their layout changes.
 	struct NODE
 	{
 		int		id;	// Nodal ID
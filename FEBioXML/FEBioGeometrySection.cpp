@@ -1243,8 +1243,8 @@ void FEBioGeometrySection25::ParsePartNodeSection(XMLTag& tag, FEBModel::Part* p
 	int N0 = mesh.Nodes();
 
 	// first we need to figure out how many nodes there are
-	XMLTag t(tag);
-	int nodes = tag.children();
+	XMLLeafReader leaves(tag);
+	int nodes = leaves.Leaves();
 
 	// see if this list defines a set
 	const char* szname = tag.AttributeValue("name", true);
@@ -1259,20 +1259,15 @@ void FEBioGeometrySection25::ParsePartNodeSection(XMLTag& tag, FEBModel::Part* p
 	vector<FEBModel::NODE> node(nodes);
 	vector<int> nodeList(nodes);
 
-	// read nodal coordinates
-	++tag;
-	for (int i = 0; i<nodes; ++i)
-	{
+	// read nodal coordinates (in parallel)
+	leaves.Read([&](XMLTag& leaf, int i) {
 		FEBModel::NODE& nd = node[i];
-		value(tag, nd.r);
+		value(leaf, nd.r);
 
 		// get the nodal ID
-		tag.AttributeValue("id", nd.id);
+		leaf.AttributeValue("id", nd.id);
 		nodeList[i] = nd.id;
-
-		// go on to the next node
-		++tag;
-	}
+	});
 
 	// add nodes to the part
 	part->AddNodes(node);
@@ -1425,7 +1420,8 @@ void FEBioGeometrySection25::ParsePartElementSection(XMLTag& tag, FEBModel::Part
 	if (szmat) dom->SetMaterialName(szmat);
 
 	// count elements
-	int elems = tag.children();
+	XMLLeafReader leaves(tag);
+	int elems = leaves.Leaves();
 	assert(elems);
 
 	// add domain it to the mesh
@@ -1442,24 +1438,19 @@ void FEBioGeometrySection25::ParsePartElementSection(XMLTag& tag, FEBModel::Part
 
 	vector<int> elemList(elems);
 
-	// read element data
-	++tag;
-	for (int i = 0; i<elems; ++i)
-	{
-		if ((tag == "elem") == false) throw XMLReader::InvalidTag(tag);
+	// read element data (in parallel)
+	leaves.Read([&](XMLTag& leaf, int i) {
+		if ((leaf == "elem") == false) throw XMLReader::InvalidTag(leaf);
 
 		FEBModel::ELEMENT& el = dom->GetElement(i);
 
 		// get the element ID
-		tag.AttributeValue("id", el.id);
+		leaf.AttributeValue("id", el.id);
 		elemList[i] = el.id;
 
 		// read the element data
-		tag.value(el.node, FEElement::MAX_NODES);
-
-		// go to next tag
-		++tag;
-	}
+		leaf.value(el.node, FEElement::MAX_NODES);
+	});
 
 	// set the element list
 	if (pg) pg->SetElementList(elemList);
@@ -152,18 +152,22 @@ FEBioImport::PlotVariable::PlotVariable(const FEBioImport::PlotVariable& pv)
 	strcpy(m_szvar, pv.m_szvar);
     strcpy(m_szdom, pv.m_szdom);
 	m_item = pv.m_item;
+	m_tol = pv.m_tol;
 }
 
-FEBioImport::PlotVariable::PlotVariable(const std::string& var, vector<int>& item, const char* szdom)
+FEBioImport::PlotVariable::PlotVariable(const std::string& var, vector<int>& item, const char* szdom, double tol)
 {
     strcpy(m_szvar, var.c_str());
     m_item = item;
     strcpy(m_szdom, szdom);
+	m_tol = tol;
 }
 
 //-----------------------------------------------------------------------------
 FEBioImport::FEBioImport()
 {
+	m_bmeshCache = false;
+	m_szcache[0] = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -269,10 +273,15 @@ bool FEBioImport::Load(FEModel& fem, const char* szfile)
 	m_szlog[0] = 0;
 	m_szplt[0] = 0;
 
+	// mesh cache
+	if (m_bmeshCache) sprintf(m_szcache, "%s.cache", szfile); else m_szcache[0] = 0;
+
 	// plot output
 	m_szplot_type[0] = 0;
 	m_plot.clear();
 	m_nplot_compression = 0;
+	m_nplot_async = 0;
+	m_bplot_index = false;
 
 	m_data.clear();
 
@@ -468,6 +477,12 @@ void FEBioImport::SetDumpfileName(const char* sz) { sprintf(m_szdmp, "%s", sz);
 void FEBioImport::SetLogfileName (const char* sz) { sprintf(m_szlog, "%s", sz); }
 void FEBioImport::SetPlotfileName(const char* sz) { sprintf(m_szplt, "%s", sz); }
 
+//-----------------------------------------------------------------------------
+void FEBioImport::SetMeshCache(bool b) { m_bmeshCache = b; }
+
+//-----------------------------------------------------------------------------
+const char* FEBioImport::MeshCacheFile() const { return (m_szcache[0] ? m_szcache : 0); }
+
 //-----------------------------------------------------------------------------
 void FEBioImport::AddDataRecord(DataRecord* pd)
 {
@@ -475,9 +490,9 @@ void FEBioImport::AddDataRecord(DataRecord* pd)
 }
 
 //-----------------------------------------------------------------------------
-void FEBioImport::AddPlotVariable(const char* szvar, vector<int>& item, const char* szdom)
+void FEBioImport::AddPlotVariable(const char* szvar, vector<int>& item, const char* szdom, double tol)
 {
-    PlotVariable var(szvar, item, szdom);
+    PlotVariable var(szvar, item, szdom, tol);
     m_plot.push_back(var);
 }
 
@@ -487,6 +502,18 @@ void FEBioImport::SetPlotCompression(int n)
 	m_nplot_compression = n;
 }
 
+//-----------------------------------------------------------------------------
+void FEBioImport::SetPlotAsync(int n)
+{
+	m_nplot_async = n;
+}
+
+//-----------------------------------------------------------------------------
+void FEBioImport::SetPlotIndex(bool b)
+{
+	m_bplot_index = b;
+}
+
 //-----------------------------------------------------------------------------
 // This tag parses a node set.
 FENodeSet* FEBioImport::ParseNodeSet(XMLTag& tag, const char* szatt)
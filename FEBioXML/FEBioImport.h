@@ -145,12 +145,13 @@ public:
 	{
 	public:
 		PlotVariable(const PlotVariable& pv);
-        PlotVariable(const std::string& var, vector<int>& item, const char* szdom = "");
+        PlotVariable(const std::string& var, vector<int>& item, const char* szdom = "", double tol = 0.0);
         
 	public:
 		char		m_szvar[128];	//!< name of output variable
         char        m_szdom[128];    //!< (optional) name of domain
 		vector<int>	m_item;			//!< (optional) list of items
+		double		m_tol;			//!< (optional) quantization tolerance (0 = lossless)
 	};
 
 public:
@@ -171,9 +172,20 @@ public:
 	void SetLogfileName (const char* sz);
 	void SetPlotfileName(const char* sz);
 
-    void AddPlotVariable(const char* szvar, vector<int>& item, const char* szdom = "");
+    void AddPlotVariable(const char* szvar, vector<int>& item, const char* szdom = "", double tol = 0.0);
 
 	void SetPlotCompression(int n);
+
+	void SetPlotAsync(int n);
+
+	void SetPlotIndex(bool b);
+
+	// Use a binary cache for the mesh (only used by 3.0 files). The cache is stored
+	// next to the input file, with ".cache" appended to the file name.
+	void SetMeshCache(bool b);
+
+	// returns the name of the mesh cache, or null if the cache is not used
+	const char* MeshCacheFile() const;
     
 	void AddDataRecord(DataRecord* pd);
 
@@ -191,11 +203,17 @@ public:
 	char	m_szdmp[512];
 	char	m_szlog[512];
 	char	m_szplt[512];
+	char	m_szcache[512];
 
 public:
 	char					m_szplot_type[256];
 	vector<PlotVariable>	m_plot;
 	int						m_nplot_compression;
+	int						m_nplot_async;
+	bool					m_bplot_index;
 
 	vector<DataRecord*>		m_data;
+
+protected:
+	bool	m_bmeshCache;
 };
@@ -0,0 +1,331 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEBioMeshCache.h"
+#include "FEModelBuilder.h"
+#include <stdio.h>
+#include <string.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// helper class for writing and reading the cache file
+class CacheFile
+{
+public:
+	CacheFile(FILE* fp) : m_fp(fp), m_bok(fp != nullptr) {}
+	~CacheFile() { if (m_fp) fclose(m_fp); }
+
+	bool ok() const { return m_bok; }
+
+	template <class T> void write(const T& v) { write(&v, sizeof(T)); }
+	template <class T> void write(const vector<T>& v)
+	{
+		unsigned int n = (unsigned int)v.size();
+		write(n);
+		if (n) write(&v[0], n*sizeof(T));
+	}
+	void write(const string& s)
+	{
+		unsigned int n = (unsigned int)s.size();
+		write(n);
+		if (n) write(s.c_str(), n);
+	}
+	void write(const void* pd, size_t nsize)
+	{
+		if (m_bok) m_bok = (fwrite(pd, 1, nsize, m_fp) == nsize);
+	}
+
+	template <class T> void read(T& v) { read(&v, sizeof(T)); }
+	template <class T> void read(vector<T>& v)
+	{
+		unsigned int n = 0;
+		read(n);
+		if (m_bok) v.resize(n);
+		if (m_bok && n) read(&v[0], n*sizeof(T));
+	}
+	void read(string& s)
+	{
+		unsigned int n = 0;
+		read(n);
+		if (m_bok) s.resize(n);
+		if (m_bok && n) read(&s[0], n);
+	}
+	void read(void* pd, size_t nsize)
+	{
+		if (m_bok) m_bok = (fread(pd, 1, nsize, m_fp) == nsize);
+	}
+
+	bool close()
+	{
+		if (m_fp && (fclose(m_fp) != 0)) m_bok = false;
+		m_fp = nullptr;
+		return m_bok;
+	}
+
+private:
+	FILE*	m_fp;
+	bool	m_bok;
+};
+
+//-----------------------------------------------------------------------------
+// FNV-1a hash, evaluated on 8-byte words
+unsigned long long FEBioMeshCache::Key(const char* pd, size_t nsize)
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long h = 14695981039346656037ULL;
+	size_t n8 = nsize / 8;
+	for (size_t i = 0; i < n8; ++i)
+	{
+		unsigned long long w;
+		memcpy(&w, pd + 8*i, 8);
+		h = (h ^ w)*prime;
+	}
+	for (size_t i = 8*n8; i < nsize; ++i) h = (h ^ (unsigned char)pd[i])*prime;
+	return (h ^ nsize);
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshCache::Write(const char* szfile, unsigned long long key, FEBModel::Part& part, const vector<string>& domType)
+{
+	// The cache is written to a temporary file which then replaces the old cache,
+	// so that a crash while writing, or another run reading the cache, never
+	// sees a partially written file.
+	string tmp = string(szfile) + ".tmp";
+	CacheFile ar(fopen(tmp.c_str(), "wb"));
+	if (ar.ok() == false) return false;
+
+	// header
+	// (the sizes of the structures are stored too, since the data is written as is)
+	// NOTE: Nodes, elements and facets are dumped as raw structs. The size check
+	// does not catch layout changes that keep the size (e.g. reordered members),
+	// so any change to FEBModel::NODE, ELEMENT or FACET must bump CACHE_VERSION.
+	unsigned int hdr[5] = { CACHE_TAG, CACHE_VERSION, sizeof(FEBModel::NODE), sizeof(FEBModel::ELEMENT), sizeof(FEBModel::FACET) };
+	ar.write(hdr, sizeof(hdr));
+	ar.write(key);
+
+	// nodes
+	vector<FEBModel::NODE> nodes(part.Nodes());
+	for (int i = 0; i < part.Nodes(); ++i) nodes[i] = part.GetNode(i);
+	ar.write(nodes);
+
+	// domains
+	ar.write(part.Domains());
+	for (int i = 0; i < part.Domains(); ++i)
+	{
+		const FEBModel::Domain& dom = part.GetDomain(i);
+		ar.write(domType[i]);
+		ar.write(dom.Name());
+		ar.write(dom.MaterialName());
+		ar.write(dom.m_defaultShellThickness);
+		ar.write(dom.ElementList());	// raw FEBModel::ELEMENT structs (see CACHE_VERSION)
+	}
+
+	// surfaces
+	ar.write(part.Surfaces());
+	for (int i = 0; i < part.Surfaces(); ++i)
+	{
+		FEBModel::Surface* surf = part.GetSurface(i);
+		ar.write(surf->Name());
+		ar.write(surf->FacetList());
+	}
+
+	// node sets
+	ar.write(part.NodeSets());
+	for (int i = 0; i < part.NodeSets(); ++i)
+	{
+		FEBModel::NodeSet* set = part.GetNodeSet(i);
+		ar.write(set->Name());
+		ar.write(set->NodeList());
+	}
+
+	// element sets
+	ar.write(part.ElementSets());
+	for (int i = 0; i < part.ElementSets(); ++i)
+	{
+		FEBModel::ElementSet* set = part.GetElementSet(i);
+		ar.write(set->Name());
+		ar.write(set->ElementList());
+	}
+
+	// surface pairs
+	ar.write(part.SurfacePairs());
+	for (int i = 0; i < part.SurfacePairs(); ++i)
+	{
+		FEBModel::SurfacePair* sp = part.GetSurfacePair(i);
+		ar.write(sp->m_name);
+		ar.write(sp->m_primary);
+		ar.write(sp->m_secondary);
+	}
+
+	// discrete sets
+	ar.write(part.DiscreteSets());
+	for (int i = 0; i < part.DiscreteSets(); ++i)
+	{
+		FEBModel::DiscreteSet* set = part.GetDiscreteSet(i);
+		ar.write(set->Name());
+		ar.write(set->ElementList());
+	}
+
+	// the end tag marks the file as complete
+	unsigned int nend = CACHE_END;
+	ar.write(nend);
+
+	if (ar.close() == false)
+	{
+		remove(tmp.c_str());
+		return false;
+	}
+#ifdef WIN32
+	remove(szfile);
+#endif
+	return (rename(tmp.c_str(), szfile) == 0);
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioMeshCache::Read(const char* szfile, unsigned long long key, FEBModel::Part& part, FEModelBuilder& builder)
+{
+	CacheFile ar(fopen(szfile, "rb"));
+	if (ar.ok() == false) return false;
+
+	// check the header
+	unsigned int hdr[5] = { 0 };
+	unsigned long long fileKey = 0;
+	ar.read(hdr, sizeof(hdr));
+	ar.read(fileKey);
+	if ((ar.ok() == false) || (hdr[0] != CACHE_TAG) || (hdr[1] != CACHE_VERSION) ||
+		(hdr[2] != sizeof(FEBModel::NODE)) || (hdr[3] != sizeof(FEBModel::ELEMENT)) || (hdr[4] != sizeof(FEBModel::FACET)) ||
+		(fileKey != key)) return false;
+
+	// nodes
+	vector<FEBModel::NODE> nodes;
+	ar.read(nodes);
+	if (ar.ok() == false) return false;
+	part.AddNodes(nodes);
+
+	// domains
+	int ndom = 0;
+	ar.read(ndom);
+	for (int i = 0; (i < ndom) && ar.ok(); ++i)
+	{
+		string type, name, matName;
+		double h0 = 0.0;
+		vector<FEBModel::ELEMENT> elems;
+		ar.read(type);
+		ar.read(name);
+		ar.read(matName);
+		ar.read(h0);
+		ar.read(elems);
+		if (ar.ok() == false) return false;
+
+		// The element spec can depend on settings outside the Mesh section,
+		// so it is not stored but obtained from the element type name.
+		FE_Element_Spec spec = builder.ElementSpec(type.c_str());
+		if (FEElementLibrary::IsValid(spec) == false) return false;
+
+		FEBModel::Domain* dom = new FEBModel::Domain(spec);
+		dom->SetName(name);
+		if (matName.empty() == false) dom->SetMaterialName(matName);
+		dom->m_defaultShellThickness = h0;
+		dom->SetElementList(elems);
+		part.AddDomain(dom);
+	}
+
+	// surfaces
+	int nsurf = 0;
+	ar.read(nsurf);
+	for (int i = 0; (i < nsurf) && ar.ok(); ++i)
+	{
+		string name;
+		vector<FEBModel::FACET> faces;
+		ar.read(name);
+		ar.read(faces);
+		FEBModel::Surface* surf = new FEBModel::Surface(name);
+		surf->SetFacetList(faces);
+		part.AddSurface(surf);
+	}
+
+	// node sets
+	int nset = 0;
+	ar.read(nset);
+	for (int i = 0; (i < nset) && ar.ok(); ++i)
+	{
+		string name;
+		vector<int> nodeList;
+		ar.read(name);
+		ar.read(nodeList);
+		FEBModel::NodeSet* set = new FEBModel::NodeSet(name);
+		set->SetNodeList(nodeList);
+		part.AddNodeSet(set);
+	}
+
+	// element sets
+	int eset = 0;
+	ar.read(eset);
+	for (int i = 0; (i < eset) && ar.ok(); ++i)
+	{
+		string name;
+		vector<int> elemList;
+		ar.read(name);
+		ar.read(elemList);
+		FEBModel::ElementSet* set = new FEBModel::ElementSet(name);
+		set->SetElementList(elemList);
+		part.AddElementSet(set);
+	}
+
+	// surface pairs
+	int npair = 0;
+	ar.read(npair);
+	for (int i = 0; (i < npair) && ar.ok(); ++i)
+	{
+		FEBModel::SurfacePair* sp = new FEBModel::SurfacePair;
+		ar.read(sp->m_name);
+		ar.read(sp->m_primary);
+		ar.read(sp->m_secondary);
+		part.AddSurfacePair(sp);
+	}
+
+	// discrete sets
+	int ndset = 0;
+	ar.read(ndset);
+	for (int i = 0; (i < ndset) && ar.ok(); ++i)
+	{
+		string name;
+		vector<FEBModel::DiscreteSet::ELEM> elems;
+		ar.read(name);
+		ar.read(elems);
+		FEBModel::DiscreteSet* set = new FEBModel::DiscreteSet;
+		set->SetName(name);
+		for (size_t j = 0; j < elems.size(); ++j) set->AddElement(elems[j].node[0], elems[j].node[1]);
+		part.AddDiscreteSet(set);
+	}
+
+	// make sure the file is complete
+	unsigned int nend = 0;
+	ar.read(nend);
+	return (ar.ok() && (nend == CACHE_END));
+}
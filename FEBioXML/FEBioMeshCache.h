@@ -0,0 +1,59 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FEBModel.h"
+#include <vector>
+#include <string>
+
+class FEModelBuilder;
+
+//-----------------------------------------------------------------------------
+// This class manages a binary cache of the Mesh section of an input file. The
+// cache stores the nodes, elements, sets and surfaces of the mesh part so that
+// later runs can read them with a few bulk reads instead of parsing the XML.
+// The cache is keyed by a hash of the Mesh section's content, so it stays valid
+// when other sections (materials, control settings, loads, ...) are changed.
+class FEBioMeshCache
+{
+	enum {
+		CACHE_TAG     = 0x43424546,	// "FEBC"
+		CACHE_VERSION = 1,
+		CACHE_END     = 0x444E4543	// "CEND"
+	};
+
+public:
+	// calculate the key of the content of a Mesh section
+	static unsigned long long Key(const char* pd, size_t nsize);
+
+	// Write the part to the cache file. domType is the element type name of each domain.
+	static bool Write(const char* szfile, unsigned long long key, FEBModel::Part& part, const std::vector<std::string>& domType);
+
+	// Read the part from the cache file. The element specs are obtained from the builder.
+	// Returns false if the file is not a cache for this key.
+	static bool Read(const char* szfile, unsigned long long key, FEBModel::Part& part, FEModelBuilder& builder);
+};
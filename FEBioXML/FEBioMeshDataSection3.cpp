@@ -1066,22 +1066,22 @@ void FEBioMeshDataSection3::ParseElementData(XMLTag& tag, FEDomainMap& map)
 	FEDataType dataType = map.DataType();
 	int dataSize = map.DataSize();
 	int m = map.MaxNodes();
-	double data[3 * FEElement::MAX_NODES]; // make sure this array is large enough to store any data map type (current 3 for FE_VEC3D)
 
 	// TODO: For vec3d values, I sometimes need to normalize the vectors (e.g. for fibers). How can I do this?
 
-	int ncount = 0;
-	++tag;
-	do
-	{
+	// read the element data (in parallel)
+	XMLLeafReader leaves(tag);
+	leaves.Read([&](XMLTag& leaf, int) {
+		double data[3 * FEElement::MAX_NODES]; // make sure this array is large enough to store any data map type (current 3 for FE_VEC3D)
+
 		// get the local element number
-		const char* szlid = tag.AttributeValue("lid");
+		const char* szlid = leaf.AttributeValue("lid");
 		int n = atoi(szlid) - 1;
 
 		// make sure the number is valid
-		if ((n < 0) || (n >= nelems)) throw XMLReader::InvalidAttributeValue(tag, "lid", szlid);
+		if ((n < 0) || (n >= nelems)) throw XMLReader::InvalidAttributeValue(leaf, "lid", szlid);
 
-		int nread = tag.value(data, m*dataSize);
+		int nread = leaf.value(data, m*dataSize);
 		if (nread == dataSize)
 		{
 			double* v = data;
@@ -1110,14 +1110,10 @@ void FEBioMeshDataSection3::ParseElementData(XMLTag& tag, FEDomainMap& map)
 				}
 			}
 		}
-		else throw XMLReader::InvalidValue(tag);
-		++tag;
+		else throw XMLReader::InvalidValue(leaf);
+	});
 
-		ncount++;
-	}
-	while (!tag.isend());
-
-	if (ncount != nelems) throw FEBioImport::MeshDataError();
+	if (leaves.Leaves() != nelems) throw FEBioImport::MeshDataError();
 }
 
 //-----------------------------------------------------------------------------
@@ -1132,19 +1128,17 @@ void FEBioMeshDataSection3::ParseElementData(XMLTag& tag, FEElementSet& set, vec
 	values.resize(nelems);
 	for (int i=0; i<nelems; ++i) values[i].nval = 0;
 
-	++tag;
-	do
-	{
+	// read the element data (in parallel)
+	XMLLeafReader leaves(tag);
+	leaves.Read([&](XMLTag& leaf, int) {
 		// get the local element number
-		const char* szlid = tag.AttributeValue("lid");
+		const char* szlid = leaf.AttributeValue("lid");
 		int n = atoi(szlid)-1;
 
 		// make sure the number is valid
-		if ((n<0) || (n>=nelems)) throw XMLReader::InvalidAttributeValue(tag, "lid", szlid);
+		if ((n<0) || (n>=nelems)) throw XMLReader::InvalidAttributeValue(leaf, "lid", szlid);
 
 		ELEMENT_DATA& data = values[n];
-		data.nval = tag.value(data.val, nvalues);
-		++tag;
-	}
-	while (!tag.isend());
+		data.nval = leaf.value(data.val, nvalues);
+	});
 }
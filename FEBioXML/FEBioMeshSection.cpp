@@ -28,11 +28,13 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEBioMeshSection.h"
+#include "FEBioMeshCache.h"
 #include <FECore/FESolidDomain.h>
 #include <FECore/FEShellDomain.h>
 #include <FECore/FETrussDomain.h>
 #include <FECore/FEDomain2D.h>
 #include <FECore/FEModel.h>
+#include <FECore/log.h>
 #include <FEBioMech/FEElasticMaterial.h>
 #include <FECore/FECoreKernel.h>
 #include <FECore/FENodeNodeList.h>
@@ -51,7 +53,28 @@ void FEBioMeshSection::Parse(XMLTag& tag)
 	//       all lists will be given the name: partname.listname
 	FEBModel& feb = builder->GetFEBModel();
 	assert(feb.Parts() == 0);
+
+	// see if we can read the mesh from the cache
+	const char* szcache = GetFEBioImport()->MeshCacheFile();
+	unsigned long long key = 0;
+	if (szcache)
+	{
+		XMLReader::CONTENT content;
+		tag.m_preader->FindContent(tag, content);
+		key = FEBioMeshCache::Key(content.pd, (size_t)content.size);
+
+		FEBModel::Part* part = new FEBModel::Part("");
+		if (FEBioMeshCache::Read(szcache, key, *part, *builder))
+		{
+			feb.AddPart(part);
+			tag.m_preader->SkipContent(tag, content);
+			return;
+		}
+		delete part;
+	}
+
 	FEBModel::Part* part = feb.AddPart("");
+	m_domType.clear();
 
 	// read all sections
 	++tag;
@@ -69,6 +92,12 @@ void FEBioMeshSection::Parse(XMLTag& tag)
 		++tag;
 	}
 	while (!tag.isend());
+
+	// update the cache
+	if (szcache && (FEBioMeshCache::Write(szcache, key, *part, m_domType) == false))
+	{
+		feLogWarning("Failed writing mesh cache %s", szcache);
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -88,28 +117,21 @@ void FEBioMeshSection::ParseNodeSection(XMLTag& tag, FEBModel::Part* part)
 		part->AddNodeSet(ps);
 	}
 
-	// allocate node
-
-	vector<FEBModel::NODE> node; node.reserve(10000);
-	vector<int> nodeList; nodeList.reserve(10000);
-
 	// read nodal coordinates
-	++tag;
-	do {
+	// (The nodes are read in parallel)
+	XMLLeafReader leaves(tag);
+	int nodes = leaves.Leaves();
+	vector<FEBModel::NODE> node(nodes);
+	vector<int> nodeList(nodes);
+	leaves.Read([&](XMLTag& leaf, int i) {
 		// nodal coordinates
-		FEBModel::NODE nd;
-		value(tag, nd.r);
+		FEBModel::NODE& nd = node[i];
+		value(leaf, nd.r);
 
 		// get the nodal ID
-		tag.AttributeValue("id", nd.id);
-
-		// add it to the pile
-		node.push_back(nd);
-		nodeList.push_back(nd.id);
-
-		// go on to the next node
-		++tag;
-	} while (!tag.isend());
+		leaf.AttributeValue("id", nd.id);
+		nodeList[i] = nd.id;
+	});
 
 	// add nodes to the part
 	part->AddNodes(node);
@@ -143,6 +165,7 @@ void FEBioMeshSection::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 
 	// add domain it to the mesh
 	part->AddDomain(dom);
+	m_domType.push_back(sztype);
 
 	// for named domains, we'll also create an element set
 	FEBModel::ElementSet* pg = 0;
@@ -152,27 +175,22 @@ void FEBioMeshSection::ParseElementSection(XMLTag& tag, FEBModel::Part* part)
 		part->AddElementSet(pg);
 	}
 
-	dom->Reserve(10000);
-	vector<int> elemList; elemList.reserve(10000);
-
 	// read element data
-	++tag;
-	do
-	{
-		FEBModel::ELEMENT el;
+	// (The elements are read in parallel)
+	XMLLeafReader leaves(tag);
+	int elems = leaves.Leaves();
+	dom->Create(elems);
+	vector<int> elemList(elems);
+	leaves.Read([&](XMLTag& leaf, int i) {
+		FEBModel::ELEMENT& el = dom->GetElement(i);
 
 		// get the element ID
-		tag.AttributeValue("id", el.id);
+		leaf.AttributeValue("id", el.id);
+		elemList[i] = el.id;
 
 		// read the element data
-		tag.value(el.node, FEElement::MAX_NODES);
-
-		dom->AddElement(el);
-		elemList.push_back(el.id);
-
-		// go to next tag
-		++tag;
-	} while (!tag.isend());
+		leaf.value(el.node, FEElement::MAX_NODES);
+	});
 
 	// set the element list
 	if (pg) pg->SetElementList(elemList);
@@ -48,6 +48,9 @@ protected:
 	void ParseEdgeSection       (XMLTag& tag, FEBModel::Part* part);
 	void ParseSurfacePairSection(XMLTag& tag, FEBModel::Part* part);
 	void ParseDiscreteSetSection(XMLTag& tag, FEBModel::Part* part);
+
+private:
+	std::vector<std::string>	m_domType;	// element type names of the domains (needed for the mesh cache)
 };
 
 //-----------------------------------------------------------------------------
@@ -132,6 +132,13 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
 			}
 
+			sz = tag.AttributeValue("binary", true);
+			if (sz != 0)
+			{
+				if      (strcmp(sz, "on") == 0) prec->SetBinary(true);
+				else if (strcmp(sz, "off") == 0) prec->SetBinary(false); 
+			}
+
 			const char* sztmp = "set";
 			if (GetFileReader()->GetFileVersion() >= 0x0205) sztmp = "node_set";
 			sz = tag.AttributeValue(sztmp, true);
@@ -182,6 +189,13 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
 			}
 
+			sz = tag.AttributeValue("binary", true);
+			if (sz != 0)
+			{
+				if      (strcmp(sz, "on") == 0) prec->SetBinary(true);
+				else if (strcmp(sz, "off") == 0) prec->SetBinary(false); 
+			}
+
 			const char* sztmp = "elset";
 			if (GetFileReader()->GetFileVersion() >= 0x0205) sztmp = "elem_set";
 
@@ -233,6 +247,13 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
 			}
 
+			sz = tag.AttributeValue("binary", true);
+			if (sz != 0)
+			{
+				if      (strcmp(sz, "on") == 0) prec->SetBinary(true);
+				else if (strcmp(sz, "off") == 0) prec->SetBinary(false); 
+			}
+
 			prec->SetItemList(tag.szvalue());
 
 			GetFEBioImport()->AddDataRecord(prec);
@@ -273,6 +294,13 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
                 if      (strcmp(sz, "on") == 0) prec->SetComments(true);
                 else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
             }
+
+            sz = tag.AttributeValue("binary", true);
+            if (sz != 0)
+            {
+                if      (strcmp(sz, "on") == 0) prec->SetBinary(true);
+                else if (strcmp(sz, "off") == 0) prec->SetBinary(false); 
+            }
             
             prec->SetItemList(tag.szvalue());
             
@@ -318,6 +346,11 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 				vector<int> item;
 				if (tag.isempty() == false) tag.value(item);
 
+				// get the (optional) quantization tolerance
+				double tol = 0.0;
+				const char* sztol = tag.AttributeValue("tolerance", true);
+				if (sztol) tol = atof(sztol);
+
                 // see if a surface is referenced
                 const char* szset = tag.AttributeValue("surface", true);
                 if (szset)
@@ -339,14 +372,14 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 
                         // Add the plot variable
                         const std::string& surfName = psurf->GetName();
-						GetFEBioImport()->AddPlotVariable(szt, item, surfName.c_str());
+						GetFEBioImport()->AddPlotVariable(szt, item, surfName.c_str(), tol);
                     }
                     else throw XMLReader::InvalidAttributeValue(tag, "set", szset);
                 }
                 else
                 {
                     // Add the plot variable
-					GetFEBioImport()->AddPlotVariable(szt, item);
+					GetFEBioImport()->AddPlotVariable(szt, item, "", tol);
                 }
 			}
 			else if (tag=="compression")
@@ -355,6 +388,20 @@ void FEBioOutputSection::ParsePlotfile(XMLTag &tag)
 				tag.value(ncomp);
 				GetFEBioImport()->SetPlotCompression(ncomp);
 			}
+			else if (tag=="async")
+			{
+				// nr of states that can be queued for the background writer
+				int nqueue;
+				tag.value(nqueue);
+				GetFEBioImport()->SetPlotAsync(nqueue);
+			}
+			else if (tag=="index")
+			{
+				// write a state index at the end of the plot file
+				bool b;
+				tag.value(b);
+				GetFEBioImport()->SetPlotIndex(b);
+			}
 			++tag;
 		}
 		while (!tag.isend());
@@ -438,7 +438,7 @@ int FEModelBuilder::FindNodeFromID(int nid)
 }
 
 //-----------------------------------------------------------------------------
-void FEModelBuilder::GlobalToLocalID(int* l, int n, vector<int>& m)
+void FEModelBuilder::GlobalToLocalID(int* l, int n, FEElementConnectivity& m)
 {
 	assert((int)m.size() == n);
 	for (int i = 0; i<n; ++i)
@@ -161,7 +161,7 @@ public:
 	int FindNodeFromID(int nid);
 
 	// convert an array of nodal ID to nodal indices
-	void GlobalToLocalID(int* l, int n, vector<int>& m);
+	void GlobalToLocalID(int* l, int n, FEElementConnectivity& m);
 
 public:
 	void AddMappedParameter(FEParam* p, FECoreBase* parent, const char* szmap, int index = 0);
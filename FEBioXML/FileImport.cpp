@@ -85,13 +85,13 @@ FEModelBuilder* FEFileSection::GetBuilder() { return m_pim->GetBuilder(); }
 //-----------------------------------------------------------------------------
 void FEFileSection::value(XMLTag& tag, int& n)
 {
-	n = atoi(tag.szvalue());
+	xml_parse_int(tag.szvalue(), n);
 }
 
 //-----------------------------------------------------------------------------
 void FEFileSection::value(XMLTag& tag, double& g)
 {
-	g = atof(tag.szvalue());
+	xml_parse_double(tag.szvalue(), g);
 }
 
 //-----------------------------------------------------------------------------
@@ -106,9 +106,20 @@ void FEFileSection::value(XMLTag& tag, bool& b)
 //-----------------------------------------------------------------------------
 void FEFileSection::value(XMLTag& tag, vec3d& v)
 {
+	// (this is called for every node, so we don't use sscanf here)
 	const char* sz = tag.szvalue();
-	int n = sscanf(sz, "%lg,%lg,%lg", &v.x, &v.y, &v.z);
-	if (n != 3) throw XMLReader::XMLSyntaxError(tag.m_nstart_line);
+	double* pv[3] = { &v.x, &v.y, &v.z };
+	for (int i = 0; i < 3; ++i)
+	{
+		if (i > 0)
+		{
+			if (*sz != ',') throw XMLReader::XMLSyntaxError(tag.m_nstart_line);
+			sz++;
+		}
+		const char* sze = xml_parse_double(sz, *pv[i]);
+		if (sze == sz) throw XMLReader::XMLSyntaxError(tag.m_nstart_line);
+		sz = sze;
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -215,37 +226,13 @@ void FEFileSection::value(XMLTag& tag, std::vector<double>& v)
 //-----------------------------------------------------------------------------
 int FEFileSection::value(XMLTag& tag, int* pi, int n)
 {
-	const char* sz = tag.szvalue();
-	int nr = 0;
-	for (int i = 0; i<n; ++i)
-	{
-		const char* sze = strchr(sz, ',');
-
-		pi[i] = atoi(sz);
-nr++;
-
-if (sze) sz = sze + 1;
-else break;
-	}
-	return nr;
+	return tag.value(pi, n);
 }
 
 //-----------------------------------------------------------------------------
 int FEFileSection::value(XMLTag& tag, double* pf, int n)
 {
-	const char* sz = tag.szvalue();
-	int nr = 0;
-	for (int i = 0; i < n; ++i)
-	{
-		const char* sze = strchr(sz, ',');
-
-		pf[i] = atof(sz);
-		nr++;
-
-		if (sze) sz = sze + 1;
-		else break;
-	}
-	return nr;
+	return tag.value(pf, n);
 }
 
 //-----------------------------------------------------------------------------
@@ -30,6 +30,106 @@ SOFTWARE.*/
 #include "XMLReader.h"
 #include <assert.h>
 #include <stdarg.h>
+#include <algorithm>
+#include <exception>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//=============================================================================
+// number parsing
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// Reads a double. Numbers with at most 19 significant digits whose decimal exponent
+// is small enough are converted with a single multiplication or division, which
+// is exact (i.e. gives the same result as strtod). All other numbers (and inf, nan,
+// hex-floats, etc.) are passed on to strtod.
+const char* xml_parse_double(const char* sz, double& v)
+{
+	static const double p10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	const char* p = sz;
+	while (isspace((unsigned char)*p)) p++;
+
+	bool neg = false;
+	if ((*p == '-') || (*p == '+')) neg = (*p++ == '-');
+
+	// hex-floats are passed on to strtod
+	bool bslow = ((p[0] == '0') && ((p[1] == 'x') || (p[1] == 'X')));
+
+	unsigned long long m = 0;
+	int nd = 0, e = 0;
+	bool bdigits = false;
+	for (; (*p >= '0') && (*p <= '9'); ++p)
+	{
+		bdigits = true;
+		if (nd < 19) { m = 10*m + (*p - '0'); if (m) nd++; }
+		else { bslow = true; e++; }
+	}
+	if (*p == '.')
+	{
+		for (++p; (*p >= '0') && (*p <= '9'); ++p)
+		{
+			bdigits = true;
+			if (nd < 19) { m = 10*m + (*p - '0'); if (m) nd++; e--; }
+			else bslow = true;
+		}
+	}
+
+	if (bdigits && ((*p == 'e') || (*p == 'E')))
+	{
+		const char* q = p + 1;
+		bool eneg = false;
+		if ((*q == '-') || (*q == '+')) eneg = (*q++ == '-');
+		if ((*q >= '0') && (*q <= '9'))
+		{
+			int ne = 0;
+			for (; (*q >= '0') && (*q <= '9'); ++q) if (ne < 100000) ne = 10*ne + (*q - '0');
+			e += (eneg ? -ne : ne);
+			p = q;
+		}
+	}
+
+	if ((bdigits == false) || bslow || ((m != 0) && ((m > (1ULL << 53)) || (e < -22) || (e > 22))))
+	{
+		char* pe = nullptr;
+		v = strtod(sz, &pe);
+		return pe;
+	}
+
+	if (m == 0) { v = (neg ? -0.0 : 0.0); return p; }
+
+	double d = (double)m;
+	if (e < 0) d /= p10[-e]; else d *= p10[e];
+	v = (neg ? -d : d);
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+const char* xml_parse_int(const char* sz, int& v)
+{
+	const char* p = sz;
+	while (isspace((unsigned char)*p)) p++;
+
+	bool neg = false;
+	if ((*p == '-') || (*p == '+')) neg = (*p++ == '-');
+
+	if ((*p < '0') || (*p > '9')) { v = 0; return sz; }
+
+	long long n = 0;
+	for (; (*p >= '0') && (*p <= '9'); ++p) n = 10*n + (*p - '0');
+	v = (int)(neg ? -n : n);
+	return p;
+}
 
 //=============================================================================
 // XMLAtt
@@ -91,9 +191,10 @@ int XMLTag::value(double* pf, int n)
 	int nr = 0;
 	for (int i=0; i<n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
+		double d;
+		const char* sze = strchr(xml_parse_double(sz, d), ',');
 
-		pf[i] = atof(sz);
+		pf[i] = d;
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -112,9 +213,10 @@ int XMLTag::value(float* pf, int n)
 	int nr = 0;
 	for (int i=0; i<n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
+		double d;
+		const char* sze = strchr(xml_parse_double(sz, d), ',');
 
-		pf[i] = (float) atof(sz);
+		pf[i] = (float) d;
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -133,9 +235,7 @@ int XMLTag::value(int* pi, int n)
 	int nr = 0;
 	for (int i=0; i<n; ++i)
 	{
-		const char* sze = strchr(sz, ',');
-
-		pi[i] = atoi(sz);
+		const char* sze = strchr(xml_parse_int(sz, pi[i]), ',');
 		nr++;
 
 		if (sze) sz = sze+1;
@@ -333,7 +433,7 @@ bool XMLTag::AttributeValue(const char* szat, double& d, bool bopt)
 	const char* szv = AttributeValue(szat, bopt);
 	if (szv == 0) return false;
 
-	d = atof(szv);
+	xml_parse_double(szv, d);
 
 	return true;
 }
@@ -344,7 +444,7 @@ bool XMLTag::AttributeValue(const char* szat, int& n, bool bopt)
 	const char* szv = AttributeValue(szat, bopt);
 	if (szv == 0) return false;
 
-	n = atoi(szv);
+	xml_parse_int(szv, n);
 
 	return true;
 }
@@ -407,11 +507,12 @@ XMLReader::Error(tag, format_string("missing attribute \"%s\"", sza)) {}
 //-----------------------------------------------------------------------------
 XMLReader::XMLReader()
 {
-	m_fp = 0;
+	m_pd = nullptr;
+	m_nsize = 0;
+	m_hfile = nullptr;
+	m_hmap = nullptr;
+	m_bview = false;
 	m_nline = 0;
-	m_bufIndex = 0;
-	m_bufSize = 0;
-	m_eof = false;
 	m_currentPos = 0;
 }
 
@@ -424,16 +525,23 @@ XMLReader::~XMLReader()
 //-----------------------------------------------------------------------------
 void XMLReader::Close()
 {
-	if (m_fp)
+	if (m_pd && (m_bview == false))
 	{
-		fclose(m_fp);
+#ifdef WIN32
+		UnmapViewOfFile(m_pd);
+		CloseHandle((HANDLE)m_hmap);
+		CloseHandle((HANDLE)m_hfile);
+#else
+		munmap((void*)m_pd, (size_t)m_nsize);
+#endif
 	}
 
-	m_fp = 0;
+	m_pd = nullptr;
+	m_nsize = 0;
+	m_hfile = nullptr;
+	m_hmap = nullptr;
+	m_bview = false;
 	m_nline = 0;
-	m_bufIndex = 0;
-	m_bufSize = 0;
-	m_eof = false;
 	m_currentPos = 0;
 }
 
@@ -441,20 +549,46 @@ void XMLReader::Close()
 bool XMLReader::Open(const char* szfile)
 {
 	// make sure this reader has not been attached to a file yet
-	if (m_fp != 0) return false;
+	if (m_pd != nullptr) return false;
 
-	// open the file
-	m_fp = fopen(szfile, "rb");
-	if (m_fp == 0) return false;
+	// map the file
+#ifdef WIN32
+	HANDLE hf = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hf == INVALID_HANDLE_VALUE) return false;
 
-	// read the first line
-	char szline[256] = {0};
-	fgets(szline, 255, m_fp);
+	LARGE_INTEGER size;
+	if ((GetFileSizeEx(hf, &size) == FALSE) || (size.QuadPart == 0)) { CloseHandle(hf); return false; }
+
+	HANDLE hm = CreateFileMappingA(hf, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hm == NULL) { CloseHandle(hf); return false; }
+
+	void* pv = MapViewOfFile(hm, FILE_MAP_READ, 0, 0, 0);
+	if (pv == NULL) { CloseHandle(hm); CloseHandle(hf); return false; }
+
+	m_hfile = hf;
+	m_hmap = hm;
+	m_nsize = (int64_t)size.QuadPart;
+#else
+	int fd = open(szfile, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0)) { close(fd); return false; }
+
+	void* pv = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (pv == MAP_FAILED) return false;
+
+	m_nsize = (int64_t)st.st_size;
+#endif
+	m_pd = (const char*)pv;
+	m_bview = false;
 
 	// make sure it is correct
-	if (strncmp(szline,"<?xml", 5) != 0)
+	if ((m_nsize < 5) || (strncmp(m_pd, "<?xml", 5) != 0))
 	{
 		// This file is not an XML file
+		Close();
 		return false;
 	}
 
@@ -464,6 +598,15 @@ bool XMLReader::Open(const char* szfile)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void XMLReader::Attach(const XMLReader& xml)
+{
+	Close();
+	m_pd = xml.m_pd;
+	m_nsize = xml.m_nsize;
+	m_bview = true;
+}
+
 //-----------------------------------------------------------------------------
 
 class XMLPath
@@ -578,8 +721,6 @@ private:
 bool XMLReader::FindTag(const char* xpath, XMLTag& tag)
 {
 	// go to the beginning of the file
-	fseek(m_fp, 0, SEEK_SET);
-	m_bufIndex = m_bufSize = 0;
 	m_currentPos = 0;
 
 	// set the first tag
@@ -630,13 +771,7 @@ void XMLReader::NextTag(XMLTag& tag)
 	m_nline = tag.m_ncurrent_line;
 
 	// set the current file position
-	if (m_currentPos != tag.m_fpos)
-	{
-		fseek(m_fp, tag.m_fpos, SEEK_SET);
-		m_currentPos = tag.m_fpos;
-		m_bufSize = m_bufIndex = 0;
-		m_eof = false;
-	}
+	m_currentPos = tag.m_fpos;
 
 	// clear tag's content
 	tag.clear();
@@ -792,18 +927,48 @@ void XMLReader::ReadTag(XMLTag& tag)
 //-----------------------------------------------------------------------------
 void XMLReader::ReadValue(XMLTag& tag)
 {
-	char ch;
 	if (!tag.isend())
 	{
 		tag.m_szval.clear();
-		tag.m_szval.reserve(256);
-		while ((ch=GetChar())!='<') 
-		{ 
-			tag.m_szval.push_back(ch);
-		}
+		ReadText(&tag.m_szval);
 		tag.m_szval.push_back(0);
 	}
-	else while ((ch=GetChar())!='<');
+	else ReadText(nullptr);
+}
+
+//-----------------------------------------------------------------------------
+// Reads up to and including the next '<'. The text (without line breaks) is
+// appended to psz (if not null). Text without entity references is copied at once.
+void XMLReader::ReadText(std::string* psz)
+{
+	const char* pb = m_pd + m_currentPos;
+	const char* pe = m_pd + m_nsize;
+	const char* pl = (m_currentPos < m_nsize ? (const char*)memchr(pb, '<', pe - pb) : nullptr);
+	if (pl && (memchr(pb, '&', pl - pb) == nullptr))
+	{
+		int nl = (int)std::count(pb, pl, '\n');
+		if (psz)
+		{
+			if (nl == 0) psz->append(pb, pl);
+			else
+			{
+				size_t n0 = psz->size();
+				psz->resize(n0 + (pl - pb) - nl);
+				std::remove_copy(pb, pl, psz->begin() + n0, '\n');
+			}
+		}
+		m_nline += nl;
+		m_currentPos = (pl - m_pd) + 1;
+		return;
+	}
+
+	char ch;
+	if (psz)
+	{
+		psz->reserve(256);
+		while ((ch = GetChar()) != '<') psz->push_back(ch);
+	}
+	else while ((ch = GetChar()) != '<');
 }
 
 //-----------------------------------------------------------------------------
@@ -867,16 +1032,8 @@ void XMLReader::ReadEndTag(XMLTag& tag)
 //-----------------------------------------------------------------------------
 char XMLReader::readNextChar()
 {
-	if (m_bufIndex >= m_bufSize)
-	{
-		if (m_eof) throw EndOfFile();
-
-		m_bufSize = fread(m_buf, 1, BUF_SIZE, m_fp);
-		m_bufIndex = 0;
-		m_eof = (m_bufSize != BUF_SIZE);
-	}
-	m_currentPos++;
-	return m_buf[m_bufIndex++];
+	if (m_currentPos >= m_nsize) throw EndOfFile();
+	return m_pd[m_currentPos++];
 }
 
 //-----------------------------------------------------------------------------
@@ -889,15 +1046,7 @@ int64_t XMLReader::currentPos()
 //! move the file pointer
 void XMLReader::rewind(int64_t nstep)
 {
-	m_bufIndex -= nstep;
 	m_currentPos -= nstep;
-
-	if (m_bufIndex < 0)
-	{
-		fseek(m_fp, m_bufIndex - m_bufSize, SEEK_CUR);
-		m_bufIndex = m_bufSize = 0;
-		m_eof = false;
-	}
 }
 
 //-----------------------------------------------------------------------------
@@ -949,3 +1098,213 @@ void XMLReader::SkipTag(XMLTag& tag)
 
 	++tag;
 }
+
+//=============================================================================
+// Markup scanning
+//=============================================================================
+
+// types of markup
+enum { MARKUP_START, MARKUP_EMPTY, MARKUP_END, MARKUP_OTHER };
+
+//-----------------------------------------------------------------------------
+// Scans the markup at pos (which must be a '<') without parsing it. Returns the
+// markup type and sets next to the position after the markup and nl to the number
+// of line breaks inside the markup. Comments and processing instructions are
+// returned as MARKUP_OTHER.
+static int scan_markup(const char* pd, int64_t nsize, int64_t pos, int64_t& next, int& nl)
+{
+	if (pos + 1 >= nsize) throw XMLReader::UnexpectedEOF();
+	char c = pd[pos + 1];
+
+	if (c == '!')
+	{
+		// find the end of the comment
+		int64_t i = pos + 4;
+		while ((i + 2 < nsize) && ((pd[i] != '-') || (pd[i + 1] != '-') || (pd[i + 2] != '>'))) i++;
+		if (i + 2 >= nsize) throw XMLReader::UnexpectedEOF();
+		nl = (int)std::count(pd + pos, pd + i, '\n');
+		next = i + 3;
+		return MARKUP_OTHER;
+	}
+
+	// find the next '>' that is not inside quotes
+	char quot = 0;
+	nl = 0;
+	int64_t i = pos + 1;
+	for (; i < nsize; ++i)
+	{
+		char ch = pd[i];
+		if (ch == '\n') nl++;
+		else if (quot) { if (ch == quot) quot = 0; }
+		else if ((ch == '"') || (ch == '\'')) quot = ch;
+		else if (ch == '>') break;
+	}
+	if (i >= nsize) throw XMLReader::UnexpectedEOF();
+	next = i + 1;
+
+	if (c == '/') return MARKUP_END;
+	if (c == '?') return MARKUP_OTHER;
+	return (pd[i - 1] == '/' ? MARKUP_EMPTY : MARKUP_START);
+}
+
+//-----------------------------------------------------------------------------
+void XMLReader::FindContent(XMLTag& tag, CONTENT& c)
+{
+	c.pd = m_pd + tag.m_fpos;
+	c.size = 0;
+	c.endPos = -1;
+	c.endLine = 0;
+
+	// nothing to do if the tag doesn't have children
+	if (tag.isleaf() || tag.isempty()) return;
+
+	int64_t pos = tag.m_fpos;
+	int line = tag.m_ncurrent_line;
+	int depth = 0;
+	while (true)
+	{
+		const char* pl = (pos < m_nsize ? (const char*)memchr(m_pd + pos, '<', m_nsize - pos) : nullptr);
+		if (pl == nullptr) throw XMLReader::UnexpectedEOF();
+		line += (int)std::count(m_pd + pos, pl, '\n');
+		pos = pl - m_pd;
+
+		int64_t next;
+		int nl;
+		int type = scan_markup(m_pd, m_nsize, pos, next, nl);
+		if (type == MARKUP_START) depth++;
+		else if (type == MARKUP_END)
+		{
+			if (depth == 0) break;
+			depth--;
+		}
+
+		line += nl;
+		pos = next;
+	}
+
+	c.size = pos - tag.m_fpos;
+	c.endPos = pos;
+	c.endLine = line;
+}
+
+//-----------------------------------------------------------------------------
+void XMLReader::SkipContent(XMLTag& tag, const CONTENT& c)
+{
+	if (c.endPos < 0) return;
+	tag.m_fpos = c.endPos;
+	tag.m_ncurrent_line = c.endLine;
+	NextTag(tag);
+}
+
+//=============================================================================
+// XMLLeafReader
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+XMLLeafReader::XMLLeafReader(XMLTag& tag) : m_tag(tag)
+{
+	m_leaves = 0;
+	m_endPos = -1;
+	m_endLine = 0;
+
+	// nothing to do if the tag doesn't have children
+	if (tag.isleaf() || tag.isempty()) return;
+
+	XMLReader& xml = *tag.m_preader;
+	const char* pd = xml.m_pd;
+	int64_t nsize = xml.m_nsize;
+	int64_t pos = tag.m_fpos;
+	int line = tag.m_ncurrent_line;
+
+	// Find the start tags of the children and the end tag of this tag. Since all
+	// children must be leaves, we only have to track whether we are inside a child.
+	bool bchild = false;
+	while (true)
+	{
+		const char* pl = (pos < nsize ? (const char*)memchr(pd + pos, '<', nsize - pos) : nullptr);
+		if (pl == nullptr) throw XMLReader::UnexpectedEOF();
+		line += (int)std::count(pd + pos, pl, '\n');
+		pos = pl - pd;
+
+		int64_t next;
+		int nl;
+		int type = scan_markup(pd, nsize, pos, next, nl);
+		if (type == MARKUP_END)
+		{
+			if (bchild == false)
+			{
+				// this is our end tag
+				m_endPos = pos;
+				m_endLine = line;
+				break;
+			}
+			bchild = false;
+		}
+		else if (type != MARKUP_OTHER)
+		{
+			// a child element must not have children of its own
+			if (bchild) throw XMLReader::XMLSyntaxError(line);
+
+			if (m_leaves % CHUNK_SIZE == 0)
+			{
+				CHUNK c = { pos, line };
+				m_chunk.push_back(c);
+			}
+			m_leaves++;
+
+			bchild = (type == MARKUP_START);
+		}
+
+		line += nl;
+		pos = next;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void XMLLeafReader::Read(const std::function<void(XMLTag& leaf, int n)>& f)
+{
+	if (m_endPos < 0) return;
+
+	XMLReader& xml = *m_tag.m_preader;
+
+	// read the chunks in parallel. If errors occur, we report the one that
+	// comes first in the file.
+	int nchunks = (int)m_chunk.size();
+	int nerr = nchunks;
+	std::exception_ptr err;
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < nchunks; ++i)
+	{
+		try
+		{
+			XMLReader view;
+			view.Attach(xml);
+
+			XMLTag leaf(m_tag);
+			leaf.m_preader = &view;
+			leaf.m_fpos = m_chunk[i].pos;
+			leaf.m_ncurrent_line = m_chunk[i].line;
+
+			int n0 = i*CHUNK_SIZE;
+			int n1 = std::min(n0 + (int)CHUNK_SIZE, m_leaves);
+			for (int n = n0; n < n1; ++n)
+			{
+				view.NextTag(leaf);
+				f(leaf, n);
+			}
+		}
+		catch (...)
+		{
+#pragma omp critical
+			{
+				if (i < nerr) { nerr = i; err = std::current_exception(); }
+			}
+		}
+	}
+	if (err) std::rethrow_exception(err);
+
+	// move on to the end tag
+	m_tag.m_fpos = m_endPos;
+	m_tag.m_ncurrent_line = m_endLine;
+	xml.NextTag(m_tag);
+}
@@ -34,6 +34,7 @@ SOFTWARE.*/
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <functional>
 #include "febioxml_api.h"
 using namespace std;
 
@@ -41,6 +42,13 @@ using namespace std;
 // forward declaration
 class XMLReader;
 
+//-------------------------------------------------------------------------
+// Locale-independent number parsing. Leading whitespace is skipped and the
+// functions return a pointer to the first character after the number. If no
+// number was found, v is set to zero and sz is returned (like atof and atoi).
+FEBIOXML_API const char* xml_parse_double(const char* sz, double& v);
+FEBIOXML_API const char* xml_parse_int(const char* sz, int& v);
+
 //-------------------------------------------------------------------------
 //! This class represents a xml-attribute
 class FEBIOXML_API XMLAtt
@@ -124,11 +132,11 @@ public:
 		
 	const char* Name() { return m_sztag; }
 
-	void value(double& val) { val = atof(m_szval.c_str()); } 
-	void value(float& val)  { val = (float) atof(m_szval.c_str()); }
-	void value(int& val) { val = atoi(m_szval.c_str()); }
-	void value(long& val) { val = (long) atoi(m_szval.c_str()); }
-	void value(short& val) { val = (short) atoi(m_szval.c_str()); }
+	void value(double& val) { xml_parse_double(m_szval.c_str(), val); }
+	void value(float& val)  { double d; xml_parse_double(m_szval.c_str(), d); val = (float) d; }
+	void value(int& val) { xml_parse_int(m_szval.c_str(), val); }
+	void value(long& val) { int n; xml_parse_int(m_szval.c_str(), n); val = (long) n; }
+	void value(short& val) { int n; xml_parse_int(m_szval.c_str(), n); val = (short) n; }
 	int value(double* pf, int n);
 	int value(float* pf, int n);
 	int value(int* pi, int n);
@@ -142,14 +150,12 @@ public:
 };
 
 //-----------------------------------------------------------------------------
-//! This class implements a reader for XML files
+//! This class implements a reader for XML files. The file is memory-mapped.
 class FEBIOXML_API XMLReader
 {
 public:
 	enum {MAX_TAG   = 128};
 
-	enum {BUF_SIZE = 32768};
-
 public:
 	// Base class for Exceptions
 	class FEBIOXML_API Error : public std::runtime_error
@@ -221,6 +227,16 @@ public:
 	};
 	//------------------------
 
+public:
+	//! The content of a tag (i.e. everything between its start and end tag)
+	struct CONTENT
+	{
+		const char*	pd;			// start of the content
+		int64_t		size;		// size of the content
+		int64_t		endPos;		// file position of the end tag
+		int			endLine;	// line number of the end tag
+	};
+
 public:
 	//! constructor/destructor
 	XMLReader();
@@ -244,6 +260,14 @@ public:
 	//! Skip a tag
 	void SkipTag(XMLTag& tag);
 
+	//! Locate the content of a tag. This only scans the markup, without parsing
+	//! the child elements.
+	void FindContent(XMLTag& tag, CONTENT& c);
+
+	//! Skip the content that was located with FindContent. On return, the tag
+	//! is positioned at its end tag.
+	void SkipContent(XMLTag& tag, const CONTENT& c);
+
 protected: // helper functions
 
 	//! Get the next character in the file
@@ -267,14 +291,57 @@ protected: // helper functions
 	//! move the file pointer
     void rewind(int64_t nstep);
 
+	//! skip to the next '<' and return the skipped text
+	void ReadText(std::string* psz);
+
+	//! share the file of another reader
+	void Attach(const XMLReader& xml);
+
 protected:
-	FILE*	m_fp;			//!< the file pointer
+	const char*	m_pd;			//!< the mapped file
+	int64_t		m_nsize;		//!< file size
+	void*		m_hfile;		//!< file handle (only used on Windows)
+	void*		m_hmap;			//!< mapping handle (only used on Windows)
+	bool		m_bview;		//!< this reader uses the file of another reader
+
 	int		m_nline;		//!< current line (used only as temp storage)
     int64_t	m_currentPos;	//!< current file position
 
-	char	m_buf[BUF_SIZE];
-    int64_t    m_bufIndex, m_bufSize;
-	bool	m_eof;
+	friend class XMLLeafReader;
+};
+
+//-----------------------------------------------------------------------------
+//! This class reads the child elements of a tag in parallel. It is meant for
+//! large sections whose child elements are all leaves, like nodes, elements and
+//! element data. The constructor locates the children, so that the caller can
+//! allocate storage before they are read. After Read returns, the tag is
+//! positioned at its end tag, as if the children were read with ++tag.
+class FEBIOXML_API XMLLeafReader
+{
+	enum { CHUNK_SIZE = 4096 };	// nr of leaves that are read by one thread at a time
+
+	struct CHUNK
+	{
+		int64_t	pos;	// file position of first leaf
+		int		line;	// line number of first leaf
+	};
+
+public:
+	XMLLeafReader(XMLTag& tag);
+
+	//! number of child elements
+	int Leaves() const { return m_leaves; }
+
+	//! read the child elements. f(leaf, n) is called for each child and these
+	//! calls can run in parallel.
+	void Read(const std::function<void(XMLTag& leaf, int n)>& f);
+
+private:
+	XMLTag&				m_tag;
+	int					m_leaves;
+	std::vector<CHUNK>	m_chunk;
+	int64_t				m_endPos;	// file position of the end tag
+	int					m_endLine;	// line number of the end tag
 };
 
 //-----------------------------------------------------------------------------
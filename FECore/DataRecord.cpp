@@ -51,6 +51,8 @@ DataRecord::DataRecord(FEModel* pfem, const char* szfile, int ntype) : m_type(nt
 	strcpy(m_szdelim, " ");
 	
 	m_bcomm = true;
+	m_bbin = false;
+	m_bhdr = false;
 
 	m_fp = 0;
 	m_szfile[0] = 0;
@@ -91,6 +93,22 @@ void DataRecord::SetFormat(const char* sz)
 	strcpy(m_szfmt, sz);
 }
 
+//-----------------------------------------------------------------------------
+// The data file is created as a text file by the constructor, so it needs to be 
+// recreated in binary mode.
+void DataRecord::SetBinary(bool b)
+{
+	if (b == m_bbin) return;
+	m_bbin = b;
+	m_bhdr = false;
+	if (m_fp)
+	{
+		fclose(m_fp);
+		m_fp = fopen(m_szfile, (m_bbin ? "wb" : "wt"));
+		if (m_fp == 0) feLogErrorEx(m_pfem, "FAILED CREATING DATA FILE %s\n\n", m_szfile);
+	}
+}
+
 //-----------------------------------------------------------------------------
 bool DataRecord::Initialize()
 {
@@ -99,18 +117,17 @@ bool DataRecord::Initialize()
 }
 
 //-----------------------------------------------------------------------------
-std::string DataRecord::printToString(int i)
+// nitem is the item ID and pv are the nd values of the item
+static std::string printToString(int nitem, const double* pv, int nd, const char* szdelim)
 {
 	std::stringstream ss;
 	ss.precision(12);
 
-	ss << m_item[i] << m_szdelim;
-	int nd = Size();
+	ss << nitem << szdelim;
 	for (int j = 0; j<nd; ++j)
 	{
-		double val = Evaluate(m_item[i], j);
-		ss << val;
-		if (j != nd - 1) ss << m_szdelim;
+		ss << pv[j];
+		if (j != nd - 1) ss << szdelim;
 		else ss << "\n";
 	}
 
@@ -118,15 +135,14 @@ std::string DataRecord::printToString(int i)
 }
 
 //-----------------------------------------------------------------------------
-std::string DataRecord::printToFormatString(int i)
+// i is the (zero-based) index of the item in the item list
+static std::string printToFormatString(int nitem, int i, const double* pv, int ndata, const char* szformat)
 {
-	int ndata = Size();
-	char szfmt[MAX_STRING];
-	strcpy(szfmt, m_szfmt);
+	char szfmt[DataRecord::MAX_STRING];
+	strcpy(szfmt, szformat);
 
 	std::stringstream ss;
 
-	int nitem = m_item[i];
 	char* sz = szfmt, *ch = 0;
 	int j = 0;
 	do
@@ -155,8 +171,7 @@ std::string DataRecord::printToFormatString(int i)
 				*ch = '%'; sz = ch + 2;
 				if (j<ndata)
 				{
-					double val = Evaluate(nitem, j++);
-					ss << val;
+					ss << pv[j++];
 				}
 			}
 			else if (ch[1] == 't')
@@ -200,8 +215,31 @@ bool DataRecord::Write()
 	feLogEx(m_pfem, "Time = %.9lg\n", ftime);
 	feLogEx(m_pfem, "Data = %s\n", m_szname);
 
-	// write some comments
+	// evaluate the data
+	// The first item is evaluated on its own, so that records can set up
+	// any lookup tables they build on demand, before the other items are 
+	// evaluated in parallel.
+	int NI = (int)m_item.size();
+	int nd = Size();
+	std::vector<double> val((size_t)NI*nd);
+	if (NI > 0)
+	{
+		for (int j = 0; j<nd; ++j) val[j] = Evaluate(m_item[0], j);
+	}
+	#pragma omp parallel for schedule(static)
+	for (int i = 1; i<NI; ++i)
+	{
+		for (int j = 0; j<nd; ++j) val[(size_t)i*nd + j] = Evaluate(m_item[i], j);
+	}
+
 	FILE* fp = m_fp;
+	if (fp && m_bbin)
+	{
+		WriteBinary(nstep, ftime, val);
+		return true;
+	}
+
+	// write some comments
 	if (fp && m_bcomm)
 	{
 		// we save the data in a seperate file
@@ -213,32 +251,135 @@ bool DataRecord::Write()
 		fprintf(fp,"*Data  = %s\n", m_szname);
 	}
 
+	// format the data
+	std::vector<std::string> out(NI);
+	#pragma omp parallel for schedule(static)
+	for (int i=0; i<NI; ++i)
+	{
+		const double* pv = (nd > 0 ? &val[(size_t)i*nd] : nullptr);
+		if (m_szfmt[0]==0) out[i] = printToString(m_item[i], pv, nd, m_szdelim);
+		else out[i] = printToFormatString(m_item[i], i, pv, nd, m_szfmt);
+	}
+
 	// save the data
-	if (m_szfmt[0]==0)
+	for (int i=0; i<NI; ++i)
 	{
-		for (size_t i=0; i<m_item.size(); ++i)
-		{
-			std::string out = printToString((int)i);
+		if (fp) fwrite(out[i].c_str(), 1, out[i].size(), fp);
+		else feLogEx(m_pfem, out[i].c_str(),"");
+	}
 
-			if (fp) fprintf(fp, "%s", out.c_str());
-			else feLogEx(m_pfem, out.c_str(),"");
-		}
+	if (fp) fflush(fp);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+static void writeString(FILE* fp, const char* sz)
+{
+	int l = (int)strlen(sz);
+	fwrite(&l, sizeof(int), 1, fp);
+	if (l > 0) fwrite(sz, 1, l, fp);
+}
+
+static bool readString(FILE* fp, char* sz)
+{
+	int l = 0;
+	if ((fread(&l, sizeof(int), 1, fp) != 1) || (l < 0) || (l >= DataRecord::MAX_STRING)) return false;
+	if ((l > 0) && (fread(sz, 1, l, fp) != (size_t)l)) return false;
+	sz[l] = 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// val stores the values item by item. In the file they are stored column by column.
+void DataRecord::WriteBinary(int nstep, double ftime, const std::vector<double>& val)
+{
+	FILE* fp = m_fp;
+	int NI = (int)m_item.size();
+	int nd = Size();
+
+	if (m_bhdr == false)
+	{
+		int hdr[5] = { BINARY_TAG, BINARY_VERSION, nd, NI, (m_bcomm ? 1 : 0) };
+		fwrite(hdr, sizeof(int), 5, fp);
+		writeString(fp, m_szname);
+		writeString(fp, m_szfile);
+		writeString(fp, m_szdelim);
+		writeString(fp, m_szfmt);
+		if (NI > 0) fwrite(&m_item[0], sizeof(int), NI, fp);
+		m_bhdr = true;
 	}
-	else
+
+	std::vector<double> col(val.size());
+	for (int j = 0; j<nd; ++j)
+		for (int i = 0; i<NI; ++i) col[(size_t)j*NI + i] = val[(size_t)i*nd + j];
+
+	fwrite(&nstep, sizeof(int), 1, fp);
+	fwrite(&ftime, sizeof(double), 1, fp);
+	if (col.empty() == false) fwrite(&col[0], sizeof(double), col.size(), fp);
+	fflush(fp);
+}
+
+//-----------------------------------------------------------------------------
+bool DataRecord::ConvertToText(const char* szbin, const char* sztxt)
+{
+	FILE* fin = fopen(szbin, "rb");
+	if (fin == 0) return false;
+
+	// read the header
+	int hdr[5];
+	if ((fread(hdr, sizeof(int), 5, fin) != 5) || (hdr[0] != BINARY_TAG) || (hdr[1] != BINARY_VERSION) || (hdr[2] < 0) || (hdr[3] < 0))
+	{
+		fclose(fin);
+		return false;
+	}
+	int nd = hdr[2];
+	int NI = hdr[3];
+	bool bcomm = (hdr[4] != 0);
+
+	char szname[MAX_STRING], szfile[MAX_STRING], szdelim[MAX_STRING], szfmt[MAX_STRING];
+	bool bok = readString(fin, szname) && readString(fin, szfile) && readString(fin, szdelim) && readString(fin, szfmt);
+	std::vector<int> item(NI);
+	if (bok && (NI > 0)) bok = (fread(&item[0], sizeof(int), NI, fin) == (size_t)NI);
+	if (bok == false) { fclose(fin); return false; }
+
+	FILE* fout = fopen(sztxt, "wt");
+	if (fout == 0) { fclose(fin); return false; }
+
+	// convert the time steps
+	std::vector<double> col((size_t)NI*nd), val(nd);
+	int nstep;
+	double ftime;
+	while (fread(&nstep, sizeof(int), 1, fin) == 1)
 	{
-		// print using the format string
-		for (size_t i=0; i<m_item.size(); ++i)
+		if ((fread(&ftime, sizeof(double), 1, fin) != 1) || 
+			((col.empty() == false) && (fread(&col[0], sizeof(double), col.size(), fin) != col.size())))
+		{
+			bok = false;
+			break;
+		}
+
+		if (bcomm)
 		{
-			std::string out = printToFormatString((int)i);
+			fprintf(fout, "File = %s\n", szfile);
+			fprintf(fout,"*Step  = %d\n", nstep);
+			fprintf(fout,"*Time  = %.9lg\n", ftime);
+			fprintf(fout,"*Data  = %s\n", szname);
+		}
 
-			if (fp) fprintf(fp, "%s", out.c_str());
-			else feLogEx(m_pfem, out.c_str(),"");
+		for (int i = 0; i<NI; ++i)
+		{
+			for (int j = 0; j<nd; ++j) val[j] = col[(size_t)j*NI + i];
+			const double* pv = (nd > 0 ? &val[0] : nullptr);
+			std::string out = (szfmt[0] == 0 ? printToString(item[i], pv, nd, szdelim) : printToFormatString(item[i], i, pv, nd, szfmt));
+			fwrite(out.c_str(), 1, out.size(), fout);
 		}
 	}
 
-	if (fp) fflush(fp);
+	fclose(fout);
+	fclose(fin);
 
-	return true;
+	return bok;
 }
 
 //-----------------------------------------------------------------------------
@@ -333,8 +474,20 @@ void DataRecord::Serialize(DumpStream &ar)
 		m_fp = 0;
 		if (m_szfile[0] != 0)
 		{
+			// see if this is a binary data file
+			// (The binary flag is not stored in the archive.)
+			m_bbin = false;
+			FILE* fp = fopen(m_szfile, "rb");
+			if (fp)
+			{
+				int ntag = 0;
+				if ((fread(&ntag, sizeof(int), 1, fp) == 1) && (ntag == BINARY_TAG)) m_bbin = true;
+				fclose(fp);
+			}
+			m_bhdr = m_bbin;
+
 			// reopen data file for appending
-			m_fp = fopen(m_szfile, "a+");
+			m_fp = fopen(m_szfile, (m_bbin ? "ab" : "a+"));
 		}
 	}
 }
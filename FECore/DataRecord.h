@@ -53,11 +53,27 @@ public:
 };
 
 //-----------------------------------------------------------------------------
-
+//! A data record writes the values of a list of items (nodes, elements, ...) to
+//! the log file or to a separate data file. 
+//! The data file can be a text file or a binary file. A binary file starts with
+//! a header:
+//!		tag			: (int) BINARY_TAG
+//!		version		: (int) BINARY_VERSION
+//!		data		: (int) number of data values per item
+//!		items		: (int) number of items
+//!		comments	: (int) comment flag
+//!		name, file name, delimiter, format : (int) length, followed by the characters
+//!		item list	: (int[items])
+//! and then each time step is appended as:
+//!		step		: (int) time step
+//!		time		: (double) time
+//!		values		: (double[data][items]) the values, one column (i.e. all items) for each data value
+//! ConvertToText converts a binary file to the text file that would have been written.
 class FECORE_API DataRecord
 {
 public:
 	enum {MAX_DELIM=16, MAX_STRING=1024};
+	enum {BINARY_TAG = 0x52444546, BINARY_VERSION = 1};
 public:
 	DataRecord(FEModel* pfem, const char* szfile, int ntype);
 	virtual ~DataRecord();
@@ -70,6 +86,10 @@ public:
 	void SetDelim(const char* sz);
 	void SetFormat(const char* sz);
 	void SetComments(bool b) { m_bcomm = b; }
+	void SetBinary(bool b);
+
+	// convert a binary data file to a text file
+	static bool ConvertToText(const char* szbin, const char* sztxt);
 
 public:
 	virtual bool Initialize();
@@ -80,8 +100,7 @@ public:
 	virtual int Size() const = 0;
 
 private:
-	std::string printToString(int i);
-	std::string printToFormatString(int i);
+	void WriteBinary(int nstep, double ftime, const std::vector<double>& val);
 
 public:
 	int					m_nid;		//!< ID of data record
@@ -90,6 +109,8 @@ public:
 
 protected:
 	bool	m_bcomm;				//!< export comments or not
+	bool	m_bbin;					//!< write a binary data file
+	bool	m_bhdr;					//!< was the binary header written?
 	char	m_szname[MAX_STRING];	//!< name of expression
 	char	m_szdelim[MAX_DELIM];	//!< data delimitor
 	char	m_szdata[MAX_STRING];	//!< data expression
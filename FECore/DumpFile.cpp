@@ -28,10 +28,14 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "DumpFile.h"
+#include "DumpWriter.h"
+#include <string.h>
 
 DumpFile::DumpFile(FEModel& fem) : DumpStream(fem)
 {
 	m_fp = 0;
+	m_bmem = false;
+	m_pos = 0;
 }
 
 DumpFile::~DumpFile()
@@ -41,6 +45,15 @@ DumpFile::~DumpFile()
 
 bool DumpFile::Open(const char* szfile)
 {
+	if (DumpWriter::IsIncremental(szfile))
+	{
+		if (DumpWriter::Expand(szfile, m_buf) == false) return false;
+		m_bmem = true;
+		m_pos = 0;
+		DumpStream::Open(false, false);
+		return true;
+	}
+
 	m_fp = fopen(szfile, "rb");
 	if (m_fp == 0) return false;
 
@@ -73,6 +86,8 @@ void DumpFile::Close()
 {
 	if (m_fp) fclose(m_fp); 
 	m_fp = 0;
+	m_bmem = false;
+	std::vector<char>().swap(m_buf);
 }
 
 //! write buffer to archive
@@ -86,5 +101,14 @@ size_t DumpFile::write(const void* pd, size_t size, size_t count)
 size_t DumpFile::read(void* pd, size_t size, size_t count)
 {
 	assert(IsLoading());
+	if (m_bmem)
+	{
+		size_t navail = (m_buf.size() - m_pos) / (size ? size : 1);
+		if (count > navail) count = navail;
+		size_t nbytes = size*count;
+		if (nbytes) memcpy(pd, &m_buf[m_pos], nbytes);
+		m_pos += nbytes;
+		return count;
+	}
 	return fread(pd, size, count, m_fp);
 }
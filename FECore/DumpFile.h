@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 
 #include <stdio.h>
+#include <vector>
 #include "DumpStream.h"
 
 //-----------------------------------------------------------------------------
@@ -52,6 +53,7 @@ public:
 	virtual ~DumpFile();
 
 	//! Open archive for reading
+	//! Incremental checkpoints (see DumpWriter) are restored in memory and read from there.
 	bool Open(const char* szfile);
 
 	//! Open archive for writing
@@ -64,11 +66,15 @@ public:
 	void Close();
 
 	//! See if the archive is valid
-	bool IsValid() { return (m_fp != 0); }
+	bool IsValid() { return ((m_fp != 0) || (m_bmem)); }
 
 	//! Flush the archive
-	void Flush() { fflush(m_fp); }
+	void Flush() { if (m_fp) fflush(m_fp); }
 
 protected:
 	FILE*		m_fp;		//!< The actual file pointer
+
+	bool				m_bmem;	//!< reading from the restored archive
+	std::vector<char>	m_buf;	//!< restored archive of an incremental checkpoint
+	size_t				m_pos;	//!< read position in m_buf
 };
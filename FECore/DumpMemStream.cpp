@@ -34,7 +34,6 @@ SOFTWARE.*/
 //-----------------------------------------------------------------------------
 DumpMemStream::DumpMemStream(FEModel& fem) : DumpStream(fem)
 {
-	m_pb = 0;
 	m_pd = 0;
 	m_nsize = 0;
 	m_nreserved = 0;
@@ -45,8 +44,7 @@ DumpMemStream::DumpMemStream(FEModel& fem) : DumpStream(fem)
 //-----------------------------------------------------------------------------
 void DumpMemStream::clear()
 {
-	delete [] m_pb;
-	m_pb = 0;
+	std::vector<char>().swap(m_buf);
 	m_pd = 0;
 	m_nsize = 0;
 	m_nreserved = 0;
@@ -60,7 +58,7 @@ void DumpMemStream::clear()
 void DumpMemStream::Open(bool bsave, bool bshallow)
 {
 	DumpStream::Open(bsave, bshallow);
-	if (m_pb) set_position(0);
+	if (m_nreserved > 0) set_position(0);
 }
 
 //-----------------------------------------------------------------------------
@@ -73,7 +71,7 @@ DumpMemStream::~DumpMemStream()
 void DumpMemStream::set_position(size_t l)
 {
 	assert((l >= 0) && (l < m_nreserved));
-	m_pd = m_pb + l;
+	m_pd = m_buf.data() + l;
 	m_nsize = l;
 }
 
@@ -82,17 +80,20 @@ void DumpMemStream::grow_buffer(size_t l)
 {
 	if (l <= 0) return;
 
-	char* pnew = new char[m_nreserved + l];
-	if (m_pb)
-	{
-		memcpy(pnew, m_pb, m_nreserved);
-		delete [] m_pb;
-	}
-	m_pb = pnew;
-	m_pd = m_pb + m_nsize;
+	m_buf.resize(m_nreserved + l);
+	m_pd = m_buf.data() + m_nsize;
 	m_nreserved += l;
 }
 
+//-----------------------------------------------------------------------------
+void DumpMemStream::release(std::vector<char>& buf)
+{
+	assert(IsSaving());
+	m_buf.resize(m_nsize);
+	buf.swap(m_buf);
+	clear();
+}
+
 //-----------------------------------------------------------------------------
 size_t DumpMemStream::write(const void* pd, size_t size, size_t count)
 {
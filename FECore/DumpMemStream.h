@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "DumpStream.h"
+#include <vector>
 
 //-----------------------------------------------------------------------------
 //! The dump stream allows a class to record its internal state to a memory object
@@ -48,12 +49,18 @@ public: // overloaded from base class
 	size_t size() const { return m_nsize; }
 	size_t reserved() const { return m_nreserved; }
 
+	//! the stream data (the first size() bytes are valid when saving)
+	const char* data() const { return m_buf.data(); }
+
+	//! Move the stream data into buf, without copying it. The stream is empty afterwards.
+	void release(std::vector<char>& buf);
+
 protected:
 	void grow_buffer(size_t l);
 	void set_position(size_t l);
 
 private:
-	char*	m_pb;			//!< pointer to buffer
+	std::vector<char>	m_buf;	//!< buffer
 	char*	m_pd;			//!< position to insert a new value
 	size_t	m_nsize;		//!< size of stream
 	size_t	m_nreserved;	//!< size of reserved buffer
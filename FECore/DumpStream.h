@@ -264,6 +264,48 @@ template <> inline DumpStream& DumpStream::operator >> (std::vector<bool>& o)
 	return This;
 }
 
+// Vectors of plain numbers are streamed in one block. The format is the same
+// as for the general case, so archives remain compatible.
+template <> inline DumpStream& DumpStream::operator << (std::vector<double>& o)
+{
+	int N = (int) o.size();
+	write(&N, sizeof(int), 1);
+	if (N > 0) m_bytes_serialized += write(&o[0], sizeof(double), N);
+	return *this;
+}
+
+template <> inline DumpStream& DumpStream::operator >> (std::vector<double>& o)
+{
+	int N;
+	read(&N, sizeof(int), 1);
+	if (N > 0)
+	{
+		o.resize(N);
+		m_bytes_serialized += read(&o[0], sizeof(double), N);
+	}
+	return *this;
+}
+
+template <> inline DumpStream& DumpStream::operator << (std::vector<int>& o)
+{
+	int N = (int) o.size();
+	write(&N, sizeof(int), 1);
+	if (N > 0) m_bytes_serialized += write(&o[0], sizeof(int), N);
+	return *this;
+}
+
+template <> inline DumpStream& DumpStream::operator >> (std::vector<int>& o)
+{
+	int N;
+	read(&N, sizeof(int), 1);
+	if (N > 0)
+	{
+		o.resize(N);
+		m_bytes_serialized += read(&o[0], sizeof(int), N);
+	}
+	return *this;
+}
+
 template <typename A, typename B> DumpStream& DumpStream::operator << (std::map<A, B>& o)
 {
 	DumpStream& ar = *this;
@@ -0,0 +1,454 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "DumpWriter.h"
+#include <stdio.h>
+#include <string.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+// Layout of an incremental checkpoint:
+//  tag, version					: unsigned int
+//  archive size, archive hash		: unsigned long long
+//  base size, base hash			: unsigned long long
+//  nr of chunks, base name length	: unsigned int
+//  base file name					: chars
+//  chunks							: unsigned long long (offset in base) + unsigned int (size)
+// A chunk that is not found in the base has offset ~0, and is followed by its data.
+
+static const unsigned long long NEW_CHUNK = ~0ULL;
+
+//-----------------------------------------------------------------------------
+// FNV-1a hash, evaluated on 8-byte words
+static unsigned long long dump_hash(const char* pd, size_t nsize)
+{
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long h = 14695981039346656037ULL;
+	size_t n8 = nsize / 8;
+	for (size_t i = 0; i < n8; ++i)
+	{
+		unsigned long long w;
+		memcpy(&w, pd + 8*i, 8);
+		h = (h ^ w)*prime;
+	}
+	for (size_t i = 8*n8; i < nsize; ++i) h = (h ^ (unsigned char)pd[i])*prime;
+	return h;
+}
+
+//-----------------------------------------------------------------------------
+// random values for the rolling hash that finds the chunk boundaries
+struct GearTable
+{
+	unsigned long long	g[256];
+
+	GearTable()
+	{
+		// splitmix64, so the table is the same on all platforms
+		unsigned long long x = 0;
+		for (int i = 0; i < 256; ++i)
+		{
+			unsigned long long z = (x += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27))*0x94D049BB133111EBULL;
+			g[i] = z ^ (z >> 31);
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+// Split the data into chunks. A chunk ends where the rolling hash of the last
+// bytes has its low bits cleared, so the boundaries depend on the content and
+// not on the offset. The end offset of each chunk is returned.
+static void find_chunks(const char* pd, size_t nsize, vector<size_t>& ends)
+{
+	static const GearTable gear;
+
+	ends.clear();
+	size_t start = 0;
+	while (start < nsize)
+	{
+		size_t n = nsize - start;
+		size_t nmax = (n < DumpWriter::CHUNK_MAX ? n : (size_t) DumpWriter::CHUNK_MAX);
+		size_t len = nmax;
+		unsigned long long h = 0;
+		for (size_t i = DumpWriter::CHUNK_MIN; i < nmax; ++i)
+		{
+			h = (h << 1) + gear.g[(unsigned char)pd[start + i]];
+			if ((h & DumpWriter::CHUNK_MASK) == 0) { len = i + 1; break; }
+		}
+		start += len;
+		ends.push_back(start);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// The files are first written to a temporary file which then replaces the old
+// file. This way a crash while writing does not destroy the previous checkpoint.
+static FILE* create_temp(const string& file)
+{
+	string tmp = file + ".tmp";
+	return fopen(tmp.c_str(), "wb");
+}
+
+static bool commit_temp(FILE* fp, const string& file, bool bok)
+{
+	string tmp = file + ".tmp";
+	if (fclose(fp) != 0) bok = false;
+	if (bok == false) { remove(tmp.c_str()); return false; }
+#ifdef WIN32
+	remove(file.c_str());
+#endif
+	return (rename(tmp.c_str(), file.c_str()) == 0);
+}
+
+static bool file_exists(const string& file)
+{
+	FILE* fp = fopen(file.c_str(), "rb");
+	if (fp == nullptr) return false;
+	fclose(fp);
+	return true;
+}
+
+// strip the path from a file name
+static string file_title(const string& file)
+{
+	size_t n = file.find_last_of("/\\");
+	return (n == string::npos ? file : file.substr(n + 1));
+}
+
+// Read the header of an incremental checkpoint. The base file is stored next
+// to the checkpoint, so its name is returned with the path of the checkpoint.
+static bool read_header(FILE* fp, const string& file, unsigned long long sizes[4], unsigned int info[2], string& base)
+{
+	unsigned int hdr[2];
+	if ((fread(hdr, sizeof(hdr), 1, fp) != 1) || (hdr[0] != DumpWriter::DELTA_TAG) || (hdr[1] != DumpWriter::DELTA_VERSION) ||
+		(fread(sizes, sizeof(unsigned long long), 4, fp) != 4) ||
+		(fread(info, sizeof(unsigned int), 2, fp) != 2)) return false;
+
+	base.assign(info[1], 0);
+	if ((info[1] > 0) && (fread(&base[0], 1, info[1], fp) != info[1])) return false;
+	size_t n = file.find_last_of("/\\");
+	if (n != string::npos) base = file.substr(0, n + 1) + base;
+	return true;
+}
+
+// get the name of the base file of an incremental checkpoint
+static bool read_base_name(const string& file, string& base)
+{
+	FILE* fp = fopen(file.c_str(), "rb");
+	if (fp == nullptr) return false;
+	unsigned long long sizes[4];
+	unsigned int info[2];
+	bool bok = read_header(fp, file, sizes, info, base);
+	fclose(fp);
+	if (bok == false) base.clear();
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+DumpWriter::DumpWriter()
+{
+	m_nrebase = 0;
+	m_ndelta = 0;
+	m_baseSize = 0;
+	m_baseHash = 0;
+	m_nbase = 0;
+	m_writer = nullptr;
+	m_bok = true;
+}
+
+//-----------------------------------------------------------------------------
+DumpWriter::~DumpWriter()
+{
+	Wait();
+}
+
+//-----------------------------------------------------------------------------
+void DumpWriter::SetRebaseInterval(int n)
+{
+	Wait();
+	m_nrebase = n;
+	m_chunks.clear();
+	m_ndelta = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool DumpWriter::Write(const char* szfile, vector<char>& data)
+{
+	bool bok = Wait();
+
+	// a new file requires a new base
+	if (m_file != szfile)
+	{
+		m_chunks.clear();
+		m_baseFile.clear();
+	}
+
+	m_file = szfile;
+	m_data.swap(data);
+	vector<char>().swap(data);
+	m_writer = new std::thread(&DumpWriter::WriterThread, this);
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool DumpWriter::Wait()
+{
+	if (m_writer)
+	{
+		m_writer->join();
+		delete m_writer;
+		m_writer = nullptr;
+	}
+
+	bool bok = m_bok;
+	m_bok = true;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+void DumpWriter::WriterThread()
+{
+	// without incremental checkpoints we just write the archive
+	if (m_nrebase <= 1)
+	{
+		m_bok = WriteFull(m_file);
+		vector<char>().swap(m_data);
+
+		// the base of a previous incremental checkpoint is no longer needed
+		if (m_bok && (m_baseFile.empty() == false))
+		{
+			remove(m_baseFile.c_str());
+			m_baseFile.clear();
+		}
+		return;
+	}
+
+	// split the archive into chunks
+	size_t nsize = m_data.size();
+	vector<size_t> ends;
+	find_chunks(m_data.data(), nsize, ends);
+	vector<unsigned long long> hash(ends.size());
+	for (size_t i = 0; i < ends.size(); ++i)
+	{
+		size_t noff = (i == 0 ? 0 : ends[i - 1]);
+		hash[i] = dump_hash(&m_data[noff], ends[i] - noff);
+	}
+
+	// find out how much data is not in the last base
+	bool brebase = (m_chunks.empty() || (m_ndelta + 1 >= m_nrebase));
+	if (brebase == false)
+	{
+		size_t nnew = 0;
+		for (size_t i = 0; i < ends.size(); ++i)
+		{
+			size_t nlen = ends[i] - (i == 0 ? 0 : ends[i - 1]);
+			map<unsigned long long, CHUNK>::iterator it = m_chunks.find(hash[i]);
+			if ((it == m_chunks.end()) || (it->second.size != nlen)) nnew += nlen;
+		}
+
+		// if most of the archive changed, we might as well write a new base
+		if (2*nnew > nsize) brebase = true;
+	}
+
+	if (brebase)
+	{
+		// Write the new base and a checkpoint that refers to it. The base gets
+		// a new name, so that the previous checkpoint remains valid until the
+		// new checkpoint replaced it. Only then the previous base is removed.
+		string baseFile;
+		do {
+			char sznum[16];
+			snprintf(sznum, sizeof(sznum), ".base.%d", ++m_nbase);
+			baseFile = m_file + sznum;
+		}
+		while (file_exists(baseFile));
+		if (WriteFull(baseFile))
+		{
+			// the chunks of the previous base are kept in case the checkpoint fails
+			map<unsigned long long, CHUNK> oldChunks;
+			oldChunks.swap(m_chunks);
+			unsigned long long oldSize = m_baseSize;
+			unsigned long long oldHash = m_baseHash;
+
+			for (size_t i = 0; i < ends.size(); ++i)
+			{
+				size_t noff = (i == 0 ? 0 : ends[i - 1]);
+				CHUNK c = { noff, (unsigned int)(ends[i] - noff) };
+				m_chunks.insert(make_pair(hash[i], c));
+			}
+			m_baseSize = nsize;
+			m_baseHash = dump_hash(m_data.data(), nsize);
+
+			// the base of a checkpoint from a previous run is removed as well
+			string oldBase = m_baseFile;
+			if (oldBase.empty()) read_base_name(m_file, oldBase);
+			m_baseFile = baseFile;
+			m_bok = WriteDelta(m_file, ends, hash);
+			if (m_bok)
+			{
+				m_ndelta = 0;
+				if (oldBase.empty() == false) remove(oldBase.c_str());
+			}
+			else
+			{
+				// the previous checkpoint still refers to the previous base
+				remove(baseFile.c_str());
+				m_chunks.swap(oldChunks);
+				m_baseSize = oldSize;
+				m_baseHash = oldHash;
+				m_baseFile = oldBase;
+			}
+		}
+		else m_bok = false;
+	}
+	else
+	{
+		m_bok = WriteDelta(m_file, ends, hash);
+		m_ndelta++;
+	}
+
+	vector<char>().swap(m_data);
+}
+
+//-----------------------------------------------------------------------------
+bool DumpWriter::WriteFull(const string& file)
+{
+	FILE* fp = create_temp(file);
+	if (fp == nullptr) return false;
+	bool bok = (fwrite(m_data.data(), 1, m_data.size(), fp) == m_data.size());
+	return commit_temp(fp, file, bok);
+}
+
+//-----------------------------------------------------------------------------
+// Write the archive data as an incremental checkpoint of the current base. Chunks
+// that are found in the base are only referenced.
+bool DumpWriter::WriteDelta(const string& file, const vector<size_t>& ends, const vector<unsigned long long>& hash)
+{
+	FILE* fp = create_temp(file);
+	if (fp == nullptr) return false;
+
+	string base = file_title(m_baseFile);
+
+	unsigned int hdr[2] = { DELTA_TAG, DELTA_VERSION };
+	unsigned long long sizes[4] = { m_data.size(), dump_hash(m_data.data(), m_data.size()), m_baseSize, m_baseHash };
+	unsigned int info[2] = { (unsigned int)ends.size(), (unsigned int)base.size() };
+
+	bool bok = true;
+	bok &= (fwrite(hdr, sizeof(hdr), 1, fp) == 1);
+	bok &= (fwrite(sizes, sizeof(sizes), 1, fp) == 1);
+	bok &= (fwrite(info, sizeof(info), 1, fp) == 1);
+	bok &= (fwrite(base.c_str(), 1, base.size(), fp) == base.size());
+
+	for (size_t i = 0; (i < ends.size()) && bok; ++i)
+	{
+		size_t noff = (i == 0 ? 0 : ends[i - 1]);
+		unsigned int nlen = (unsigned int)(ends[i] - noff);
+
+		unsigned long long nbase = NEW_CHUNK;
+		map<unsigned long long, CHUNK>::const_iterator it = m_chunks.find(hash[i]);
+		if ((it != m_chunks.end()) && (it->second.size == nlen)) nbase = it->second.offset;
+
+		bok &= (fwrite(&nbase, sizeof(nbase), 1, fp) == 1);
+		bok &= (fwrite(&nlen, sizeof(nlen), 1, fp) == 1);
+		if (nbase == NEW_CHUNK) bok &= (fwrite(&m_data[noff], 1, nlen, fp) == nlen);
+	}
+
+	return commit_temp(fp, file, bok);
+}
+
+//-----------------------------------------------------------------------------
+bool DumpWriter::IsIncremental(const char* szfile)
+{
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+	unsigned int tag = 0;
+	size_t nread = fread(&tag, sizeof(tag), 1, fp);
+	fclose(fp);
+	return ((nread == 1) && (tag == DELTA_TAG));
+}
+
+//-----------------------------------------------------------------------------
+bool DumpWriter::Expand(const char* szfile, vector<char>& buf)
+{
+	FILE* fp = fopen(szfile, "rb");
+	if (fp == nullptr) return false;
+
+	unsigned long long sizes[4];
+	unsigned int info[2];
+	string baseFile;
+	if (read_header(fp, szfile, sizes, info, baseFile) == false)
+	{
+		fclose(fp);
+		return false;
+	}
+
+	size_t nsize = (size_t)sizes[0];
+	size_t nbase = (size_t)sizes[2];
+	unsigned int nchunks = info[0];
+
+	// read the base
+	vector<char> base(nbase);
+	FILE* fb = fopen(baseFile.c_str(), "rb");
+	if (fb == nullptr) { fclose(fp); return false; }
+	size_t nread = fread(base.data(), 1, nbase, fb);
+	fclose(fb);
+	if ((nread != nbase) || (dump_hash(base.data(), nbase) != sizes[3]))
+	{
+		// the base does not belong to this checkpoint
+		fclose(fp);
+		return false;
+	}
+
+	// assemble the archive from the chunks
+	buf.resize(nsize);
+	size_t pos = 0;
+	for (unsigned int i = 0; i < nchunks; ++i)
+	{
+		unsigned long long noff;
+		unsigned int nlen;
+		if ((fread(&noff, sizeof(noff), 1, fp) != 1) || (fread(&nlen, sizeof(nlen), 1, fp) != 1) ||
+			(pos + nlen > nsize)) { fclose(fp); return false; }
+
+		if (noff == NEW_CHUNK)
+		{
+			if (fread(&buf[pos], 1, nlen, fp) != nlen) { fclose(fp); return false; }
+		}
+		else
+		{
+			if (noff + nlen > nbase) { fclose(fp); return false; }
+			memcpy(&buf[pos], &base[(size_t)noff], nlen);
+		}
+		pos += nlen;
+	}
+	fclose(fp);
+
+	// make sure that the archive was restored correctly
+	return ((pos == nsize) && (dump_hash(buf.data(), nsize) == sizes[1]));
+}
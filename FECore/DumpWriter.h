@@ -0,0 +1,116 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <thread>
+
+//-----------------------------------------------------------------------------
+//! Writes restart archives on a background thread. The model is first serialized
+//! to memory (e.g. with a DumpMemStream) and the data is then handed to this class
+//! so that the solver can continue while the file is written.
+//!
+//! Optionally, checkpoints can be incremental. In that case the full archive is
+//! written to a base file (the dump file name with ".base.N" appended) and the dump
+//! file only stores the parts of the archive that are not found in the base. The
+//! archive is split into chunks at content-defined boundaries, and chunks are looked
+//! up by the hash of their content, so data that moved (e.g. because an earlier part
+//! of the archive changed size) is still found in the base. The writer only keeps
+//! the hashes of the base chunks, not the base itself.
+//! Every rebase-interval checkpoints (or when most of the archive has changed), a new
+//! base is written. A new base gets a new number, so the previous checkpoint and
+//! its base stay valid until the checkpoint that refers to the new base is written.
+//! DumpFile::Open recognizes incremental checkpoints and restores the full archive
+//! from the base file that is named in the checkpoint.
+class FECORE_API DumpWriter
+{
+public:
+	enum {
+		DELTA_TAG     = 0x44504D44,	// "DMPD"
+		DELTA_VERSION = 2,
+		CHUNK_MIN     = 16384,		// minimum chunk size
+		CHUNK_MAX     = 262144,		// maximum chunk size
+		CHUNK_MASK    = 0xFFFF		// a chunk ends on average 64K after the minimum size
+	};
+
+public:
+	DumpWriter();
+	~DumpWriter();
+
+	//! Set the number of checkpoints between full archives. A value of 0 or 1
+	//! turns incremental checkpoints off (i.e. every checkpoint is a full archive).
+	void SetRebaseInterval(int n);
+	int RebaseInterval() const { return m_nrebase; }
+
+	//! Queue the archive data for writing. The data is moved into the writer, so
+	//! data is empty on return. This waits for the previous checkpoint to
+	//! finish and returns false if writing the previous checkpoint failed.
+	bool Write(const char* szfile, std::vector<char>& data);
+
+	//! Wait for the pending checkpoint. Returns false if writing it failed.
+	bool Wait();
+
+	//! Returns true if a checkpoint was queued and was not waited for yet.
+	bool Pending() const { return (m_writer != nullptr); }
+
+public:
+	//! Checks whether the file is an incremental checkpoint.
+	static bool IsIncremental(const char* szfile);
+
+	//! Restore the full archive of an incremental checkpoint.
+	static bool Expand(const char* szfile, std::vector<char>& buf);
+
+private:
+	struct CHUNK
+	{
+		unsigned long long	offset;	//!< offset in base file
+		unsigned int		size;	//!< size of chunk
+	};
+
+	void WriterThread();
+	bool WriteFull(const std::string& file);
+	bool WriteDelta(const std::string& file, const std::vector<size_t>& ends, const std::vector<unsigned long long>& hash);
+
+private:
+	int		m_nrebase;		//!< rebase interval
+	int		m_ndelta;		//!< nr of incremental checkpoints since last base
+
+	std::string			m_file;		//!< name of the dump file
+	std::vector<char>	m_data;		//!< archive data of the pending checkpoint
+
+	std::map<unsigned long long, CHUNK>	m_chunks;	//!< chunks of the last base, by hash of their content
+	unsigned long long	m_baseSize;	//!< size of the base data
+	unsigned long long	m_baseHash;	//!< hash of the base data
+	std::string			m_baseFile;	//!< name of the last base file
+	int					m_nbase;	//!< number of the last base file
+
+	std::thread*	m_writer;
+	bool			m_bok;		//!< result of the last checkpoint
+};
@@ -38,6 +38,7 @@ SOFTWARE.*/
 #include "FELinearConstraintManager.h"
 #include "FEShellDomain.h"
 #include "FEMeshAdaptor.h"
+#include "Timer.h"
 
 REGISTER_SUPER_CLASS(FEAnalysis, FEANALYSIS_ID);
 
@@ -79,6 +80,8 @@ FEAnalysis::FEAnalysis(FEModel* fem) : FECoreBase(fem)
 	m_ntotiter   = 0;		// total nr of non-linear iterations
 	m_ntimesteps = 0;		// time steps completed
 	m_ntotrhs    = 0;		// total nr of right hand side evaluations
+	m_nsnap      = 0;		// nr of state snapshots
+	m_snapsize   = 0;		// size of largest snapshot
 
 	// --- I/O Data ---
 	m_nplot   = FE_PLOT_MAJOR_ITRS;
@@ -192,6 +195,8 @@ void FEAnalysis::Reset()
 	m_ntotiter   = 0;		// total nr of non-linear iterations
 	m_ntimesteps = 0;		// time steps completed
 	m_ntotrhs    = 0;		// total nr of right hand side evaluations
+	m_nsnap      = 0;		// nr of state snapshots
+	m_snapsize   = 0;		// size of largest snapshot
 
 	m_dt = m_dt0;
 
@@ -370,6 +375,8 @@ bool FEAnalysis::Solve()
 	}
 
 	// dump stream for running restarts
+	// (The stream's buffer is reused for all time steps, so after the first
+	//  snapshot no more memory needs to be allocated.)
 	DumpMemStream dmp(fem);
 
 	// repeat for all timesteps
@@ -380,8 +387,12 @@ bool FEAnalysis::Solve()
 		// we need to retry this time step
 		if (m_timeController && (m_timeController->m_maxretries > 0))
 		{ 
-			dmp.clear();
-			fem.Serialize(dmp); 
+			TRACK_TIME(TimerID::Timer_Snapshot);
+			dmp.Open(true, true);
+			fem.Serialize(dmp);
+
+			m_nsnap++;
+			if (dmp.size() > m_snapsize) m_snapsize = dmp.size();
 		}
 
 		// Inform that the time is about to change. (Plugins can use 
@@ -463,8 +474,11 @@ bool FEAnalysis::Solve()
 			if (m_timeController && (m_timeController->m_nretries < m_timeController->m_maxretries))
 			{
 				// restore the previous state
-				dmp.Open(false, true);
-				fem.Serialize(dmp);
+				{
+					TRACK_TIME(TimerID::Timer_Snapshot);
+					dmp.Open(false, true);
+					fem.Serialize(dmp);
+				}
 				
 				// let's try again
 				m_timeController->Retry();
@@ -166,6 +166,12 @@ public:
 		int		m_ntimesteps;	//!< time steps completed
 	//}
 
+	// --- Retry Data ---
+	//{
+		int		m_nsnap;		//!< nr of state snapshots taken for retries
+		size_t	m_snapsize;		//!< size (in bytes) of the largest snapshot
+	//}
+
 	// --- I/O Data ---
 	//{
 		int		m_nplot;		//!< plot level
@@ -79,12 +79,20 @@ bool Project2Edge(const vec3d& p0, const vec3d& p1, const vec3d& x, vec3d& q)
 //! coordinates of the projection is return in r and the spatial coordinates in q.
 //! 
 FESurfaceElement* FEClosestPointProjection::Project(vec3d& x, vec3d& q, vec2d& r)
+{
+	int nhint = -1;
+	return Project(x, q, r, nhint);
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceElement* FEClosestPointProjection::Project(vec3d& x, vec3d& q, vec2d& r, int& nhint)
 {
 	// get the mesh
 	FEMesh& mesh = *m_surf.GetMesh();
 
 	// let's find the closest node
-	int mn = m_SNQ.Find(x);
+	int mn = m_SNQ.Find(x, nhint);
+	nhint = mn;
 
 	// mn is a local index, so get the global node number too
 	int m = m_surf.NodeIndex(mn);
@@ -47,6 +47,11 @@ public:
 	//! Project a point onto surface
 	FESurfaceElement* Project(vec3d& x, vec3d& q, vec2d& r);
 
+	//! Project a point onto surface. The (local) node index nhint is used to warm-start
+	//! the nearest-neighbor search and is set to the closest node on return.
+	//! This function is thread safe.
+	FESurfaceElement* Project(vec3d& x, vec3d& q, vec2d& r, int& nhint);
+
 	//! Project a node onto a surface
 	FESurfaceElement* Project(int n, vec3d& q, vec2d& r);
 
@@ -263,8 +263,11 @@ bool FEPlotParameter::Save(FEDomain& dom, FEDataStream& a)
 
 		if (m_param.type() == FE_PARAM_DOUBLE_MAPPED)
 		{
+			// evaluate the parameter at all the integration points at once
 			FEParamDouble& mapDouble = dynamic_cast<FEParamDouble&>(map);
-			writeNodalProjectedElementValues<double>(sd, a, mapDouble);
+			vector<double> val;
+			mapDouble(sd, val);
+			writeNodalProjectedElementValues(sd, a, val);
 		}
 		else if (m_param.type() == FE_PARAM_VEC3D_MAPPED)
 		{
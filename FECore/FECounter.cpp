@@ -0,0 +1,68 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FECounter.h"
+#include <vector>
+#include <mutex>
+
+//-----------------------------------------------------------------------------
+// The registry is allocated on first use since counters are static objects
+// in other modules and may be constructed before this file's statics.
+static std::vector<FECounter*>& registry()
+{
+	static std::vector<FECounter*>* reg = new std::vector<FECounter*>;
+	return *reg;
+}
+
+static std::mutex& registry_lock()
+{
+	static std::mutex* lock = new std::mutex;
+	return *lock;
+}
+
+//-----------------------------------------------------------------------------
+FECounter::FECounter(const char* szname) : m_szname(szname), m_value(0)
+{
+	std::lock_guard<std::mutex> lock(registry_lock());
+	registry().push_back(this);
+}
+
+//-----------------------------------------------------------------------------
+int FECounter::Counters()
+{
+	std::lock_guard<std::mutex> lock(registry_lock());
+	return (int)registry().size();
+}
+
+//-----------------------------------------------------------------------------
+FECounter* FECounter::GetCounter(int i)
+{
+	std::lock_guard<std::mutex> lock(registry_lock());
+	return registry()[i];
+}
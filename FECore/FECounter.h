@@ -0,0 +1,66 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <atomic>
+
+//-----------------------------------------------------------------------------
+//! A named event counter. Counters are created as static objects by the
+//! modules that want to report statistics and register themselves so that
+//! the application can print all counters at the end of a run without
+//! knowing about the classes that use them.
+class FECORE_API FECounter
+{
+public:
+	FECounter(const char* szname);
+
+	//! increment the counter (thread safe)
+	void Add(long long n = 1) { m_value.fetch_add(n, std::memory_order_relaxed); }
+
+	//! get the current value
+	long long Value() const { return m_value.load(); }
+
+	//! get the name of the counter
+	const char* GetName() const { return m_szname; }
+
+public:
+	//! number of registered counters
+	static int Counters();
+
+	//! get a registered counter
+	static FECounter* GetCounter(int i);
+
+private:
+	FECounter(const FECounter&) = delete;
+	void operator = (const FECounter&) = delete;
+
+private:
+	const char*				m_szname;
+	std::atomic<long long>	m_value;
+};
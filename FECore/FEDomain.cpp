@@ -53,24 +53,68 @@ void FEDomain::SetMatID(int mid)
 // This routine allocates the material point data for the element's integration points.
 // Currently, this has to be called after the elements have been assigned a type (since this
 // determines how many integration points an element gets). 
+// The material points are allocated from the domain's arena. After the points
+// of the first element are created, the memory for the remaining elements is 
+// reserved (assuming all elements need the same amount) and initialized in the
+// same parallel order as the element loops. The same is done for the field
+// arrays, so that the fields of all the points of the domain are contiguous.
 void FEDomain::CreateMaterialPointData()
 {
 	FEMaterial* pmat = GetMaterial();
 	FEMesh* mesh = GetMesh();
-	if (pmat) ForEachElement([=](FEElement& el) {
-
-		vec3d r[FEElement::MAX_NODES];
-		int ne = el.Nodes();
-		for (int i = 0; i < ne; ++i) r[i] = mesh->Node(el.m_node[i]).m_r0;
+	if (pmat)
+	{
+		FEMaterialPointArena::Scope scope(m_arena);
 
-		for (int k = 0; k < el.GaussPoints(); ++k)
+		int NE = Elements();
+		for (int i = 0; i < NE; ++i)
 		{
-			FEMaterialPoint* mp = pmat->CreateMaterialPointData();
-			mp->m_r0 = el.Evaluate(r, k);
-			mp->m_index = k;
-			el.SetMaterialPointData(mp, k);
+			FEElement& el = ElementRef(i);
+
+			vec3d r[FEElement::MAX_NODES];
+			int ne = el.Nodes();
+			for (int j = 0; j < ne; ++j) r[j] = mesh->Node(el.m_node[j]).m_r0;
+
+			size_t n0 = m_arena.Allocated();
+			vector<size_t> f0 = m_arena.FieldEntries();
+			for (int k = 0; k < el.GaussPoints(); ++k)
+			{
+				FEMaterialPoint* mp = pmat->CreateMaterialPointData();
+				mp->m_r0 = el.Evaluate(r, k);
+				mp->m_index = k;
+				el.SetMaterialPointData(mp, k);
+				m_types.Assign(mp);
+			}
+
+			if ((i == 0) && (NE > 1))
+			{
+				size_t n = m_arena.Allocated() - n0;
+				m_arena.Reserve(n*(NE - 1), n);
+				m_arena.ReserveFields(f0, NE - 1);
+			}
 		}
-	});
+	}
+
+	UpdateMaterialPointTable();
+}
+
+//-----------------------------------------------------------------------------
+// The material point table gives domain loops a single flat index over all the
+// integration points of this domain, so they don't need to go through the elements.
+void FEDomain::UpdateMaterialPointTable()
+{
+	int NEL = Elements();
+	int nmp = 0;
+	for (int i = 0; i < NEL; ++i) nmp += ElementRef(i).GaussPoints();
+
+	m_mp.clear();
+	m_mp.reserve(nmp);
+	for (int i = 0; i < NEL; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		int nint = el.GaussPoints();
+		for (int j = 0; j < nint; ++j) m_mp.push_back(el.GetMaterialPoint(j));
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -118,6 +162,7 @@ void FEDomain::Serialize(DumpStream& ar)
 			int NEL = 0;
 			ar >> NEL;
 			Create(NEL, espec);
+			FEMaterialPointArena::Scope scope(m_arena);
 			for (int i = 0; i < NEL; ++i)
 			{
 				FEElement& el = ElementRef(i);
@@ -127,8 +172,11 @@ void FEDomain::Serialize(DumpStream& ar)
 				{
 					el.SetMaterialPointData(pmat->CreateMaterialPointData(), j);
 					el.GetMaterialPoint(j)->Serialize(ar);
+					m_types.Assign(el.GetMaterialPoint(j));
 				}
 			}
+			UpdateMaterialPointTable();
+			PackConnectivity();
 		}
 	}
 }
@@ -161,7 +209,7 @@ void FEDomain::UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm)
 	{
 		int n = el.m_node[i];
 		FENode& node = mesh->Node(n);
-		vector<int>& id = node.m_ID;
+		int* id = node.m_ID;
 		for (int j = 0; j<ndofs; ++j) lm[i*ndofs + j] = id[dof[j]];
 	}
 }
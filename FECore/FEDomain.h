@@ -53,6 +53,13 @@ public:
 	//! \todo Perhaps I can make this part of the "creation" routine
 	void CreateMaterialPointData();
 
+	//! return the number of material points in this domain
+	int MaterialPoints() const { return (int)m_mp.size(); }
+
+	//! return a material point from the domain's material point table.
+	//! The points are stored element by element, in the same order as the element loops.
+	FEMaterialPoint* MaterialPoint(int n) { return m_mp[n]; }
+
 	// serialization
 	void Serialize(DumpStream& ar) override;
 
@@ -83,4 +90,12 @@ protected:
 
 	// helper function for unpacking element dofs
 	void UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm);
+
+	// rebuild the material point table from the element state data
+	void UpdateMaterialPointTable();
+
+private:
+	vector<FEMaterialPoint*>	m_mp;	//!< flat table of all the material points of this domain
+	FEMaterialPointTypeCache	m_types;	//!< type tables for the material points of this domain
+	FEMaterialPointArena		m_arena;	//!< memory for the material points of this domain
 };
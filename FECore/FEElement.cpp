@@ -37,7 +37,12 @@ FEElementState::FEElementState(const FEElementState& s)
 	m_data.resize( s.m_data.size() );
 	for (size_t i=0; i<m_data.size(); ++i) 
 	{
-		if (s.m_data[i]) m_data[i] = s.m_data[i]->Copy(); else m_data[i] = 0;
+		if (s.m_data[i])
+		{
+			m_data[i] = s.m_data[i]->Copy();
+			FEMaterialPointTypeCache::AssignCopy(m_data[i]);
+		}
+		else m_data[i] = 0;
 	}
 }
 
@@ -47,11 +52,56 @@ FEElementState& FEElementState::operator = (const FEElementState& s)
 	m_data.resize( s.m_data.size() );
 	for (size_t i=0; i<m_data.size(); ++i) 
 	{
-		if (s.m_data[i]) m_data[i] = s.m_data[i]->Copy(); else m_data[i] = 0;
+		if (s.m_data[i])
+		{
+			m_data[i] = s.m_data[i]->Copy();
+			FEMaterialPointTypeCache::AssignCopy(m_data[i]);
+		}
+		else m_data[i] = 0;
 	}
 	return (*this);
 }
 
+//-----------------------------------------------------------------------------
+FEElementConnectivity::FEElementConnectivity(const FEElementConnectivity& c) : m_data(nullptr), m_size(0), m_bown(false)
+{
+	resize(c.m_size);
+	for (int i = 0; i < m_size; ++i) m_data[i] = c.m_data[i];
+}
+
+//-----------------------------------------------------------------------------
+FEElementConnectivity& FEElementConnectivity::operator = (const FEElementConnectivity& c)
+{
+	if (this == &c) return (*this);
+	resize(c.m_size);
+	for (int i = 0; i < m_size; ++i) m_data[i] = c.m_data[i];
+	return (*this);
+}
+
+//-----------------------------------------------------------------------------
+void FEElementConnectivity::resize(int n)
+{
+	if ((n == m_size) && (m_data || (n == 0))) return;
+
+	if (m_bown) delete [] m_data;
+	m_data = (n > 0 ? new int[n]() : nullptr);
+	m_size = n;
+	m_bown = (n > 0);
+}
+
+//-----------------------------------------------------------------------------
+void FEElementConnectivity::Bind(int* pd, bool bcopy)
+{
+	if (pd == m_data) return;
+	if (bcopy)
+	{
+		for (int i = 0; i < m_size; ++i) pd[i] = m_data[i];
+	}
+	if (m_bown) delete [] m_data;
+	m_data = pd;
+	m_bown = false;
+}
+
 //-----------------------------------------------------------------------------
 //! clear material point data
 void FEElement::ClearData()
@@ -215,8 +265,9 @@ void FEElement::Serialize(DumpStream& ar)
 		int type = Type();
 		ar << type;
 		ar << m_nID << m_lid << m_mat;
-		ar << m_node;
-		ar << m_lnode;
+		int n = m_node.size();
+		ar << n; for (int i = 0; i < n; ++i) ar << m_node[i];
+		ar << n; for (int i = 0; i < n; ++i) ar << m_lnode[i];
 		ar << m_lm << m_val;
 		ar << m_status;
 	}
@@ -225,8 +276,9 @@ void FEElement::Serialize(DumpStream& ar)
 		int ntype;
 		ar >> ntype; SetType(ntype);
 		ar >> m_nID >> m_lid >> m_mat;
-		ar >> m_node;
-		ar >> m_lnode;		
+		int n;
+		ar >> n; m_node.resize(n); for (int i = 0; i < n; ++i) ar >> m_node[i];
+		ar >> n; m_lnode.resize(n); for (int i = 0; i < n; ++i) ar >> m_lnode[i];
 		ar >> m_lm >> m_val;
 		ar >> m_status;
 	}
@@ -236,7 +288,7 @@ void FEElement::Serialize(DumpStream& ar)
 int FEElement::GetFace(int nface, int* nf) const
 {
 	int nn = -1;
-	const int* en = &(m_node[0]);
+	const int* en = m_node.data();
 	switch (Shape())
 	{
 	case ET_HEX8:
@@ -66,6 +66,49 @@ private:
 	vector<FEMaterialPoint*>	m_data;
 };
 
+//-----------------------------------------------------------------------------
+//! The FEElementConnectivity class stores the node numbers of an element. The
+//! numbers are either stored in a buffer owned by the element, or in the packed 
+//! connectivity arrays of the mesh partition that contains the element (see 
+//! FEMeshPartition::PackConnectivity). Copying and assignment always copy the
+//! node numbers.
+class FECORE_API FEElementConnectivity
+{
+public:
+	FEElementConnectivity() : m_data(nullptr), m_size(0), m_bown(false) {}
+	FEElementConnectivity(const FEElementConnectivity& c);
+	~FEElementConnectivity() { if (m_bown) delete [] m_data; }
+
+	FEElementConnectivity& operator = (const FEElementConnectivity& c);
+
+	//! set the number of nodes. This allocates an owned buffer if the size changes.
+	void resize(int n);
+
+	//! number of nodes
+	int size() const { return m_size; }
+
+	int& operator [] (int i) { return m_data[i]; }
+	const int& operator [] (int i) const { return m_data[i]; }
+
+	int* data() { return m_data; }
+	const int* data() const { return m_data; }
+
+	const int* begin() const { return m_data; }
+	const int* end() const { return m_data + m_size; }
+
+	//! copy to a vector
+	operator std::vector<int> () const { return std::vector<int>(m_data, m_data + m_size); }
+
+	//! point to external storage of size(). If bcopy is true, the node numbers are copied
+	//! to the new location first.
+	void Bind(int* pd, bool bcopy);
+
+private:
+	int*	m_data;
+	int		m_size;
+	bool	m_bown;
+};
+
 //-----------------------------------------------------------------------------
 //! Base class for all element classes
 
@@ -217,11 +260,11 @@ protected:
 	FEMeshPartition * m_part;	//!< parent mesh partition
 
 public:
-	vector<int>		m_node;		//!< connectivity
+	FEElementConnectivity	m_node;		//!< connectivity
 
 	// This array stores the local node numbers, that is the node numbers
 	// into the node list of a domain.
-	vector<int>		m_lnode;	//!< local connectivity
+	FEElementConnectivity	m_lnode;	//!< local connectivity
 
 public: 
 	// NOTE: Work in progress
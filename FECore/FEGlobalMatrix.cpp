@@ -35,7 +35,13 @@ SOFTWARE.*/
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el)
 {
-	m_node = el.m_node;
+	m_node.assign(el.m_node.begin(), el.m_node.end());
+}
+
+//-----------------------------------------------------------------------------
+void FEElementMatrix::SetNodes(const FEElementConnectivity& en)
+{
+	m_node.assign(en.begin(), en.end());
 }
 
 //-----------------------------------------------------------------------------
@@ -60,7 +66,7 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) : matrix((int)lmi.size(), (int)lmi.size())
 {
-	m_node = el.m_node;
+	m_node.assign(el.m_node.begin(), el.m_node.end());
 	m_lmi = lmi;
 	m_lmj = lmi;
 }
@@ -68,7 +74,7 @@ FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) :
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el, vector<int>& lmi, vector<int>& lmj) : matrix((int)lmi.size(), (int)lmj.size())
 {
-	m_node = el.m_node;
+	m_node.assign(el.m_node.begin(), el.m_node.end());
 	m_lmi = lmi;
 	m_lmj = lmj;
 };
@@ -37,6 +37,7 @@ class FEModel;
 class FEMesh;
 class FESurface;
 class FEElement;
+class FEElementConnectivity;
 
 //-----------------------------------------------------------------------------
 //! This class represents an element matrix, i.e. a matrix of values and the row and
@@ -78,6 +79,7 @@ public:
 
 	// Set the node indices
 	void SetNodes(const std::vector<int>& en) { m_node = en; }
+	void SetNodes(const FEElementConnectivity& en);
 
 	// get the nodes
 	const std::vector<int>& Nodes() const { return m_node; }
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEGlobalVector.h"
+#include "FEElement.h"
 #include "vec3d.h"
 #include "FEModel.h"
 
@@ -64,6 +65,16 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 	}
 }
 
+//-----------------------------------------------------------------------------
+// The node numbers are copied to a per-thread buffer so that assembling from the
+// element connectivity does not allocate.
+void FEGlobalVector::Assemble(const FEElementConnectivity& en, vector<int>& elm, vector<double>& fe, bool bdom)
+{
+	static thread_local vector<int> nodes;
+	nodes.assign(en.begin(), en.end());
+	Assemble(nodes, elm, fe, bdom);
+}
+
 //-----------------------------------------------------------------------------
 //! \todo This function does not add to m_Fr. Is this a problem?
 void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
@@ -33,6 +33,8 @@ using namespace std;
 
 class FEModel;
 
+class FEElementConnectivity;
+
 //-----------------------------------------------------------------------------
 //! This class represents a global system array. It provides functions to assemble
 //! local (element) vectors into this array
@@ -48,6 +50,9 @@ public:
 	//! Assemble the element vector into this global vector
 	virtual void Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom = false);
 
+	//! Assemble the element vector into this global vector, using the element's connectivity
+	void Assemble(const FEElementConnectivity& en, vector<int>& elm, vector<double>& fe, bool bdom = false);
+
 	//! Assemble into this global vector
 	virtual void Assemble(vector<int>& lm, vector<double>& fe);
 
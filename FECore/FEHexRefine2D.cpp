@@ -416,14 +416,9 @@ void FEHexRefine2D::UpdateNewNodes(FEModel& fem)
 	// now, generate new nodes
 	mesh.AddNodes(newNodes);
 
-	// assign dofs to new nodes
+	// (the new nodes were given initialized dof data by AddNodes)
 	int MAX_DOFS = fem.GetDOFS().GetTotalDOFS();
 	m_NN = mesh.Nodes();
-	for (int i = m_N0; i<m_NN; ++i)
-	{
-		FENode& node = mesh.Node(i);
-		node.SetDOFS(MAX_DOFS);
-	}
 
 	// update the position of these new nodes
 	n = 0;
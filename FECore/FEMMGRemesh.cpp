@@ -547,17 +547,17 @@ bool FEMMGRemesh::MMG::build_new_mesh(MMG5_pMesh mmgMesh, MMG5_pSol mmgSol, FEMo
 		}
 	}
 
-	// reallocate nodes
+	// reallocate nodes and reset their dof data
 	mesh.CreateNodes(nodes);
+	mesh.SetDOFS(MAX_DOFS);
 
 	// assign dofs to new nodes
 	for (int i = 0; i < nodes; ++i)
 	{
 		FENode& node = mesh.Node(i);
-		node.SetDOFS(MAX_DOFS);
 		node.m_r0 = nodePos0[i];
 		node.m_rt = nodePos[i];
-		for (int j = 0; j < node.m_ID.size(); ++j) {
+		for (int j = 0; j < node.dofs(); ++j) {
 			node.set(j, nodeVal[i][j]);
 		}
 		node.UpdateValues();
@@ -30,15 +30,316 @@ SOFTWARE.*/
 #include "FEMaterialPoint.h"
 #include "DumpStream.h"
 #include <string.h>
+#include <assert.h>
+#include <map>
+#include <mutex>
+#include <typeindex>
 
+//-----------------------------------------------------------------------------
+FEMaterialPointTypeTable::FEMaterialPointTypeTable(const std::type_info* ti) : m_type(ti)
+{
+	for (int i = 0; i < MAX_TYPES; ++i) m_offset[i].store((signed char)UNRESOLVED);
+}
+
+//-----------------------------------------------------------------------------
+// (the map is never destroyed, since plugins can look up types after the static objects are destroyed)
+int FEMaterialPoint::TypeIndex(const std::type_index& type)
+{
+	static std::mutex* lock = new std::mutex;
+	static std::map<std::type_index, int>* index = new std::map<std::type_index, int>;
+
+	std::lock_guard<std::mutex> guard(*lock);
+	std::map<std::type_index, int>::iterator it = index->find(type);
+	if (it != index->end()) return it->second;
+	int n = (int)index->size();
+	index->insert(std::make_pair(type, n));
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+// The slow lookups are counted per thread, so the threads of the element loops
+// don't compete for the same counter. The counters register themselves, and
+// the counts of threads that have finished are added to the retired count.
+// (The registry is never destroyed, since threads can exit after the static
+// objects are destroyed.)
+namespace {
+	class SlowLookupCounter;
+
+	struct CounterRegistry
+	{
+		std::mutex					lock;
+		vector<SlowLookupCounter*>	counters;
+		long long					retired = 0;
+	};
+
+	CounterRegistry& Registry()
+	{
+		static CounterRegistry* registry = new CounterRegistry;
+		return *registry;
+	}
+
+	class SlowLookupCounter
+	{
+	public:
+		SlowLookupCounter() : m_count(0)
+		{
+			CounterRegistry& r = Registry();
+			std::lock_guard<std::mutex> lock(r.lock);
+			r.counters.push_back(this);
+		}
+
+		~SlowLookupCounter()
+		{
+			CounterRegistry& r = Registry();
+			std::lock_guard<std::mutex> lock(r.lock);
+			r.retired += Count();
+			for (size_t i = 0; i < r.counters.size(); ++i)
+			{
+				if (r.counters[i] == this) { r.counters.erase(r.counters.begin() + i); break; }
+			}
+		}
+
+		// only the owning thread increments the counter, so no atomic read-modify-write is needed
+		void Add() { m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+		long long Count() const { return m_count.load(std::memory_order_relaxed); }
+
+	private:
+		std::atomic<long long>	m_count;
+	};
+
+	thread_local SlowLookupCounter s_slowLookups;
+}
+
+void FEMaterialPoint::AddSlowLookup()
+{
+	s_slowLookups.Add();
+}
+
+long long FEMaterialPoint::SlowLookups()
+{
+	CounterRegistry& r = Registry();
+	std::lock_guard<std::mutex> lock(r.lock);
+	long long n = r.retired;
+	for (size_t i = 0; i < r.counters.size(); ++i) n += r.counters[i]->Count();
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+// size of the blocks the arena allocates when it runs out of memory
+static const size_t ARENA_BLOCK_SIZE = 1 << 20;
+
+// allocations are aligned to this size
+static const size_t ARENA_ALIGN = 16;
+
+static thread_local FEMaterialPointArena* s_activeArena = nullptr;
+
+FEMaterialPointArena::FEMaterialPointArena()
+{
+	m_allocated = 0;
+}
+
+FEMaterialPointArena::~FEMaterialPointArena()
+{
+	for (size_t i = 0; i < m_block.size(); ++i) delete [] m_block[i].data;
+	m_block.clear();
+
+	for (size_t i = 0; i < m_field.size(); ++i)
+	{
+		vector<Block>& block = m_field[i].block;
+		for (size_t j = 0; j < block.size(); ++j) delete [] block[j].data;
+	}
+	m_field.clear();
+}
+
+void FEMaterialPointArena::AddBlock(vector<Block>& blocks, size_t size)
+{
+	Block b;
+	b.data = new char[size];
+	b.size = size;
+	b.used = 0;
+	blocks.push_back(b);
+}
+
+// Zero the memory in chunks, using the same static schedule as the element loops.
+static void FirstTouch(char* p, size_t size, size_t chunkSize)
+{
+	if (chunkSize == 0) chunkSize = size;
+	int chunks = (int)((size + chunkSize - 1) / chunkSize);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < chunks; ++i)
+	{
+		size_t n0 = i*chunkSize;
+		size_t n = (n0 + chunkSize <= size ? chunkSize : size - n0);
+		memset(p + n0, 0, n);
+	}
+}
+
+void* FEMaterialPointArena::Allocate(size_t size)
+{
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	if (m_block.empty() || (m_block.back().used + size > m_block.back().size))
+	{
+		AddBlock(m_block, size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE);
+	}
+
+	Block& b = m_block.back();
+	void* p = b.data + b.used;
+	b.used += size;
+	m_allocated += size;
+	return p;
+}
+
+void FEMaterialPointArena::Reserve(size_t size, size_t chunkSize)
+{
+	if (size == 0) return;
+	if (m_block.empty() || (m_block.back().used + size > m_block.back().size)) AddBlock(m_block, size);
+
+	Block& b = m_block.back();
+	FirstTouch(b.data + b.used, size, chunkSize);
+}
+
+size_t FEMaterialPointArena::Capacity() const
+{
+	size_t n = 0;
+	for (size_t i = 0; i < m_block.size(); ++i) n += m_block[i].size;
+	for (size_t i = 0; i < m_field.size(); ++i)
+	{
+		const vector<Block>& block = m_field[i].block;
+		for (size_t j = 0; j < block.size(); ++j) n += block[j].size;
+	}
+	return n;
+}
+
+static std::atomic<int> s_fieldCount(0);
+
+int FEMaterialPointArena::NewField()
+{
+	return s_fieldCount++;
+}
+
+void* FEMaterialPointArena::AllocateField(int field, size_t size)
+{
+	assert(field >= 0);
+	if (field >= (int)m_field.size())
+	{
+		Field f;
+		f.size = 0;
+		f.entries = 0;
+		m_field.resize(field + 1, f);
+	}
+
+	Field& f = m_field[field];
+	if (f.size == 0) f.size = size;
+	assert(f.size == size);
+
+	// the blocks of a field store a whole number of entries
+	if (f.block.empty() || (f.block.back().used + size > f.block.back().size))
+	{
+		AddBlock(f.block, size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE - ARENA_BLOCK_SIZE % size);
+	}
+
+	Block& b = f.block.back();
+	void* p = b.data + b.used;
+	b.used += size;
+	f.entries++;
+	return p;
+}
+
+vector<size_t> FEMaterialPointArena::FieldEntries() const
+{
+	vector<size_t> n(m_field.size());
+	for (size_t i = 0; i < m_field.size(); ++i) n[i] = m_field[i].entries;
+	return n;
+}
+
+void FEMaterialPointArena::ReserveFields(const vector<size_t>& n0, size_t copies)
+{
+	for (size_t i = 0; i < m_field.size(); ++i)
+	{
+		Field& f = m_field[i];
+		size_t n = f.entries - (i < n0.size() ? n0[i] : 0);
+		if ((n == 0) || (copies == 0)) continue;
+
+		size_t chunkSize = n*f.size;
+		size_t size = chunkSize*copies;
+		if (f.block.back().used + size > f.block.back().size) AddBlock(f.block, size);
+
+		Block& b = f.block.back();
+		FirstTouch(b.data + b.used, size, chunkSize);
+	}
+}
+
+FEMaterialPointArena* FEMaterialPointArena::Active()
+{
+	return s_activeArena;
+}
+
+FEMaterialPointArena::Scope::Scope(FEMaterialPointArena& arena)
+{
+	m_prev = s_activeArena;
+	s_activeArena = &arena;
+}
+
+FEMaterialPointArena::Scope::~Scope()
+{
+	s_activeArena = m_prev;
+}
+
+//-----------------------------------------------------------------------------
+// Every allocation starts with a header that records whether the memory came
+// from an arena, so that operator delete knows whether to release it.
+enum { HEAP_MEMORY = 0, ARENA_MEMORY = 1 };
+static const size_t HEADER_SIZE = ARENA_ALIGN;
+
+void* FEMaterialPoint::operator new(size_t size)
+{
+	char* p = nullptr;
+	FEMaterialPointArena* arena = FEMaterialPointArena::Active();
+	if (arena)
+	{
+		p = (char*) arena->Allocate(size + HEADER_SIZE);
+		*((size_t*)p) = ARENA_MEMORY;
+	}
+	else
+	{
+		p = (char*) ::operator new(size + HEADER_SIZE);
+		*((size_t*)p) = HEAP_MEMORY;
+	}
+	return p + HEADER_SIZE;
+}
+
+void FEMaterialPoint::operator delete(void* p)
+{
+	if (p == nullptr) return;
+	char* b = (char*)p - HEADER_SIZE;
+	if (*((size_t*)b) == HEAP_MEMORY) ::operator delete(b);
+}
+
+//-----------------------------------------------------------------------------
 FEMaterialPoint::FEMaterialPoint(FEMaterialPoint* ppt)
 {
 	m_pPrev = 0;
 	m_pNext = ppt;
 	m_elem = 0;
+	m_types = 0;
 	if (ppt) ppt->m_pPrev = this;
 }
 
+FEMaterialPoint::FEMaterialPoint(const FEMaterialPoint& pt)
+{
+	m_r0 = pt.m_r0;
+	m_J0 = pt.m_J0;
+	m_Jt = pt.m_Jt;
+	m_elem = pt.m_elem;
+	m_index = pt.m_index;
+	m_shape = pt.m_shape;
+	m_pNext = pt.m_pNext;
+	m_pPrev = pt.m_pPrev;
+	m_types = 0;
+}
+
 FEMaterialPoint::~FEMaterialPoint()
 { 
 	if (m_pNext) delete m_pNext;
@@ -108,3 +409,79 @@ void FEMaterialPointArray::Update(const FETimeInfo& timeInfo)
 	FEMaterialPoint::Update(timeInfo);
 	for (int i = 0; i<(int)m_mp.size(); ++i) m_mp[i]->Update(timeInfo);
 }
+
+//-----------------------------------------------------------------------------
+// collect all the nodes of a material point in a fixed order
+static void CollectNodes(FEMaterialPoint* mp, vector<FEMaterialPoint*>& nodes)
+{
+	for (FEMaterialPoint* pt = mp; pt; pt = pt->Next())
+	{
+		nodes.push_back(pt);
+		int nc = pt->Components();
+		for (int i = 0; i < nc; ++i)
+		{
+			FEMaterialPoint* pi = pt->GetPointData(i);
+			if (pi && (pi != pt)) CollectNodes(pi, nodes);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointTypeCache::~FEMaterialPointTypeCache()
+{
+	for (size_t i = 0; i < m_table.size(); ++i) delete m_table[i];
+	m_table.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool FEMaterialPointTypeCache::Assign(FEMaterialPoint* mp)
+{
+	if (mp == 0) return false;
+
+	m_tmp.clear();
+	CollectNodes(mp, m_tmp);
+	int N = (int)m_tmp.size();
+
+	// the first material point defines the layout
+	if (m_table.empty())
+	{
+		for (int i = 0; i < N; ++i) m_table.push_back(new FEMaterialPointTypeTable(&typeid(*m_tmp[i])));
+	}
+
+	// make sure this point has the same layout
+	if (N != (int)m_table.size()) return false;
+	for (int i = 0; i < N; ++i)
+	{
+		if (typeid(*m_tmp[i]) != *m_table[i]->NodeType()) return false;
+	}
+
+	for (int i = 0; i < N; ++i) m_tmp[i]->SetTypeTable(m_table[i]);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEMaterialPointTypeCache::AssignCopy(FEMaterialPoint* mp)
+{
+	if (mp == 0) return false;
+
+	// the nodes along the next pointers are new, so they can be linked to their parents
+	for (FEMaterialPoint* pt = mp; pt->Next(); pt = pt->Next()) pt->Next()->SetPrev(pt);
+	mp->SetPrev(0);
+
+	// find the tables for this layout
+	vector<FEMaterialPoint*> nodes;
+	CollectNodes(mp, nodes);
+	vector<std::type_index> layout;
+	for (size_t i = 0; i < nodes.size(); ++i) layout.push_back(std::type_index(typeid(*nodes[i])));
+
+	// The cache is kept per thread, so copying element states doesn't need a lock. The
+	// tables can still be used by other threads, since their entries are atomic.
+	// (the tables are never released, since copies can be destroyed after the thread exits)
+	static thread_local std::map<vector<std::type_index>, FEMaterialPointTypeCache*>* cache = nullptr;
+	if (cache == nullptr) cache = new std::map<vector<std::type_index>, FEMaterialPointTypeCache*>;
+
+	FEMaterialPointTypeCache*& types = (*cache)[layout];
+	if (types == 0) types = new FEMaterialPointTypeCache;
+	return types->Assign(mp);
+}
@@ -31,10 +31,136 @@ SOFTWARE.*/
 #include "mat3d.h"
 #include "FETimeInfo.h"
 #include <vector>
+#include <atomic>
+#include <typeinfo>
+#include <typeindex>
+#include <new>
 using namespace std;
 
 class FEElement;
 
+//-----------------------------------------------------------------------------
+//! The type table stores for a node of a material point chain where the data
+//! of a particular type can be found, relative to that node. All material points
+//! that are created by the same material have the same layout, so a table is shared
+//! by all the corresponding nodes of these points. The entries of the table
+//! are resolved the first time a type is requested.
+class FECORE_API FEMaterialPointTypeTable
+{
+public:
+	enum { MAX_TYPES = 64 };
+	enum { UNRESOLVED = -128, NOT_FOUND = 127 };
+
+public:
+	FEMaterialPointTypeTable(const std::type_info* ti);
+
+	//! the (dynamic) type of the node this table is for
+	const std::type_info* NodeType() const { return m_type; }
+
+	//! get the offset to the data with the type index n
+	int Offset(int n) const { return m_offset[n].load(std::memory_order_relaxed); }
+
+	//! set the offset to the data with the type index n
+	void SetOffset(int n, int offset) { m_offset[n].store((signed char)offset, std::memory_order_relaxed); }
+
+private:
+	const std::type_info*		m_type;
+	std::atomic<signed char>	m_offset[MAX_TYPES];
+};
+
+//-----------------------------------------------------------------------------
+//! Memory arena for material point data. While an arena is active on a thread
+//! (see FEMaterialPointArena::Scope), all the material point objects that are 
+//! created on that thread are allocated from the arena. These objects can still
+//! be deleted as usual, but their memory is only released when the arena is destroyed.
+//! The arena also stores fields of material point data (e.g. the deformation gradient
+//! of elastic points) outside of the point objects. Each field has its own arrays, so
+//! the values of a field are contiguous for consecutive material points.
+class FECORE_API FEMaterialPointArena
+{
+public:
+	FEMaterialPointArena();
+	~FEMaterialPointArena();
+
+	//! allocate a block of memory
+	void* Allocate(size_t size);
+
+	//! Make sure that the next size bytes are allocated from one contiguous block.
+	//! The block is initialized in parallel in chunks of chunkSize bytes, using
+	//! the same static schedule as the element loops, so that on NUMA systems the 
+	//! memory ends up close to the thread that processes the corresponding element.
+	void Reserve(size_t size, size_t chunkSize);
+
+	//! total number of bytes allocated from this arena (not counting the fields)
+	size_t Allocated() const { return m_allocated; }
+
+	//! total size of the memory blocks of this arena
+	size_t Capacity() const;
+
+public:
+	//! return a new field ID
+	static int NewField();
+
+	//! allocate an entry of a field (all entries of a field must have the same size)
+	void* AllocateField(int field, size_t size);
+
+	//! number of entries of each field
+	vector<size_t> FieldEntries() const;
+
+	//! Make sure that the next copies*(FieldEntries()[i] - n0[i]) entries of each field i
+	//! are allocated from one contiguous array. The arrays are initialized like in Reserve.
+	void ReserveFields(const vector<size_t>& n0, size_t copies);
+
+	//! Create an entry of a field in the active arena of the current thread. If no arena
+	//! is active, the entry is created in the memory pointed to by local.
+	template <class T> static T& FieldEntry(int field, T* local)
+	{
+		FEMaterialPointArena* arena = Active();
+		void* p = (arena ? arena->AllocateField(field, sizeof(T)) : local);
+		return *(new (p) T);
+	}
+
+public:
+	//! This class makes an arena the active arena of the current thread during its lifetime
+	class FECORE_API Scope
+	{
+	public:
+		Scope(FEMaterialPointArena& arena);
+		~Scope();
+
+	private:
+		FEMaterialPointArena*	m_prev;
+	};
+
+	//! return the active arena of the current thread (or null)
+	static FEMaterialPointArena* Active();
+
+private:
+	FEMaterialPointArena(const FEMaterialPointArena&) {}
+	void operator = (const FEMaterialPointArena&) {}
+
+private:
+	struct Block
+	{
+		char*	data;
+		size_t	size;
+		size_t	used;
+	};
+
+	struct Field
+	{
+		size_t			size;		// size of an entry
+		size_t			entries;	// number of allocated entries
+		vector<Block>	block;
+	};
+
+	static void AddBlock(vector<Block>& blocks, size_t size);
+
+	vector<Block>	m_block;
+	vector<Field>	m_field;
+	size_t			m_allocated;
+};
+
 //-----------------------------------------------------------------------------
 //! Material point class
 
@@ -50,6 +176,10 @@ public:
 	FEMaterialPoint(FEMaterialPoint* ppt = 0);
 	virtual ~FEMaterialPoint();
 
+	//! Copy constructor. The type table is not copied, since it belongs to the 
+	//! domain of the original point (see FEMaterialPointTypeCache::AssignCopy).
+	FEMaterialPoint(const FEMaterialPoint& pt);
+
 public:
 	//! The init function is used to intialize data
 	virtual void Init();
@@ -85,9 +215,35 @@ public:
 	//! in other words, it makes this the parent of the passed pointer
 	void SetNext(FEMaterialPoint* pt);
 
+	//! assign the type table that is used by ExtractData
+	void SetTypeTable(FEMaterialPointTypeTable* types) { m_types = types; }
+
 	// serialization
 	virtual void Serialize(DumpStream& ar);
 
+public:
+	//! material points are allocated from the active arena of the thread, if there is one
+	static void* operator new(size_t size);
+	static void operator delete(void* p);
+
+public:
+	//! Return a unique index for the material point type T. The indices are assigned
+	//! by FECore, so that all modules (and plugins) use the same index for a type.
+	//! The local static only caches the index of T for this module.
+	template <class T> static int TypeIndex() { static int n = TypeIndex(std::type_index(typeid(T))); return n; }
+
+	//! return the index of a material point type
+	static int TypeIndex(const std::type_index& type);
+
+	//! number of times ExtractData had to search the material point chain (summed over all threads)
+	static long long SlowLookups();
+
+private:
+	// search the material point chain for the data of type T
+	template <class T> T* FindData(int& offset);
+
+	static void AddSlowLookup();
+
 public:
 	vec3d		m_r0;		//!< material point position
 	double		m_J0;		//!< reference Jacobian
@@ -101,12 +257,17 @@ public:
 protected:
 	FEMaterialPoint*	m_pNext;	//<! next data in the list
 	FEMaterialPoint*	m_pPrev;	//<! previous data in the list
+
+	FEMaterialPointTypeTable*	m_types;	//!< type table for this node (can be null)
 };
 
 //-----------------------------------------------------------------------------
-template <class T> inline T* FEMaterialPoint::ExtractData()
+template <class T> inline T* FEMaterialPoint::FindData(int& offset)
 {
+	AddSlowLookup();
+
 	// first see if this is the correct type
+	offset = 0;
 	T* p = dynamic_cast<T*>(this);
 	if (p) return p;
 
@@ -114,16 +275,17 @@ template <class T> inline T* FEMaterialPoint::ExtractData()
 	FEMaterialPoint* pt = this;
 	while (pt->m_pNext)
 	{
-		pt = pt->m_pNext;
+		pt = pt->m_pNext; offset++;
 		p = dynamic_cast<T*>(pt);
 		if (p) return p;
 	}
 
 	// search up
+	offset = 0;
 	pt = this;
 	while (pt->m_pPrev)
 	{
-		pt = pt->m_pPrev;
+		pt = pt->m_pPrev; offset--;
 		p = dynamic_cast<T*>(pt);
 		if (p) return p;
 	}
@@ -133,34 +295,69 @@ template <class T> inline T* FEMaterialPoint::ExtractData()
 }
 
 //-----------------------------------------------------------------------------
-template <class T> inline const T* FEMaterialPoint::ExtractData() const
+template <class T> inline T* FEMaterialPoint::ExtractData()
 {
-	// first see if this is the correct type
-	const T* p = dynamic_cast<const T*>(this);
-	if (p) return p;
-
-	// check all the child classes 
-	const FEMaterialPoint* pt = this;
-	while (pt->m_pNext)
+	// see if we already know where to find this type
+	int ntype = TypeIndex<T>();
+	bool hasTable = (m_types && (ntype < FEMaterialPointTypeTable::MAX_TYPES));
+	if (hasTable)
 	{
-		pt = pt->m_pNext;
-		p = dynamic_cast<const T*>(pt);
-		if (p) return p;
+		int offset = m_types->Offset(ntype);
+		if (offset == FEMaterialPointTypeTable::NOT_FOUND) return 0;
+		if (offset != FEMaterialPointTypeTable::UNRESOLVED)
+		{
+			FEMaterialPoint* pt = this;
+			for (; offset > 0; --offset) pt = pt->m_pNext;
+			for (; offset < 0; ++offset) pt = pt->m_pPrev;
+			return static_cast<T*>(pt);
+		}
 	}
 
-	// search up
-	pt = this;
-	while (pt->m_pPrev)
+	// search the chain and store the result in the table
+	int offset = 0;
+	T* p = FindData<T>(offset);
+	if (hasTable)
 	{
-		pt = pt->m_pPrev;
-		p = dynamic_cast<const T*>(pt);
-		if (p) return p;
+		if (p == 0) m_types->SetOffset(ntype, FEMaterialPointTypeTable::NOT_FOUND);
+		else if ((offset > FEMaterialPointTypeTable::UNRESOLVED) && (offset < FEMaterialPointTypeTable::NOT_FOUND)) m_types->SetOffset(ntype, offset);
 	}
+	return p;
+}
 
-	// Everything has failed. Material point data can not be found
-	return 0;
+//-----------------------------------------------------------------------------
+template <class T> inline const T* FEMaterialPoint::ExtractData() const
+{
+	return const_cast<FEMaterialPoint*>(this)->ExtractData<T>();
 }
 
+//-----------------------------------------------------------------------------
+//! This class creates the type tables for the material points of a domain and
+//! assigns them to the nodes of the material point chains. All the chains need to
+//! have the same layout as the first one that was assigned, otherwise no tables
+//! are assigned and ExtractData falls back to searching the chain.
+class FECORE_API FEMaterialPointTypeCache
+{
+public:
+	FEMaterialPointTypeCache() {}
+	~FEMaterialPointTypeCache();
+
+	//! assign type tables to all the nodes of this material point
+	bool Assign(FEMaterialPoint* mp);
+
+	//! Assign type tables to a material point that was created with Copy. The copy can
+	//! outlive the domain of the original point, so its tables come from a per-thread
+	//! cache that keeps one set of tables per layout. This also links the prev pointers
+	//! of the copied chain, which the Copy functions don't update.
+	static bool AssignCopy(FEMaterialPoint* mp);
+
+private:
+	FEMaterialPointTypeCache(const FEMaterialPointTypeCache&) {}
+	void operator = (const FEMaterialPointTypeCache&) {}
+
+private:
+	vector<FEMaterialPointTypeTable*>	m_table;
+	vector<FEMaterialPoint*>			m_tmp;
+};
 
 //-----------------------------------------------------------------------------
 // Material point base class for materials that define vector properties
@@ -97,6 +97,22 @@ void FEMesh::Serialize(DumpStream& ar)
 	}
 	ar.UnlockPointerTable();
 
+	// The dof values of the nodes are not stored with the nodes in a shallow
+	// archive, but in one block directly from the flat dof arrays.
+	if (ar.IsShallow())
+	{
+		ar & m_NodeDofs.m_val_t & m_NodeDofs.m_val_p & m_NodeDofs.m_Fr;
+	}
+
+	// The nodes that were read from a full archive own their dof data,
+	// so move the data to the mesh's dof arrays
+	if ((ar.IsShallow() == false) && ar.IsLoading() && (m_Node.empty() == false))
+	{
+		int NN = Nodes();
+		m_NodeDofs.Create(NN, m_Node[0].dofs());
+		for (int i = 0; i < NN; ++i) m_Node[i].Bind(m_NodeDofs, i, true);
+	}
+
 	// stream domain data
 	ar & m_Domain;
 
@@ -214,6 +230,10 @@ void FEMesh::CreateNodes(int nodes)
 	assert(nodes);
 	m_Node.resize(nodes);
 
+	// allocate the dof data
+	m_NodeDofs.Resize(nodes);
+	BindNodes();
+
 	// set the default node IDs
 	for (int i=0; i<nodes; ++i) Node(i).SetID(i+1);
 
@@ -235,13 +255,27 @@ void FEMesh::AddNodes(int nodes)
 
 	m_Node.resize(N0 + nodes);
 	for (int i=0; i<nodes; ++i) m_Node[i+N0].SetID(n0+i);
+
+	// the dof data of the existing nodes is kept
+	m_NodeDofs.Resize(N0 + nodes);
+	BindNodes();
 }
 
 //-----------------------------------------------------------------------------
 void FEMesh::SetDOFS(int n)
+{
+	m_NodeDofs.Create(Nodes(), n);
+	BindNodes();
+}
+
+//-----------------------------------------------------------------------------
+// Nodes that own their dof data (e.g. nodes that were assigned to the mesh) copy
+// their values to the mesh's arrays. The other nodes were already attached and
+// their values were kept when the arrays were resized.
+void FEMesh::BindNodes()
 {
 	int NN = Nodes();
-	for (int i=0; i<NN; ++i) m_Node[i].SetDOFS(n);
+	for (int i=0; i<NN; ++i) m_Node[i].Bind(m_NodeDofs, i, true);
 }
 
 //-----------------------------------------------------------------------------
@@ -341,6 +375,7 @@ void FEMesh::InitMaterialPoints()
 void FEMesh::Clear()
 {
 	m_Node.clear();
+	m_NodeDofs.Clear();
 	for (size_t i=0; i<m_Domain.size (); ++i) delete m_Domain [i];
 
 	// TODO: Surfaces are currently managed by the classes that use them so don't delete them
@@ -383,7 +418,7 @@ void FEMesh::Reset()
         node.m_dp = node.m_dt = node.m_d0;
 
 		// reset ID arrays
-		int ndof = (int)node.dofs();
+		int ndof = node.dofs();
 		for (int i=0; i<ndof; ++i) 
 		{
 			node.set_inactive(i);
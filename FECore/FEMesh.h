@@ -103,6 +103,12 @@ public:
 	//! Set the number of degrees of freedom on this mesh
 	void SetDOFS(int n);
 
+	//! return the number of degrees of freedom on this mesh
+	int GetDOFS() const { return m_NodeDofs.Dofs(); }
+
+	//! return the flat nodal dof data
+	FENodeDofData& NodeDofData() { return m_NodeDofs; }
+
 	//! update bounding box
 	void UpdateBox();
 
@@ -256,8 +262,12 @@ protected:
 	double SolidElementVolume(FESolidElement& el);
 	double ShellElementVolume(FEShellElement& el);
 
+	//! attach the nodes to the flat dof data
+	void BindNodes();
+
 private:
 	vector<FENode>		m_Node;		//!< nodes
+	FENodeDofData		m_NodeDofs;	//!< nodal dof data
 	vector<FEDomain*>	m_Domain;	//!< list of domains
 	vector<FESurface*>	m_Surf;		//!< surfaces
 	vector<FEEdge*>		m_Edge;		//!< Edges
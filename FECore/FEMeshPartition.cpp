@@ -159,9 +159,41 @@ bool FEMeshPartition::Init()
 	}
 #endif
 
+	// store the connectivity in contiguous arrays
+	PackConnectivity();
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// The connectivity of all elements is stored in two packed arrays, in element 
+// order, and the elements' connectivity arrays point into them. This avoids 
+// allocating two arrays for each element. Note that the elements are attached 
+// to the new arrays before the old ones are released. 
+void FEMeshPartition::PackConnectivity()
+{
+	int NE = Elements();
+	int nsize = 0;
+	for (int i = 0; i < NE; ++i) nsize += ElementRef(i).m_node.size();
+
+	vector<int> node(nsize), lnode(nsize);
+	int n = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		int ne = el.m_node.size();
+		if (ne > 0)
+		{
+			el.m_node.Bind(&node[n], true);
+			el.m_lnode.Bind(&lnode[n], true);
+			n += ne;
+		}
+	}
+
+	m_elemNode.swap(node);
+	m_elemLNode.swap(lnode);
+}
+
 
 //-----------------------------------------------------------------------------
 void FEMeshPartition::ForEachMaterialPoint(std::function<void(FEMaterialPoint& mp)> f)
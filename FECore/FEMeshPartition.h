@@ -138,6 +138,10 @@ public:
 	bool IsActive() const { return m_bactive; }
 	void SetActive(bool b) { m_bactive = b; }
 
+protected:
+	//! Move the element connectivity into the packed arrays of this partition
+	void PackConnectivity();
+
 protected:
 	FEMesh*		m_pMesh;	//!< the mesh that this domain is a part of
 	vector<int>	m_Node;		//!< list of nodes in this domain
@@ -149,4 +153,7 @@ protected:
 
 private:
 	vector<FEDataExport*>	m_Data;	//!< list of data export classes
+
+	vector<int>	m_elemNode;		//!< packed (global) element connectivity
+	vector<int>	m_elemLNode;	//!< packed local element connectivity
 };
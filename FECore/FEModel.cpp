@@ -112,7 +112,7 @@ public:
 
 		// allocate timers
 		// Make sure enough timers are allocated for all the TimerIds!
-		m_timers.resize(6);
+		m_timers.resize(7);
 	}
 
 	void Serialize(DumpStream& ar);
@@ -1672,6 +1672,7 @@ void FEModel::CopyFrom(FEModel& fem)
 	FEMesh& mesh = GetMesh();
 	int N = sourceMesh.Nodes();
 	mesh.CreateNodes(N);
+	mesh.SetDOFS(sourceMesh.GetDOFS());
 	for (int i=0; i<N; ++i)
 	{
 		mesh.Node(i) = sourceMesh.Node(i);
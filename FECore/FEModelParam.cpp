@@ -85,6 +85,16 @@ FEScalarValuator* FEParamDouble::valuator()
 	return m_val;
 }
 
+// evaluate the parameter at all the material points of a domain
+void FEParamDouble::operator () (FEDomain& dom, std::vector<double>& val)
+{
+	m_val->evaluate(dom, val);
+	if (m_scl != 1.0)
+	{
+		for (size_t i = 0; i < val.size(); ++i) val[i] *= m_scl;
+	}
+}
+
 // is this a const value
 bool FEParamDouble::isConst() const { return m_val->isConst(); };
 
@@ -81,6 +81,9 @@ public:
 	// evaluate the parameter at a material point
 	double operator () (const FEMaterialPoint& pt) { return m_scl*(*m_val)(pt); }
 
+	// evaluate the parameter at all the material points of a domain
+	void operator () (FEDomain& dom, std::vector<double>& val);
+
 	// is this a const value
 	bool isConst() const;
 
@@ -30,15 +30,18 @@ SOFTWARE.*/
 #include "FENNQuery.h"
 #include "FESurface.h"
 #include <stdlib.h>
+#include <algorithm>
 #include "FEMesh.h"
 using namespace std;
 
-int cmp_node(const void* e1, const void* e2)
-{
-	FENNQuery::NODE& n1 = *((FENNQuery::NODE*)e1);
-	FENNQuery::NODE& n2 = *((FENNQuery::NODE*)e2);
+//-----------------------------------------------------------------------------
+// ranges smaller than this are not split any further, but searched linearly
+const int KD_LEAF_SIZE = 8;
 
-	return (n1.d1 > n2.d1 ? 1 : -1);
+//-----------------------------------------------------------------------------
+static inline double Component(const vec3d& r, int n)
+{
+	return (n == 0 ? r.x : (n == 1 ? r.y : r.z));
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -60,57 +63,10 @@ FENNQuery::~FENNQuery()
 void FENNQuery::Init()
 {
 	assert(m_ps);
-
-	int i;
-	vec3d r0, r;
 	int N = m_ps->Nodes();
-
-	// pick a random point as pivot
-	r0 = m_q1 = m_ps->Node(0).m_rt;
-
-	// find the farthest node of this node
-	double dmax = 0, d;
-	for (i=0; i<N; ++i)
-	{
-		r = m_ps->Node(i).m_rt;
-		d = (r - r0)*(r - r0);
-		if (d > dmax)
-		{
-			m_q1 = r;
-			dmax = d;
-		}
-	}
-
-	// let's find the farthest node of this node
-	r0 = m_q2 = m_q1;
-	dmax = 0;
-	for (i=0; i<N; ++i)
-	{
-		r = m_ps->Node(i).m_rt;
-		d = (r - r0)*(r - r0);
-		if (d > dmax)
-		{
-			m_q2 = r;
-			dmax = d;
-		}
-	}
-
-	// create the BK-"tree"
-	m_bk.resize(N);
-	for (i=0; i<N; ++i) 
-	{
-		r = m_ps->Node(i).m_rt;
-		m_bk[i].i = i;
-		m_bk[i].r = r;
-		m_bk[i].d1 = (m_q1 - r)*(m_q1 - r);
-		m_bk[i].d2 = (m_q2 - r)*(m_q2 - r);
-	}
-
-	// sort the tree
-	qsort(&m_bk[0], N, sizeof(NODE), cmp_node);
-
-	// set the initial search item
-	m_imin = 0;
+	vector<vec3d> r(N);
+	for (int i=0; i<N; ++i) r[i] = m_ps->Node(i).m_rt;
+	Build(r);
 }
 
 //-----------------------------------------------------------------------------
@@ -118,270 +74,114 @@ void FENNQuery::Init()
 void FENNQuery::InitReference()
 {
 	assert(m_ps);
-
-	int i;
-	vec3d r0, r;
 	int N = m_ps->Nodes();
+	vector<vec3d> r(N);
+	for (int i=0; i<N; ++i) r[i] = m_ps->Node(i).m_r0;
+	Build(r);
+}
 
-	// pick a random point as pivot
-	r0 = m_q1 = m_ps->Node(0).m_r0;
-
-	// find the furtest node of this node
-	double dmax = 0, d;
-	for (i=0; i<N; ++i)
-	{
-		r = m_ps->Node(i).m_r0;
-		d = (r - r0)*(r - r0);
-		if (d > dmax)
-		{
-			m_q1 = r;
-			dmax = d;
-		}
-	}
+//-----------------------------------------------------------------------------
+void FENNQuery::Build(const vector<vec3d>& r)
+{
+	int N = (int) r.size();
+	m_r = r;
+	m_tree.resize(N);
+	for (int i=0; i<N; ++i) m_tree[i] = i;
+	m_axis.assign(N, 0);
+	BuildTree(0, N);
+}
 
-	// let's find the furthest node of this node
-	r0 = m_q2 = m_q1;
-	dmax = 0;
-	for (i=0; i<N; ++i)
-	{
-		r = m_ps->Node(i).m_r0;
-		d = (r - r0)*(r - r0);
-		if (d > dmax)
-		{
-			m_q2 = r;
-			dmax = d;
-		}
-	}
+//-----------------------------------------------------------------------------
+// Build the k-d tree for the range [l, r). The median of the range is placed
+// in the middle and splits the range along the axis of largest extent.
+void FENNQuery::BuildTree(int l, int r)
+{
+	if (r - l <= KD_LEAF_SIZE) return;
 
-	// create the BK-"tree"
-	m_bk.resize(N);
-	for (i=0; i<N; ++i) 
+	// find the extent of this range
+	vec3d cmin = m_r[m_tree[l]];
+	vec3d cmax = cmin;
+	for (int i=l+1; i<r; ++i)
 	{
-		r = m_ps->Node(i).m_r0;
-		m_bk[i].i = i;
-		m_bk[i].r = r;
-		m_bk[i].d1 = (m_q1 - r)*(m_q1 - r);
-		m_bk[i].d2 = (m_q2 - r)*(m_q2 - r);
+		const vec3d& ri = m_r[m_tree[i]];
+		if (ri.x < cmin.x) cmin.x = ri.x; if (ri.x > cmax.x) cmax.x = ri.x;
+		if (ri.y < cmin.y) cmin.y = ri.y; if (ri.y > cmax.y) cmax.y = ri.y;
+		if (ri.z < cmin.z) cmin.z = ri.z; if (ri.z > cmax.z) cmax.z = ri.z;
 	}
-
-	// sort the tree
-	qsort(&m_bk[0], N, sizeof(NODE), cmp_node);
-
-	// set the initial search item
-	m_imin = 0;
+	vec3d d = cmax - cmin;
+	int axis = 0;
+	if (d.y > d.x) axis = 1;
+	if (d.z > Component(d, axis)) axis = 2;
+
+	int m = (l + r) / 2;
+	std::nth_element(m_tree.begin() + l, m_tree.begin() + m, m_tree.begin() + r,
+		[&](int a, int b) { return Component(m_r[a], axis) < Component(m_r[b], axis); });
+	m_axis[m] = (char) axis;
+
+	BuildTree(l, m);
+	BuildTree(m + 1, r);
 }
 
 //-----------------------------------------------------------------------------
-
-int FENNQuery::Find(vec3d x)
+void FENNQuery::Search(const vec3d& x, int l, int r, int& imin, double& dmin) const
 {
-	int m_i0 = -1;
-	double rmin1, rmin2, rmax1, rmax2;
-	double rmin1s, rmin2s, rmax1s, rmax2s;
-	double d, d1, d2, dmin;
-	vec3d r;
-
-	// set the initial search radii
-	d1 = sqrt((m_q1 - x)*(m_q1 - x)); 
-	rmin1 = 0;
-	rmax1 = 2*d1;
-
-	d2 = sqrt((m_q2 - x)*(m_q2 - x));
-	rmin2 = 0;
-	rmax2 = 2*d2;
-
-	// check the last found item
-	int imin = m_imin;
-	r = m_ps->Node(imin).m_rt;
-	dmin = (r - x)*(r - x);
-	d = sqrt(dmin);
-	
-	// adjust search radii
-	if (d1 - d > rmin1) rmin1 = d1 - d;
-	if (d1 + d < rmax1) rmax1 = d1 + d;
-	rmin1s = rmin1*rmin1;
-	rmax1s = rmax1*rmax1;
-
-	if (d2 - d > rmin2) rmin2 = d2 - d;
-	if (d2 + d < rmax2) rmax2 = d2 + d;
-	rmin2s = rmin2*rmin2;
-	rmax2s = rmax2*rmax2;
-
-	// find the first item that satisfies d(i, q1) >= rmin1
-	int i0 = FindRadius(rmin1s);
-
-	for (int i=i0; i<(int) m_bk.size(); ++i)
+	if (r - l <= KD_LEAF_SIZE)
 	{
-		NODE& n = m_bk[i];
-		if (n.d1 <= rmax1s)
+		for (int i=l; i<r; ++i)
 		{
-			if ((n.d2 >= rmin2s) && (n.d2 <= rmax2s))
-			{
-				r = n.r;
-				d = (r - x)*(r - x);
-				if (d < dmin)
-				{
-					dmin = d;
-					d = sqrt(dmin);
-					imin = n.i;
-
-//					if (d1 - d > rmin1) rmin1 = d1 - d;
-					if (d1 + d < rmax1) rmax1 = d1 + d;
-//					rmin1s = rmin1*rmin1;
-					rmax1s = rmax1*rmax1;
-
-					if (d2 - d > rmin2) rmin2 = d2 - d;
-					if (d2 + d < rmax2) rmax2 = d2 + d;
-					rmin2s = rmin2*rmin2;
-					rmax2s = rmax2*rmax2;
-				}
-			}
+			int n = m_tree[i];
+			double d = (m_r[n] - x)*(m_r[n] - x);
+			if (d < dmin) { dmin = d; imin = n; }
 		}
-		else break;
+		return;
 	}
 
-/*
-	// do it the hard way
-	int imin = 0;
-	r = m_ps->Node(imin).m_rt;
-	double d0 = (r - x)*(r - x);
-	for (i=0; i<m_ps->Nodes(); ++i)
+	int m = (l + r) / 2;
+	int n = m_tree[m];
+	double d = (m_r[n] - x)*(m_r[n] - x);
+	if (d < dmin) { dmin = d; imin = n; }
+
+	// search the side that contains x first
+	int axis = m_axis[m];
+	double dx = Component(x, axis) - Component(m_r[n], axis);
+	if (dx < 0)
 	{
-		r = m_ps->Node(i).m_rt;
-		d = (r - x)*(r - x);
-		if (d < d0)
-		{
-			d0 = d;
-			imin = i;
-		}
+		Search(x, l, m, imin, dmin);
+		if (dx*dx < dmin) Search(x, m + 1, r, imin, dmin);
+	}
+	else
+	{
+		Search(x, m + 1, r, imin, dmin);
+		if (dx*dx < dmin) Search(x, l, m, imin, dmin);
 	}
-	assert(imin == m_imin);
-*/
-
-	#pragma omp critical
-	m_imin = imin;
-
-	return imin;
 }
 
 //-----------------------------------------------------------------------------
 
-int FENNQuery::FindReference(vec3d x)
+int FENNQuery::Find(const vec3d& x, int hint) const
 {
-	int m_i0 = -1;
-	double rmin1, rmin2, rmax1, rmax2;
-	double rmin1s, rmin2s, rmax1s, rmax2s;
-	double d, d1, d2, dmin;
-	vec3d r;
-
-	// set the initial search radii
-	d1 = sqrt((m_q1 - x)*(m_q1 - x)); 
-	rmin1 = 0;
-	rmax1 = 2*d1;
-
-	d2 = sqrt((m_q2 - x)*(m_q2 - x));
-	rmin2 = 0;
-	rmax2 = 2*d2;
-
-	// check the last found item
-	r = m_ps->Node(m_imin).m_r0;
-	dmin = (r - x)*(r - x);
-	d = sqrt(dmin);
-	
-	// adjust search radii
-	if (d1 - d > rmin1) rmin1 = d1 - d;
-	if (d1 + d < rmax1) rmax1 = d1 + d;
-	rmin1s = rmin1*rmin1;
-	rmax1s = rmax1*rmax1;
-
-	if (d2 - d > rmin2) rmin2 = d2 - d;
-	if (d2 + d < rmax2) rmax2 = d2 + d;
-	rmin2s = rmin2*rmin2;
-	rmax2s = rmax2*rmax2;
-
-	// find the first item that satisfies d(i, q1) >= rmin1
-	int i0 = FindRadius(rmin1s);
-
-	for (int i=i0; i<(int) m_bk.size(); ++i)
-	{
-		NODE& n = m_bk[i];
-		if (n.d1 <= rmax1s)
-		{
-			if ((n.d2 >= rmin2s) && (n.d2 <= rmax2s))
-			{
-				r = n.r;
-				d = (r - x)*(r - x);
-				if (d < dmin)
-				{
-					dmin = d;
-					d = sqrt(dmin);
-					m_imin = n.i;
-
-//					if (d1 - d > rmin1) rmin1 = d1 - d;
-					if (d1 + d < rmax1) rmax1 = d1 + d;
-//					rmin1s = rmin1*rmin1;
-					rmax1s = rmax1*rmax1;
-
-					if (d2 - d > rmin2) rmin2 = d2 - d;
-					if (d2 + d < rmax2) rmax2 = d2 + d;
-					rmin2s = rmin2*rmin2;
-					rmax2s = rmax2*rmax2;
-				}
-			}
-		}
-		else break;
-	}
+	int N = (int) m_tree.size();
+	if (N == 0) return -1;
 
-/*
-	// do it the hard way
-	int imin = 0;
-	r = m_ps->Node(imin).m_r0;
-	double d0 = (r - x)*(r - x);
-	for (int i=0; i<m_ps->Nodes(); ++i)
-	{
-		r = m_ps->Node(i).m_r0;
-		d = (r - x)*(r - x);
-		if (d < d0)
-		{
-			d0 = d;
-			imin = i;
-		}
-	}
-//	assert(imin == m_imin);
-*/
-	return m_imin;
+	// the hint gives us an initial search radius
+	if ((hint < 0) || (hint >= N)) hint = m_tree[N / 2];
+	int imin = hint;
+	double dmin = (m_r[hint] - x)*(m_r[hint] - x);
+
+	Search(x, 0, N, imin, dmin);
+
+	return imin;
 }
 
 //-----------------------------------------------------------------------------
 
-int FENNQuery::FindRadius(double r)
+int FENNQuery::FindReference(const vec3d& x, int hint) const
 {
-	int N = (int)m_bk.size();
-	int L = N - 1;
-	int i0 = 0;
-	int i1 = L;
-	if (m_bk[i1].d1 < r) return N;
-	int i = i1 / 2;
-	do
-	{
-		if (m_bk[i].d1 < r)
-		{
-			i0 = i;
-			if (m_bk[i+1].d1 >= r) { ++i; break; }
-		}
-		else
-		{
-			i1 = i;
-			if ((i==0) || (m_bk[i-1].d1 < r)) break;
-		}
-		i = (i1 + i0) / 2;
-	}
-	while(i0 != i1);
-
-	return i;
+	// The search structure stores the positions it was initialized with,
+	// so this is the same as Find, provided InitReference was called.
+	return Find(x, hint);
 }
 
-
 //-----------------------------------------------------------------------------
 int findNeirestNeighbors(const std::vector<vec3d>& point, const vec3d& x, int k, std::vector<int>& closestNodes)
 {
@@ -34,45 +34,46 @@ SOFTWARE.*/
 class FESurface;
 
 //-----------------------------------------------------------------------------
-//! This class is a helper class to locate the nearest neighbour on a surface
+//! This class is a helper class to locate the nearest neighbour on a surface.
+//! The surface nodes are stored in a (balanced) k-d tree. The queries do not
+//! modify the search structure, so they can be called concurrently from multiple
+//! threads. A caller can pass the index of a node that is expected to be close
+//! (e.g. the result of a previous query) to speed up the search.
 
 class FECORE_API FENNQuery
 {
-public:
-	struct NODE
-	{
-		int		i;	// index of node
-		vec3d	r;	// position of node
-		double	d1;	// distance to pivot 1
-		double	d2;	// distance to pivot 2
-	};
-
 public:
 	FENNQuery(FESurface* ps = 0);
 	virtual ~FENNQuery();
 
-	//! initialize search structures
+	//! initialize search structures (using current nodal positions)
 	void Init();
+
+	//! initialize search structures (using reference nodal positions)
 	void InitReference();
 
 	//! attach to a surface
 	void Attach(FESurface* ps) { m_ps = ps; }
 
-	//! find the neirest neighbour of r
-	int Find(vec3d x);	
-	int FindReference(vec3d x);	
+	//! find the nearest neighbour of x. The optional hint is the local index of a
+	//! node that is likely close to x and is used to warm-start the search.
+	int Find(const vec3d& x, int hint = -1) const;
+
+	//! find the nearest neighbour of x in the reference configuration.
+	//! This requires that the search structures were initialized with InitReference.
+	int FindReference(const vec3d& x, int hint = -1) const;
 
 protected:
-	int FindRadius(double r);
+	void Build(const std::vector<vec3d>& r);
+	void BuildTree(int l, int r);
+	void Search(const vec3d& x, int l, int r, int& imin, double& dmin) const;
 
 protected:
 	FESurface*	m_ps;	//!< the surface to search
-	std::vector<NODE>	m_bk;	// BK tree
-
-	vec3d	m_q1;	// pivot 1
-	vec3d	m_q2;	// pivot 2
 
-	int		m_imin;	// last found index
+	std::vector<vec3d>	m_r;		//!< node positions, indexed by local node number
+	std::vector<int>	m_tree;		//!< node indices in k-d tree order
+	std::vector<char>	m_axis;		//!< split axis for each entry in k-d tree
 };
 
 // function for finding the k closest neighbors
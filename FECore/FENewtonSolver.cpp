@@ -39,6 +39,7 @@ SOFTWARE.*/
 #include "FEDomain.h"
 #include "DumpStream.h"
 #include "FELinearSystem.h"
+#include "FESurfacePairConstraint.h"
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -177,14 +178,24 @@ bool FENewtonSolver::ReformStiffness()
 
 	FEModel& fem = *GetFEModel();
 
+    // the matrix only needs to be reshaped when a contact interface's profile changed
+    if (m_breshape == false)
+    {
+		for (int i = 0; i < fem.SurfacePairConstraints(); ++i)
+		{
+			FESurfacePairConstraint* pci = fem.SurfacePairConstraint(i);
+			if (pci->IsActive() && pci->ProfileChanged()) { m_breshape = true; break; }
+		}
+    }
+
     // recalculate the shape of the stiffness matrix if necessary
     if (m_breshape)
     {
         // reshape the stiffness matrix
         if (!CreateStiffness(m_niter == 0)) return false;
         
-        // reset reshape flag, except for contact
-		m_breshape = (((fem.SurfacePairConstraints() > 0) || (fem.NonlinearConstraints() > 0)) ? true : false);
+        // reset reshape flag, except for nonlinear constraints
+		m_breshape = (fem.NonlinearConstraints() > 0);
     }
     
     // calculate the global stiffness matrix
@@ -1130,7 +1141,7 @@ void FENewtonSolver::Update2(const vector<double>& ui)
 		if (node.m_rid == -1)
 		{
 			vec3d dv(0, 0, 0);
-			for (int j = 0; j < node.m_ID.size(); ++j)
+			for (int j = 0; j < node.dofs(); ++j)
 			{
 				int nj = -node.m_ID[j] - 2; if (nj >= 0) node.set(j, node.get(j) + ui[nj]);
 			}
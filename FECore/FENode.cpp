@@ -29,6 +29,57 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FENode.h"
 #include "DumpStream.h"
+#include <assert.h>
+
+//=============================================================================
+// FENodeDofData
+//-----------------------------------------------------------------------------
+FENodeDofData::FENodeDofData()
+{
+	m_nodes = 0;
+	m_dofs = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FENodeDofData::Create(int nodes, int dofs)
+{
+	m_nodes = nodes;
+	m_dofs = dofs;
+
+	int N = nodes*dofs;
+	m_ID.assign(N, -1);
+	m_BC.assign(N, 0);
+	m_val_t.assign(N, 0.0);
+	m_val_p.assign(N, 0.0);
+	m_Fr.assign(N, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+// Since the data is stored node-major, resizing the arrays keeps the data of
+// the existing nodes.
+void FENodeDofData::Resize(int nodes)
+{
+	m_nodes = nodes;
+
+	int N = nodes*m_dofs;
+	m_ID.resize(N, -1);
+	m_BC.resize(N, 0);
+	m_val_t.resize(N, 0.0);
+	m_val_p.resize(N, 0.0);
+	m_Fr.resize(N, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void FENodeDofData::Clear()
+{
+	m_nodes = 0;
+	m_dofs = 0;
+	m_ID.clear();
+	m_BC.clear();
+	m_val_t.clear();
+	m_val_p.clear();
+	m_Fr.clear();
+}
 
 //=============================================================================
 // FENode
@@ -43,45 +94,149 @@ FENode::FENode()
 
 	// default ID
 	m_nID = -1;
+
+	// no dofs yet
+	m_ndofs = 0;
+	m_ID = nullptr;
+	m_BC = nullptr;
+	m_val_t = nullptr;
+	m_val_p = nullptr;
+	m_Fr = nullptr;
+	m_pown = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FENode::~FENode()
+{
+	delete m_pown;
 }
 
 //-----------------------------------------------------------------------------
+// Set the number of dofs and initialize the dof data. A node that is attached to
+// the dof data of a mesh shares the mesh's layout, so only its slot is reset. (The
+// number of dofs of a mesh's nodes is set with FEMesh::SetDOFS.) A node that is not
+// attached to a mesh uses its own storage.
 void FENode::SetDOFS(int n)
 {
-	// initialize dof stuff
-	m_ID.assign(n, -1);
-	m_BC.assign(n, 0);
-	m_val_t.assign(n, 0.0);
-	m_val_p.assign(n, 0.0);
-	m_Fr.assign(n, 0.0);
+	if ((m_ID != nullptr) && (m_pown == nullptr))
+	{
+		assert(n == m_ndofs);
+		ResetDofs();
+	}
+	else if ((m_pown != nullptr) && (n == m_ndofs)) ResetDofs();
+	else
+	{
+		FENodeDofData* pd = new FENodeDofData;
+		pd->Create(1, n);
+		Bind(*pd, 0);
+		m_pown = pd;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENode::ResetDofs()
+{
+	for (int i = 0; i < m_ndofs; ++i)
+	{
+		m_ID[i] = -1;
+		m_BC[i] = 0;
+		m_val_t[i] = 0.0;
+		m_val_p[i] = 0.0;
+		m_Fr[i] = 0.0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENode::Bind(FENodeDofData& data, int index, bool bcopy)
+{
+	int n = data.Dofs();
+	int m = n*index;
+	if (bcopy && m_pown)
+	{
+		int nc = (n < m_ndofs ? n : m_ndofs);
+		for (int i = 0; i < nc; ++i)
+		{
+			data.m_ID[m + i] = m_ID[i];
+			data.m_BC[m + i] = m_BC[i];
+			data.m_val_t[m + i] = m_val_t[i];
+			data.m_val_p[m + i] = m_val_p[i];
+			data.m_Fr[m + i] = m_Fr[i];
+		}
+	}
+
+	Unbind();
+
+	m_ndofs = n;
+	if (n > 0)
+	{
+		m_ID = &data.m_ID[m];
+		m_BC = &data.m_BC[m];
+		m_val_t = &data.m_val_t[m];
+		m_val_p = &data.m_val_p[m];
+		m_Fr = &data.m_Fr[m];
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENode::Unbind()
+{
+	m_ndofs = 0;
+	m_ID = nullptr;
+	m_BC = nullptr;
+	m_val_t = nullptr;
+	m_val_p = nullptr;
+	m_Fr = nullptr;
+
+	delete m_pown;
+	m_pown = nullptr;
 }
 
 //-----------------------------------------------------------------------------
+// A copy of a node gets its own copy of the dof data, since the dof arrays of a
+// mesh can be reallocated while the copy is still alive.
 FENode::FENode(const FENode& n)
 {
-	m_r0 = n.m_r0;
-	m_rt = n.m_rt;
-	m_at = n.m_at;
-	m_rp = n.m_rp;
-	m_vp = n.m_vp;
-	m_ap = n.m_ap;
-	m_d0 = n.m_d0;
-    m_dt = n.m_dt;
-    m_dp = n.m_dp;
+	CopyGeometry(n);
 
-	m_nID = n.m_nID;
-	m_rid = n.m_rid;
-	m_nstate = n.m_nstate;
+	m_ndofs = 0;
+	m_ID = nullptr;
+	m_BC = nullptr;
+	m_val_t = nullptr;
+	m_val_p = nullptr;
+	m_Fr = nullptr;
+	m_pown = nullptr;
 
+	if (n.m_ID)
+	{
+		FENodeDofData* pd = new FENodeDofData;
+		pd->Create(1, n.m_ndofs);
+		Bind(*pd, 0);
+		m_pown = pd;
+		CopyDofs(n);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// A moved node takes over the dof data of the other node. This is used when
+// the mesh's node list is reallocated.
+FENode::FENode(FENode&& n) noexcept
+{
+	CopyGeometry(n);
+
+	m_ndofs = n.m_ndofs;
 	m_ID = n.m_ID;
 	m_BC = n.m_BC;
 	m_val_t = n.m_val_t;
 	m_val_p = n.m_val_p;
 	m_Fr = n.m_Fr;
+	m_pown = n.m_pown;
+
+	n.m_pown = nullptr;
+	n.Unbind();
 }
 
 //-----------------------------------------------------------------------------
-FENode& FENode::operator = (const FENode& n)
+void FENode::CopyGeometry(const FENode& n)
 {
 	m_r0 = n.m_r0;
 	m_rt = n.m_rt;
@@ -96,16 +251,51 @@ FENode& FENode::operator = (const FENode& n)
 	m_nID = n.m_nID;
 	m_rid = n.m_rid;
 	m_nstate = n.m_nstate;
+}
 
-	m_ID = n.m_ID;
-	m_BC = n.m_BC;
-	m_val_t = n.m_val_t;
-	m_val_p = n.m_val_p;
-	m_Fr = n.m_Fr;
+//-----------------------------------------------------------------------------
+void FENode::CopyDofs(const FENode& n)
+{
+	for (int i = 0; i < m_ndofs; ++i)
+	{
+		m_ID[i] = n.m_ID[i];
+		m_BC[i] = n.m_BC[i];
+		m_val_t[i] = n.m_val_t[i];
+		m_val_p[i] = n.m_val_p[i];
+		m_Fr[i] = n.m_Fr[i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Assignment copies the dof values, but leaves the node attached to its own storage.
+FENode& FENode::operator = (const FENode& n)
+{
+	if (this == &n) return (*this);
+
+	CopyGeometry(n);
+
+	if (m_ndofs != n.m_ndofs) SetDOFS(n.m_ndofs);
+	CopyDofs(n);
 
 	return (*this);
 }
 
+//-----------------------------------------------------------------------------
+// The dof arrays are written in the same format as std::vector
+template <typename T> static void write_array(DumpStream& ar, T* d, int n)
+{
+	ar << n;
+	for (int i = 0; i < n; ++i) ar << d[i];
+}
+
+template <typename T> static void read_array(DumpStream& ar, T* d, int n)
+{
+	int m;
+	ar >> m;
+	assert(m == n);
+	for (int i = 0; i < m; ++i) ar >> d[i];
+}
+
 //-----------------------------------------------------------------------------
 // Serialize
 void FENode::Serialize(DumpStream& ar)
@@ -113,14 +303,42 @@ void FENode::Serialize(DumpStream& ar)
 	ar & m_nID;
 	ar & m_rt & m_at;
 	ar & m_rp & m_vp & m_ap;
-	ar & m_Fr;
-	ar & m_val_t & m_val_p;
+
+	// In a shallow archive the dof values of all nodes are streamed
+	// in one block by the mesh (see FEMesh::Serialize).
+	if (ar.IsShallow() == false)
+	{
+		if (ar.IsSaving())
+		{
+			write_array(ar, m_Fr, m_ndofs);
+			write_array(ar, m_val_t, m_ndofs);
+			write_array(ar, m_val_p, m_ndofs);
+		}
+		else
+		{
+			// the number of dofs is stored with the first array
+			int n;
+			ar >> n;
+			if (n != m_ndofs) SetDOFS(n);
+			for (int i = 0; i < n; ++i) ar >> m_Fr[i];
+			read_array(ar, m_val_t, m_ndofs);
+			read_array(ar, m_val_p, m_ndofs);
+		}
+	}
     ar & m_dt & m_dp;
 	if (ar.IsShallow() == false)
 	{
 		ar & m_nstate;
-		ar & m_ID;
-		ar & m_BC;
+		if (ar.IsSaving())
+		{
+			write_array(ar, m_ID, m_ndofs);
+			write_array(ar, m_BC, m_ndofs);
+		}
+		else
+		{
+			read_array(ar, m_ID, m_ndofs);
+			read_array(ar, m_BC, m_ndofs);
+		}
 		ar & m_r0;
 		ar & m_rid;
 		ar & m_d0;
@@ -131,5 +349,5 @@ void FENode::Serialize(DumpStream& ar)
 //! Update nodal values, which copies the current values to the previous array
 void FENode::UpdateValues()
 {
-	m_val_p = m_val_t;
+	for (int i = 0; i < m_ndofs; ++i) m_val_p[i] = m_val_t[i];
 }
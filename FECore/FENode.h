@@ -34,11 +34,51 @@ SOFTWARE.*/
 
 class DumpStream;
 
+//-----------------------------------------------------------------------------
+//! This class stores the degree of freedom data of a set of nodes in flat arrays.
+
+//! The data is stored node-major, i.e. the data of node i starts at i*Dofs().
+//! The mesh owns one of these objects and its nodes point into it.
+class FECORE_API FENodeDofData
+{
+public:
+	FENodeDofData();
+
+	//! allocate storage for a number of nodes and initialize to default values
+	void Create(int nodes, int dofs);
+
+	//! change the number of nodes, keeping the data of the existing nodes
+	void Resize(int nodes);
+
+	//! clear all data
+	void Clear();
+
+	//! number of nodes
+	int Nodes() const { return m_nodes; }
+
+	//! number of degrees of freedom per node
+	int Dofs() const { return m_dofs; }
+
+public:
+	std::vector<int>		m_ID;		//!< nodal equation numbers
+	std::vector<int>		m_BC;		//!< boundary condition flags
+	std::vector<double>		m_val_t;	//!< current nodal DOF values
+	std::vector<double>		m_val_p;	//!< previous nodal DOF values
+	std::vector<double>		m_Fr;		//!< equivalent nodal forces
+
+private:
+	int		m_nodes;
+	int		m_dofs;
+};
+
 //-----------------------------------------------------------------------------
 //! This class defines a finite element node
 
 //! It stores nodal positions and nodal equations numbers and more.
 //!
+//! The dof data (equation numbers, bc flags, values, and loads) is not stored
+//! in the node itself, but in the flat FENodeDofData arrays of the mesh.
+//!
 //! The m_ID array will store the equation number for the corresponding
 //! degree of freedom. Its values can be (a) non-negative (0 or higher) which
 //! gives the equation number in the linear system of equations, (b) -1 if the
@@ -63,12 +103,22 @@ public:
 	//! copy constructor
 	FENode(const FENode& n);
 
+	//! move constructor
+	FENode(FENode&& n) noexcept;
+
 	//! assignment operator
 	FENode& operator = (const FENode& n);
 
+	//! destructor
+	~FENode();
+
 	//! Set the number of DOFS
 	void SetDOFS(int n);
 
+	//! Attach the node to slot index of the dof data. If bcopy is true and
+	//! the node owns its dof data, the dof values are copied to the new location.
+	void Bind(FENodeDofData& data, int index, bool bcopy = false);
+
 	//! Get the nodal ID
 	int GetID() const { return m_nID; }
 
@@ -146,7 +196,7 @@ public:
 	int get_bc(int ndof) const { return (m_BC[ndof] & 0x0F); }
 	bool is_active(int ndof) const { return ((m_BC[ndof] & 0xF0) != 0); }
 
-	int dofs() const { return (int) m_ID.size(); }
+	int dofs() const { return m_ndofs; }
     
 public:
     vec3d   m_s0() { return m_r0 - m_d0; }
@@ -154,11 +204,20 @@ public:
     vec3d   m_sp() { return m_rp - m_dp; }
 
 private:
-	std::vector<int>		m_BC;		//!< boundary condition array
-	std::vector<double>		m_val_t;	//!< current nodal DOF values
-	std::vector<double>		m_val_p;	//!< previous nodal DOF values
-	std::vector<double>		m_Fr;		//!< equivalent nodal forces
+	void Unbind();
+	void ResetDofs();
+	void CopyGeometry(const FENode& n);
+	void CopyDofs(const FENode& n);
+
+private:
+	int			m_ndofs;	//!< number of degrees of freedom
+	int*		m_BC;		//!< boundary condition array
+	double*		m_val_t;	//!< current nodal DOF values
+	double*		m_val_p;	//!< previous nodal DOF values
+	double*		m_Fr;		//!< equivalent nodal forces
+
+	FENodeDofData*	m_pown;	//!< dof data owned by this node (only for nodes that are not attached to a mesh)
 
 public:
-	std::vector<int>		m_ID;	//!< nodal equation numbers
+	int*		m_ID;	//!< nodal equation numbers
 };
@@ -40,8 +40,24 @@ FENormalProjection::FENormalProjection(FESurface& s) : m_surf(s)
 //-----------------------------------------------------------------------------
 void FENormalProjection::Init()
 {
-	m_OT.Attach(&m_surf);
-	m_OT.Init(m_tol);
+	m_bvh.Attach(&m_surf);
+	m_bvh.Build(m_tol);
+}
+
+//-----------------------------------------------------------------------------
+void FENormalProjection::Update()
+{
+	if ((m_bvh.IsValid() == false) || (m_bvh.Tolerance() != m_tol)) Init();
+	else m_bvh.Update();
+}
+
+//-----------------------------------------------------------------------------
+// The candidate list is reused between queries to avoid allocating in the
+// projection loops, which are often called from parallel regions.
+static vector<int>& CandidateList()
+{
+	static thread_local vector<int> selist;
+	return selist;
 }
 
 //-----------------------------------------------------------------------------
@@ -53,18 +69,17 @@ void FENormalProjection::Init()
 FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist);
+	vector<int>& selist = CandidateList();
+	m_bvh.FindCandidateSurfaceElements(r, n, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
-	for (it=selist.begin(); it!=selist.end(); ++it) {
+	for (size_t i=0; i<selist.size(); ++i) {
 		// get the surface element
-		int j = *it;
+		int j = selist[i];
 		// project the node on the element
 		FESurfaceElement* pe = &m_surf.Element(j);
 		if (m_surf.Intersect(*pe, r, n, rsl, gl, m_tol)) {
@@ -97,18 +112,17 @@ FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist);
+	vector<int>& selist = CandidateList();
+	m_bvh.FindCandidateSurfaceElements(r, n, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g;
 	FESurfaceElement* pei = 0;
-	for (it=selist.begin(); it!=selist.end(); ++it) {
+	for (size_t i=0; i<selist.size(); ++i) {
 		// get the surface element
-		int j = *it;
+		int j = selist[i];
 		FESurfaceElement* pe = &m_surf.Element(j);
 		// project the node on the element
 		if (m_surf.Intersect(*pe, r, n, rsl, gl, m_tol)) {
@@ -140,18 +154,17 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei)
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist);
+	vector<int>& selist = CandidateList();
+	m_bvh.FindCandidateSurfaceElements(r, n, selist);
 
 	double g, gmax = -1e99, r2[2] = {rs[0], rs[1]};
 	int imin = -1;
 	FESurfaceElement* pme = 0;
 
 	// loop over all surface element
-	set<int>::iterator it;
-	for (it = selist.begin(); it != selist.end(); ++it)
+	for (size_t i = 0; i < selist.size(); ++i)
 	{
-		FESurfaceElement& el = m_surf.Element(*it);
+		FESurfaceElement& el = m_surf.Element(selist[i]);
 
 		// see if the ray intersects this element
 		if (m_surf.Intersect(el, r, n, r2, g, m_tol))
@@ -166,7 +179,7 @@ FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, d
 				pme = &el;
 //				gmin = g;
 				gmax = g;
-				imin = *it;
+				imin = selist[i];
 				rs[0] = r2[0];
 				rs[1] = r2[1];
 			}
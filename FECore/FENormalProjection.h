@@ -28,7 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FEOctree.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 //! This class calculates the normal projection on to a surface.
@@ -42,6 +42,10 @@ public:
 	// initialization
 	void Init();
 
+	//! Update the search structures to the current nodal positions. The search tree
+	//! is refitted, and only rebuilt when the surface moved a lot since it was built.
+	void Update();
+
 	void SetTolerance(double tol) { m_tol = tol; }
 	void SetSearchRadius(double srad) { m_rad = srad; }
 
@@ -60,5 +64,5 @@ private:
 
 private:
 	FESurface&	m_surf;	//!< the target surface
-	FEOctree	m_OT;	//!< used to optimize ray-surface intersections
+	FESurfaceBVH	m_bvh;	//!< used to optimize ray-surface intersections
 };
@@ -32,9 +32,18 @@ SOFTWARE.*/
 #include "FEModelParam.h"
 #include "FEModel.h"
 #include "DumpStream.h"
+#include "FEDomain.h"
 
 REGISTER_SUPER_CLASS(FEScalarValuator, FESCALARGENERATOR_ID);
 
+//-----------------------------------------------------------------------------
+void FEScalarValuator::evaluate(FEDomain& dom, std::vector<double>& val)
+{
+	int N = dom.MaterialPoints();
+	val.resize(N);
+	for (int i = 0; i < N; ++i) val[i] = (*this)(*dom.MaterialPoint(i));
+}
+
 //=============================================================================
 BEGIN_FECORE_CLASS(FEConstValue, FEScalarValuator)
 	ADD_PARAMETER(m_val, "const");
@@ -141,6 +150,11 @@ bool FEMathValue::create(FECoreBase* pc)
 	}
 
 	assert(b);
+
+	// compile the expression for faster evaluation
+	// (the compiled code needs a value for each variable of the expression)
+	if (b && (m_math.Variables() == 4 + (int)m_vars.size())) m_prog.Compile(m_math);
+
 	return b;
 }
 
@@ -153,42 +167,81 @@ FEScalarValuator* FEMathValue::copy()
 	FEMathValue* newExpr = new FEMathValue(GetFEModel());
 	newExpr->m_expr = m_expr;
 	newExpr->m_math = m_math;
+	newExpr->m_prog = m_prog;
 	newExpr->m_vars = m_vars;
 	return newExpr;
 }
 
-double FEMathValue::operator()(const FEMaterialPoint& pt)
+void FEMathValue::fillVariables(const FEMaterialPoint& pt, double* var)
 {
-	std::vector<double> var(4 + m_vars.size());
 	var[0] = pt.m_r0.x;
 	var[1] = pt.m_r0.y;
 	var[2] = pt.m_r0.z;
 	var[3] = GetFEModel()->GetTime().currentTime;
-	if (m_vars.empty() == false)
+	for (int i = 0; i < (int)m_vars.size(); ++i)
 	{
-		for (int i = 0; i < (int)m_vars.size(); ++i)
+		MathParam& mp = m_vars[i];
+		if (mp.type == 0)
 		{
-			MathParam& mp = m_vars[i];
-			if (mp.type == 0)
-			{
-				FEParam* pi = mp.pp;
-				switch (pi->type())
-				{
-				case FE_PARAM_INT: var[4 + i] = (double)pi->value<int>(); break;
-				case FE_PARAM_DOUBLE: var[4 + i] = pi->value<double>(); break;
-				case FE_PARAM_DOUBLE_MAPPED: var[4 + i] = pi->value<FEParamDouble>()(pt); break;
-				}
-			}
-			else
+			FEParam* pi = mp.pp;
+			switch (pi->type())
 			{
-				FEDataMap& map = *mp.map;
-				var[4+i] = map.value(pt);
+			case FE_PARAM_INT: var[4 + i] = (double)pi->value<int>(); break;
+			case FE_PARAM_DOUBLE: var[4 + i] = pi->value<double>(); break;
+			case FE_PARAM_DOUBLE_MAPPED: var[4 + i] = pi->value<FEParamDouble>()(pt); break;
 			}
 		}
+		else
+		{
+			FEDataMap& map = *mp.map;
+			var[4+i] = map.value(pt);
+		}
+	}
+}
+
+double FEMathValue::operator()(const FEMaterialPoint& pt)
+{
+	if (m_prog.IsValid() && (m_prog.Variables() <= MAX_VARS))
+	{
+		double var[MAX_VARS];
+		fillVariables(pt, var);
+		return m_prog.value(var);
 	}
+
+	std::vector<double> var(4 + m_vars.size());
+	fillVariables(pt, &var[0]);
 	return m_math.value_s(var);
 }
 
+void FEMathValue::evaluate(FEDomain& dom, std::vector<double>& val)
+{
+	if (m_prog.IsValid() == false)
+	{
+		FEScalarValuator::evaluate(dom, val);
+		return;
+	}
+
+	const int N = dom.MaterialPoints();
+	const int nvar = m_prog.Variables();
+	val.resize(N);
+	if (N == 0) return;
+
+	std::vector<double> var(N*nvar);
+	#pragma omp parallel for
+	for (int i = 0; i < N; ++i) fillVariables(*dom.MaterialPoint(i), &var[i*nvar]);
+
+	// evaluate the points in chunks so that the threads can share the work
+	const int CHUNK = 1024;
+	const int nchunks = (N + CHUNK - 1) / CHUNK;
+	#pragma omp parallel for
+	for (int c = 0; c < nchunks; ++c)
+	{
+		int n0 = c*CHUNK;
+		int n = (N - n0 < CHUNK ? N - n0 : CHUNK);
+		m_prog.value(&var[n0*nvar], n, &val[n0]);
+	}
+}
+
 //---------------------------------------------------------------------------------------
 
 FEMappedValue::FEMappedValue(FEModel* fem) : FEScalarValuator(fem), m_val(nullptr)
@@ -29,9 +29,12 @@ SOFTWARE.*/
 #pragma once
 #include "FEValuator.h"
 #include "MathObject.h"
+#include "MCompiledExpression.h"
 #include "FEDataMap.h"
 #include "FENodeDataMap.h"
 
+class FEDomain;
+
 //---------------------------------------------------------------------------------------
 // Base class for evaluating scalar parameters
 class FECORE_API FEScalarValuator : public FEValuator
@@ -43,6 +46,9 @@ public:
 
 	virtual double operator()(const FEMaterialPoint& pt) = 0;
 
+	// evaluate the parameter at all the material points of a domain
+	virtual void evaluate(FEDomain& dom, std::vector<double>& val);
+
 	virtual FEScalarValuator* copy() = 0;
 
 	virtual bool isConst() { return false; }
@@ -84,11 +90,15 @@ class FECORE_API FEMathValue : public FEScalarValuator
 		FEDataMap*	map;
 	};
 
+	enum { MAX_VARS = 16 };
+
 public:
 	FEMathValue(FEModel* fem) : FEScalarValuator(fem) {}
 	~FEMathValue();
 	double operator()(const FEMaterialPoint& pt) override;
 
+	void evaluate(FEDomain& dom, std::vector<double>& val) override;
+
 	bool Init() override;
 
 	FEScalarValuator* copy() override;
@@ -99,9 +109,13 @@ public:
 
 	void Serialize(DumpStream& ar) override;
 
+private:
+	void fillVariables(const FEMaterialPoint& pt, double* var);
+
 private:
 	std::string			m_expr;
 	MSimpleExpression	m_math;
+	MCompiledExpression	m_prog;
 	std::vector<MathParam>	m_vars;
 
 	DECLARE_FECORE_CLASS();
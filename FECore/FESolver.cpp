@@ -343,7 +343,7 @@ bool FESolver::InitEquations()
 	{
 		FENode& node = mesh.Node(P[i]);
 		if (node.HasFlags(FENode::EXCLUDE))
-			for (int j = 0; j < (int)node.m_ID.size(); ++j) node.m_ID[j] = -1;
+			for (int j = 0; j < node.dofs(); ++j) node.m_ID[j] = -1;
 	}
 	m_dofMap.clear();
 
@@ -385,7 +385,7 @@ bool FESolver::InitEquations()
 			{
 				FENode& node = mesh.Node(P[i]);
 				if (node.HasFlags(FENode::EXCLUDE) == false) {
-					int dofs = (int)node.m_ID.size();
+					int dofs = node.dofs();
 					for (int j = dofs - 1; j >= 0; --j)
 					{
 						if (node.is_active(j))
@@ -546,7 +546,7 @@ bool FESolver::InitEquations2()
 	{
 		FENode& node = mesh.Node(P[i]);
 		if (node.HasFlags(FENode::EXCLUDE))
-			for (int j = 0; j < (int)node.m_ID.size(); ++j) node.m_ID[j] = -1;
+			for (int j = 0; j < node.dofs(); ++j) node.m_ID[j] = -1;
 	}
 	// then, on all elements
 	for (int i = 0; i < mesh.Domains(); ++i)
@@ -333,7 +333,7 @@ FEElement* FESurface::FindElement(FESurfaceElement& el)
 	FEMesh& mesh = *GetMesh();
 	FENodeElemList& NEL = mesh.NodeElementList();
 
-	vector<int>& sf = el.m_node;
+	FEElementConnectivity& sf = el.m_node;
 	int node = el.m_node[0];
 	int nval = NEL.Valence(node);
 	FEElement** ppe = NEL.ElementList(node);
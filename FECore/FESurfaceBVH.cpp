@@ -0,0 +1,378 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include "FESurface.h"
+#include "FEMesh.h"
+#include <algorithm>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// current position of a node, as used by FESurface::Intersect
+static inline vec3d NodePosition(const FESurface& s, const FENode& node)
+{
+	return (s.IsShellBottom() ? node.m_rt - node.m_dt : node.m_rt);
+}
+
+//-----------------------------------------------------------------------------
+static inline double Component(const vec3d& r, int n)
+{
+	return (n == 0 ? r.x : (n == 1 ? r.y : r.z));
+}
+
+//-----------------------------------------------------------------------------
+// Determine if the (infinite) line through p with direction n intersects the box.
+static bool RayIntersectsBox(const vec3d& p, const vec3d& n, const vec3d& cmin, const vec3d& cmax)
+{
+	double tmin = -1e99, tmax = 1e99;
+	for (int k = 0; k < 3; ++k)
+	{
+		double pk = Component(p, k);
+		double nk = Component(n, k);
+		double ak = Component(cmin, k);
+		double bk = Component(cmax, k);
+		if (nk != 0.0)
+		{
+			double t1 = (ak - pk) / nk;
+			double t2 = (bk - pk) / nk;
+			if (t1 > t2) { double tmp = t1; t1 = t2; t2 = tmp; }
+			if (t1 > tmin) tmin = t1;
+			if (t2 < tmax) tmax = t2;
+			if (tmin > tmax) return false;
+		}
+		else if ((pk < ak) || (pk > bk)) return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH(FESurface* ps)
+{
+	m_ps = ps;
+	m_tol = 0.0;
+	m_rebuild = 1.0;
+	m_maxElem = 4;
+	m_h = 0.0;
+	m_drift = 0.0;
+	m_nbuild = 0;
+	m_nrefit = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Calculate the bounding box of a surface element at the current nodal positions.
+// The box is inflated by the search tolerance.
+void FESurfaceBVH::ElementBox(int iel, vec3d& cmin, vec3d& cmax) const
+{
+	FEMesh& mesh = *m_ps->GetMesh();
+	FESurfaceElement& el = m_ps->Element(iel);
+	int N = el.Nodes();
+	cmin = cmax = NodePosition(*m_ps, mesh.Node(el.m_node[0]));
+	for (int i = 1; i < N; ++i)
+	{
+		vec3d r = NodePosition(*m_ps, mesh.Node(el.m_node[i]));
+		if (r.x < cmin.x) cmin.x = r.x; if (r.x > cmax.x) cmax.x = r.x;
+		if (r.y < cmin.y) cmin.y = r.y; if (r.y > cmax.y) cmax.y = r.y;
+		if (r.z < cmin.z) cmin.z = r.z; if (r.z > cmax.z) cmax.z = r.z;
+	}
+
+	double d = (cmax - cmin).norm()*m_tol;
+	cmin -= vec3d(d, d, d);
+	cmax += vec3d(d, d, d);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Build(double stol)
+{
+	assert(m_ps);
+	m_tol = stol;
+	m_node.clear();
+
+	// get the element boxes
+	int NE = m_ps->Elements();
+	vector<vec3d> emin(NE), emax(NE);
+	m_elem.resize(NE);
+	double h = 0.0;
+	for (int i = 0; i < NE; ++i)
+	{
+		m_elem[i] = i;
+		ElementBox(i, emin[i], emax[i]);
+		h += (emax[i] - emin[i]).norm();
+	}
+	m_h = (NE > 0 ? h / NE : 0.0);
+
+	// store the nodal positions so we can tell how far the surface moved
+	int NN = m_ps->Nodes();
+	m_r0.resize(NN);
+	for (int i = 0; i < NN; ++i) m_r0[i] = NodePosition(*m_ps, m_ps->Node(i));
+	if ((int)m_rp.size() != NN) m_rp = m_r0;
+
+	if (NE == 0) return;
+
+	// we use element centroids for splitting
+	vector<vec3d> centroid(NE);
+	for (int i = 0; i < NE; ++i) centroid[i] = (emin[i] + emax[i])*0.5;
+
+	// build the tree top-down
+	m_node.reserve(2 * (NE / m_maxElem) + 1);
+	m_node.push_back(Node());
+	BuildNode(0, 0, NE, centroid);
+
+	// the node boxes are calculated in one bottom-up pass
+	UpdateBoxes();
+
+	m_nbuild++;
+}
+
+//-----------------------------------------------------------------------------
+// Split the elements [first, first+count) at the median of the centroids along
+// the longest axis of the centroid box.
+void FESurfaceBVH::BuildNode(int inode, int first, int count, const vector<vec3d>& centroid)
+{
+	m_node[inode].child = -1;
+	m_node[inode].first = first;
+	m_node[inode].count = count;
+	if (count <= m_maxElem) return;
+
+	vec3d cmin = centroid[m_elem[first]];
+	vec3d cmax = cmin;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& c = centroid[m_elem[i]];
+		if (c.x < cmin.x) cmin.x = c.x; if (c.x > cmax.x) cmax.x = c.x;
+		if (c.y < cmin.y) cmin.y = c.y; if (c.y > cmax.y) cmax.y = c.y;
+		if (c.z < cmin.z) cmin.z = c.z; if (c.z > cmax.z) cmax.z = c.z;
+	}
+	vec3d dc = cmax - cmin;
+	int axis = 0;
+	if (dc.y > dc.x) axis = 1;
+	if (dc.z > Component(dc, axis)) axis = 2;
+
+	// all centroids coincide, so we can't split
+	if (Component(dc, axis) <= 0.0) return;
+
+	int mid = first + count / 2;
+	std::nth_element(m_elem.begin() + first, m_elem.begin() + mid, m_elem.begin() + first + count,
+		[&](int a, int b) { return Component(centroid[a], axis) < Component(centroid[b], axis); });
+
+	// children are always stored after their parent, which the refit relies on
+	int nc = (int)m_node.size();
+	m_node.push_back(Node());
+	m_node.push_back(Node());
+	m_node[inode].child = nc;
+	BuildNode(nc    , first, mid - first, centroid);
+	BuildNode(nc + 1, mid, first + count - mid, centroid);
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Refit()
+{
+	UpdateBoxes();
+	m_nrefit++;
+}
+
+//-----------------------------------------------------------------------------
+// Recalculate all node boxes. Since children are always stored after their
+// parent, a reverse sweep visits the children before the parent.
+void FESurfaceBVH::UpdateBoxes()
+{
+	for (int i = (int)m_node.size() - 1; i >= 0; --i)
+	{
+		Node& nd = m_node[i];
+		if (nd.child < 0)
+		{
+			ElementBox(m_elem[nd.first], nd.cmin, nd.cmax);
+			for (int j = 1; j < nd.count; ++j)
+			{
+				vec3d a, b;
+				ElementBox(m_elem[nd.first + j], a, b);
+				if (a.x < nd.cmin.x) nd.cmin.x = a.x; if (b.x > nd.cmax.x) nd.cmax.x = b.x;
+				if (a.y < nd.cmin.y) nd.cmin.y = a.y; if (b.y > nd.cmax.y) nd.cmax.y = b.y;
+				if (a.z < nd.cmin.z) nd.cmin.z = a.z; if (b.z > nd.cmax.z) nd.cmax.z = b.z;
+			}
+		}
+		else
+		{
+			const Node& c0 = m_node[nd.child];
+			const Node& c1 = m_node[nd.child + 1];
+			nd.cmin = vec3d(std::min(c0.cmin.x, c1.cmin.x), std::min(c0.cmin.y, c1.cmin.y), std::min(c0.cmin.z, c1.cmin.z));
+			nd.cmax = vec3d(std::max(c0.cmax.x, c1.cmax.x), std::max(c0.cmax.y, c1.cmax.y), std::max(c0.cmax.z, c1.cmax.z));
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FESurfaceBVH::Update()
+{
+	assert(m_ps);
+	int NN = m_ps->Nodes();
+	if ((m_node.empty()) || ((int)m_r0.size() != NN))
+	{
+		Build(m_tol);
+		return true;
+	}
+
+	// find the largest nodal displacement since the last build and since the last update
+	double d2max = 0.0, dp2max = 0.0;
+	for (int i = 0; i < NN; ++i)
+	{
+		vec3d r = NodePosition(*m_ps, m_ps->Node(i));
+		double d2 = (r - m_r0[i]).norm2();
+		if (d2 > d2max) d2max = d2;
+
+		double dp2 = (r - m_rp[i]).norm2();
+		if (dp2 > dp2max) dp2max = dp2;
+		m_rp[i] = r;
+	}
+	m_drift += sqrt(dp2max);
+
+	// The refitted boxes are always valid, but they become loose (and overlap
+	// more) as the surface deforms. So we rebuild once the motion gets large.
+	double dmax = m_rebuild*m_h;
+	if (d2max > dmax*dmax)
+	{
+		Build(m_tol);
+		return true;
+	}
+
+	Refit();
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// distance from a point to a box (zero when the point is inside)
+static double BoxDistance(const vec3d& x, const vec3d& cmin, const vec3d& cmax)
+{
+	double dx = (x.x < cmin.x ? cmin.x - x.x : (x.x > cmax.x ? x.x - cmax.x : 0.0));
+	double dy = (x.y < cmin.y ? cmin.y - x.y : (x.y > cmax.y ? x.y - cmax.y : 0.0));
+	double dz = (x.z < cmin.z ? cmin.z - x.z : (x.z > cmax.z ? x.z - cmax.z : 0.0));
+	return sqrt(dx*dx + dy*dy + dz*dz);
+}
+
+//-----------------------------------------------------------------------------
+double FESurfaceBVH::Distance(const vec3d& x, double dmin) const
+{
+	if (m_node.empty()) return 1e99;
+
+	// branch-and-bound: subtrees whose box is further than the best leaf found
+	// so far are skipped, and the closer child is always visited first.
+	const int MAX_STACK = 128;
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	double dbest = 1e99;
+	while (ns > 0)
+	{
+		const Node& nd = m_node[stack[--ns]];
+		double d = BoxDistance(x, nd.cmin, nd.cmax);
+		if (d >= dbest) continue;
+
+		if (nd.child < 0)
+		{
+			dbest = d;
+			if (dbest <= dmin) break;
+		}
+		else
+		{
+			const Node& c0 = m_node[nd.child];
+			const Node& c1 = m_node[nd.child + 1];
+			double d0 = BoxDistance(x, c0.cmin, c0.cmax);
+			double d1 = BoxDistance(x, c1.cmin, c1.cmax);
+			assert(ns + 2 <= MAX_STACK);
+			if (d0 <= d1) { stack[ns++] = nd.child + 1; stack[ns++] = nd.child; }
+			else { stack[ns++] = nd.child; stack[ns++] = nd.child + 1; }
+		}
+	}
+	return dbest;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindCandidateSurfaceElements(const vec3d& p, const vec3d& n, vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	// The tree depth is bounded by log2 of the number of elements, since
+	// we split at the median.
+	const int MAX_STACK = 128;
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const Node& nd = m_node[stack[--ns]];
+		if (RayIntersectsBox(p, n, nd.cmin, nd.cmax) == false) continue;
+
+		if (nd.child < 0)
+		{
+			for (int j = 0; j < nd.count; ++j) sel.push_back(m_elem[nd.first + j]);
+		}
+		else
+		{
+			assert(ns + 2 <= MAX_STACK);
+			stack[ns++] = nd.child + 1;
+			stack[ns++] = nd.child;
+		}
+	}
+
+	// every element is stored in exactly one leaf, so there are no duplicates,
+	// but we sort the list so that candidates are visited in a deterministic order.
+	std::sort(sel.begin(), sel.end());
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindElementsInBox(const vec3d& cmin, const vec3d& cmax, vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	const int MAX_STACK = 128;
+	int stack[MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const Node& nd = m_node[stack[--ns]];
+		if ((nd.cmax.x < cmin.x) || (nd.cmin.x > cmax.x) ||
+			(nd.cmax.y < cmin.y) || (nd.cmin.y > cmax.y) ||
+			(nd.cmax.z < cmin.z) || (nd.cmin.z > cmax.z)) continue;
+
+		if (nd.child < 0)
+		{
+			for (int j = 0; j < nd.count; ++j) sel.push_back(m_elem[nd.first + j]);
+		}
+		else
+		{
+			assert(ns + 2 <= MAX_STACK);
+			stack[ns++] = nd.child + 1;
+			stack[ns++] = nd.child;
+		}
+	}
+	std::sort(sel.begin(), sel.end());
+}
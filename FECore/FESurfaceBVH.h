@@ -0,0 +1,122 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "vec3d.h"
+#include "fecore_api.h"
+#include <vector>
+
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! Bounding volume hierarchy over the elements of a surface. This is used
+//! to find the candidate elements that are intersected by a ray.
+//! The hierarchy is meant to be persistent: once built, the boxes can be
+//! refitted to the current nodal positions in O(n), and the tree is only
+//! rebuilt when the surface has moved a lot since the last build.
+class FECORE_API FESurfaceBVH
+{
+public:
+	struct Node
+	{
+		vec3d	cmin, cmax;	//!< bounding box
+		int		child;		//!< index of first child (second child is child+1), or -1 for leaves
+		int		first;		//!< first entry in element list (leaves only)
+		int		count;		//!< number of elements (leaves only)
+	};
+
+public:
+	FESurfaceBVH(FESurface* ps = 0);
+
+	//! attach to a surface
+	void Attach(FESurface* ps) { m_ps = ps; }
+
+	//! build the hierarchy from the current nodal positions
+	void Build(double stol);
+
+	//! recalculate the boxes from the current nodal positions, keeping the tree topology
+	void Refit();
+
+	//! refit the tree, or rebuild it if the surface moved too much since the last build.
+	//! Returns true if the tree was rebuilt.
+	bool Update();
+
+	//! set the nodal displacement (relative to the mean element size) that triggers a rebuild
+	void SetRebuildTolerance(double f) { m_rebuild = f; }
+
+	//! find all candidate surface elements intersected by the ray (p,n).
+	//! The element indices are returned in ascending order. This function is thread safe.
+	void FindCandidateSurfaceElements(const vec3d& p, const vec3d& n, std::vector<int>& sel) const;
+
+	//! Find a lower bound on the distance from x to the surface, i.e. the distance to the
+	//! closest element box. The search stops as soon as a box within dmin is found, so
+	//! the returned value is only exact when it exceeds dmin. This function is thread safe.
+	double Distance(const vec3d& x, double dmin = 0.0) const;
+
+	//! find the surface elements that may overlap the box [cmin, cmax], i.e. all elements
+	//! stored in leaves whose boxes overlap it. The element indices are returned in
+	//! ascending order. This function is thread safe.
+	void FindElementsInBox(const vec3d& cmin, const vec3d& cmax, std::vector<int>& sel) const;
+
+	//! The accumulated motion of the surface, i.e. the sum over all updates of the
+	//! largest nodal displacement between two updates. The difference between two
+	//! values bounds how far any point of the surface moved in between.
+	double Drift() const { return m_drift; }
+
+	//! search tolerance used for the last build
+	double Tolerance() const { return m_tol; }
+
+	//! was the hierarchy built?
+	bool IsValid() const { return (m_node.empty() == false); }
+
+	//! number of full builds and refits done so far
+	int Builds() const { return m_nbuild; }
+	int Refits() const { return m_nrefit; }
+
+private:
+	void BuildNode(int inode, int first, int count, const std::vector<vec3d>& centroid);
+	void UpdateBoxes();
+	void ElementBox(int iel, vec3d& cmin, vec3d& cmax) const;
+
+private:
+	FESurface*			m_ps;		//!< the surface to search
+	double				m_tol;		//!< search tolerance (relative to element size)
+	double				m_rebuild;	//!< rebuild tolerance (relative to mean element size)
+	int					m_maxElem;	//!< max number of elements in a leaf
+
+	std::vector<Node>	m_node;		//!< tree nodes (children always follow their parent)
+	std::vector<int>	m_elem;		//!< element indices, referenced by the leaves
+	std::vector<vec3d>	m_r0;		//!< surface nodal positions at last build
+	std::vector<vec3d>	m_rp;		//!< surface nodal positions at last update
+	double				m_h;		//!< mean element size at last build
+	double				m_drift;	//!< accumulated surface motion
+
+	int		m_nbuild;
+	int		m_nrefit;
+};
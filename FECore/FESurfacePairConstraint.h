@@ -66,6 +66,11 @@ public:
 	// Build the matrix profile
 	virtual void BuildMatrixProfile(FEGlobalMatrix& M) = 0;
 
+	// Returns true if the profile built by BuildMatrixProfile is no longer valid,
+	// so that the global matrix needs to be reshaped. By default this is always the
+	// case, since the connectivity of an interface can change at every update.
+	virtual bool ProfileChanged() { return true; }
+
 	// reset the state data
 	virtual void Reset() {}
 
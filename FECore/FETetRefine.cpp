@@ -84,14 +84,9 @@ bool FETetRefine::DoTetRefinement(FEModel& fem)
 	}
 	assert(n == N1);
 
-	// assign dofs to new nodes
+	// (the new nodes were given initialized dof data by AddNodes)
 	int MAX_DOFS = fem.GetDOFS().GetTotalDOFS();
 	m_NN = mesh.Nodes();
-	for (int i = N0; i<m_NN; ++i)
-	{
-		FENode& node = mesh.Node(i);
-		node.SetDOFS(MAX_DOFS);
-	}
 
 	// re-evaluate solution at nodes
 	n = N0;
@@ -850,14 +850,14 @@ bool build_new_mesh(FEModel& fem, tetgenio& out, bool resetMesh)
 		node.m_r0 = r;
 	}
 
-	// assign dofs to new nodes
+	// initialize the new nodes
+	// (their dof data was allocated by CreateNodes)
 	int MAX_DOFS = fem.GetDOFS().GetTotalDOFS();
 	for (int i = N0; i < nodes; ++i)
 	{
 		FENode& node = mesh.Node(i);
-		node.SetDOFS(MAX_DOFS);
 		node.m_rt = node.m_r0;
-		for (int j = 0; j < node.m_ID.size(); ++j) {
+		for (int j = 0; j < node.dofs(); ++j) {
 			node.set(j, 0.0);
 		}
 	}
@@ -868,7 +868,7 @@ bool build_new_mesh(FEModel& fem, tetgenio& out, bool resetMesh)
 		{
 			FENode& node = mesh.Node(i);
 			node.m_rt = node.m_r0;
-			for (int j = 0; j < node.m_ID.size(); ++j) {
+			for (int j = 0; j < node.dofs(); ++j) {
 				node.set(j, 0.0);
 			}
 		}
@@ -55,7 +55,7 @@ JFNKMatrix::JFNKMatrix(FENewtonSolver* pns, SparseMatrix* K) : m_pns(pns), m_K(K
 	for (int i = 0; i < mesh.Nodes(); ++i)
 	{
 		FENode& node = mesh.Node(i);
-		for (int j = 0; j < node.m_ID.size(); ++j)
+		for (int j = 0; j < node.dofs(); ++j)
 		{
 			int id = node.m_ID[j];
 
@@ -0,0 +1,308 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "MCompiledExpression.h"
+#include <math.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+MCompiledExpression::MCompiledExpression()
+{
+	m_valid = false;
+	m_nvar = 0;
+	m_nreg = 0;
+	m_result = -1;
+}
+
+//-----------------------------------------------------------------------------
+void MCompiledExpression::Clear()
+{
+	m_valid = false;
+	m_nvar = 0;
+	m_nreg = 0;
+	m_result = -1;
+	m_const.clear();
+	m_code.clear();
+	m_cse.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool MCompiledExpression::Compile(const MSimpleExpression& e)
+{
+	Clear();
+
+	const MItem* pi = e.GetExpression().ItemPtr();
+	if (pi == 0) return false;
+
+	// The first registers are the variables, followed by the constants.
+	// Since we don't know the number of constants until we are done, the 
+	// instructions first store their results in temporary registers that are
+	// numbered from the end (i.e. -1, -2, ...), which are renumbered at the end.
+	m_nvar = e.Variables();
+	m_result = compile(pi);
+	m_cse.clear();
+	if (m_result == -1)
+	{
+		Clear();
+		return false;
+	}
+
+	int nconst = (int)m_const.size();
+	int ntemp = (int)m_code.size();
+	int offset = m_nvar + nconst;
+	for (size_t i = 0; i < m_code.size(); ++i)
+	{
+		Instruction& op = m_code[i];
+		op.dst = offset - op.dst - 2;
+		if (op.a < -1) op.a = offset - op.a - 2;
+		if (op.b < -1) op.b = offset - op.b - 2;
+	}
+	if (m_result < -1) m_result = offset - m_result - 2;
+	m_nreg = offset + ntemp;
+
+	m_valid = true;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+int MCompiledExpression::addConstant(double v)
+{
+	for (size_t i = 0; i < m_const.size(); ++i)
+	{
+		if (m_const[i] == v) return m_nvar + (int)i;
+	}
+	m_const.push_back(v);
+	return m_nvar + (int)m_const.size() - 1;
+}
+
+//-----------------------------------------------------------------------------
+int MCompiledExpression::addInstruction(int op, int a, int b, FUNCPTR f1, FUNC2PTR f2)
+{
+	// fold constant operations
+	if (isConstant(a) && ((b == -1) || isConstant(b)))
+	{
+		double va = constant(a);
+		double vb = (b != -1 ? constant(b) : 0.0);
+		double v = 0.0;
+		switch (op)
+		{
+		case OP_NEG: v = -va; break;
+		case OP_ADD: v = va + vb; break;
+		case OP_SUB: v = va - vb; break;
+		case OP_MUL: v = va * vb; break;
+		case OP_DIV: v = va / vb; break;
+		case OP_POW: v = pow(va, vb); break;
+		case OP_F1D: v = f1(va); break;
+		case OP_F2D: v = f2(va, vb); break;
+		default:
+			assert(false);
+		}
+		return addConstant(v);
+	}
+
+	// see if we already evaluated this expression
+	vector<size_t> key(5);
+	key[0] = (size_t)op;
+	key[1] = (size_t)a;
+	key[2] = (size_t)b;
+	key[3] = (size_t)f1;
+	key[4] = (size_t)f2;
+	map<vector<size_t>, int>::iterator it = m_cse.find(key);
+	if (it != m_cse.end()) return it->second;
+
+	// add a new instruction
+	Instruction ins;
+	ins.op = op;
+	ins.dst = -2 - (int)m_code.size();
+	ins.a = a;
+	ins.b = b;
+	ins.f1 = f1;
+	ins.f2 = f2;
+	m_code.push_back(ins);
+
+	m_cse[key] = ins.dst;
+	return ins.dst;
+}
+
+//-----------------------------------------------------------------------------
+// Returns the register that stores the value of the item, or -1 if the item
+// could not be compiled. 
+int MCompiledExpression::compile(const MItem* pi)
+{
+	switch (pi->Type())
+	{
+	case MCONST:
+	case MFRAC :
+	case MNAMED: return addConstant(mnumber(pi)->value());
+	case MVAR  : 
+	{
+		int n = mvar(pi)->index();
+		return ((n >= 0) && (n < m_nvar) ? n : -1);
+	}
+	case MNEG:
+	{
+		int a = compile(munary(pi)->Item()); if (a == -1) return -1;
+		return addInstruction(OP_NEG, a, -1);
+	}
+	case MADD:
+	case MSUB:
+	case MMUL:
+	case MDIV:
+	case MPOW:
+	{
+		int a = compile(mbinary(pi)->LeftItem() ); if (a == -1) return -1;
+		int b = compile(mbinary(pi)->RightItem()); if (b == -1) return -1;
+		int op = 0;
+		switch (pi->Type())
+		{
+		case MADD: op = OP_ADD; break;
+		case MSUB: op = OP_SUB; break;
+		case MMUL: op = OP_MUL; break;
+		case MDIV: op = OP_DIV; break;
+		case MPOW: op = OP_POW; break;
+		}
+		return addInstruction(op, a, b);
+	}
+	case MF1D:
+	{
+		int a = compile(munary(pi)->Item()); if (a == -1) return -1;
+		return addInstruction(OP_F1D, a, -1, mfnc1d(pi)->funcptr(), 0);
+	}
+	case MF2D:
+	{
+		int a = compile(mbinary(pi)->LeftItem() ); if (a == -1) return -1;
+		int b = compile(mbinary(pi)->RightItem()); if (b == -1) return -1;
+		return addInstruction(OP_F2D, a, b, 0, mfnc2d(pi)->funcptr());
+	}
+	case MSFNC:
+		return compile(msfncnd(pi)->Value());
+	default:
+		// this item cannot be compiled
+		return -1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// register buffer of the current thread (it only grows)
+static double* registers(size_t n)
+{
+	static thread_local vector<double> buf;
+	if (buf.size() < n) buf.resize(n);
+	return &buf[0];
+}
+
+//-----------------------------------------------------------------------------
+double MCompiledExpression::value(const double* var) const
+{
+	assert(m_valid);
+
+	// use a buffer on the stack for small expressions
+	const int MAX_REG = 64;
+	double buf[MAX_REG];
+	double* r = (m_nreg > MAX_REG ? registers(m_nreg) : buf);
+
+	for (int i = 0; i < m_nvar; ++i) r[i] = var[i];
+	const int nconst = (int)m_const.size();
+	for (int i = 0; i < nconst; ++i) r[m_nvar + i] = m_const[i];
+
+	const int N = (int)m_code.size();
+	for (int i = 0; i < N; ++i)
+	{
+		const Instruction& op = m_code[i];
+		switch (op.op)
+		{
+		case OP_NEG: r[op.dst] = -r[op.a]; break;
+		case OP_ADD: r[op.dst] = r[op.a] + r[op.b]; break;
+		case OP_SUB: r[op.dst] = r[op.a] - r[op.b]; break;
+		case OP_MUL: r[op.dst] = r[op.a] * r[op.b]; break;
+		case OP_DIV: r[op.dst] = r[op.a] / r[op.b]; break;
+		case OP_POW: r[op.dst] = pow(r[op.a], r[op.b]); break;
+		case OP_F1D: r[op.dst] = op.f1(r[op.a]); break;
+		case OP_F2D: r[op.dst] = op.f2(r[op.a], r[op.b]); break;
+		}
+	}
+
+	return r[m_result];
+}
+
+//-----------------------------------------------------------------------------
+// The points are processed in blocks. Each register stores the values of all
+// the points in a block, so that each instruction is a simple loop over the block.
+void MCompiledExpression::value(const double* var, int n, double* val) const
+{
+	assert(m_valid);
+	if (n <= 0) return;
+
+	const int B = BLOCK_SIZE;
+	double* r = registers(m_nreg*B);
+
+	// the constants are the same for all blocks
+	const int nconst = (int)m_const.size();
+	for (int i = 0; i < nconst; ++i)
+	{
+		double* ri = r + (m_nvar + i)*B;
+		for (int k = 0; k < B; ++k) ri[k] = m_const[i];
+	}
+
+	const int N = (int)m_code.size();
+	for (int n0 = 0; n0 < n; n0 += B)
+	{
+		const int nb = (n - n0 < B ? n - n0 : B);
+
+		// copy the variables
+		for (int k = 0; k < nb; ++k)
+		{
+			const double* vk = var + (n0 + k)*m_nvar;
+			for (int i = 0; i < m_nvar; ++i) r[i*B + k] = vk[i];
+		}
+
+		// run the program
+		for (int i = 0; i < N; ++i)
+		{
+			const Instruction& op = m_code[i];
+			double* d = r + op.dst*B;
+			const double* a = r + op.a*B;
+			const double* b = (op.b >= 0 ? r + op.b*B : 0);
+			switch (op.op)
+			{
+			case OP_NEG: for (int k = 0; k < nb; ++k) d[k] = -a[k]; break;
+			case OP_ADD: for (int k = 0; k < nb; ++k) d[k] = a[k] + b[k]; break;
+			case OP_SUB: for (int k = 0; k < nb; ++k) d[k] = a[k] - b[k]; break;
+			case OP_MUL: for (int k = 0; k < nb; ++k) d[k] = a[k] * b[k]; break;
+			case OP_DIV: for (int k = 0; k < nb; ++k) d[k] = a[k] / b[k]; break;
+			case OP_POW: for (int k = 0; k < nb; ++k) d[k] = pow(a[k], b[k]); break;
+			case OP_F1D: for (int k = 0; k < nb; ++k) d[k] = op.f1(a[k]); break;
+			case OP_F2D: for (int k = 0; k < nb; ++k) d[k] = op.f2(a[k], b[k]); break;
+			}
+		}
+
+		// copy the result
+		const double* res = r + m_result*B;
+		for (int k = 0; k < nb; ++k) val[n0 + k] = res[k];
+	}
+}
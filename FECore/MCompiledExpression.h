@@ -0,0 +1,106 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "MathObject.h"
+#include "MFunctions.h"
+#include <vector>
+#include <map>
+
+//-----------------------------------------------------------------------------
+// This class compiles a simple expression into a flat list of register
+// instructions. Constant sub-expressions are folded during compilation and
+// identical sub-expressions are only evaluated once. The compiled expression
+// does not depend on the expression it was compiled from, and it can be evaluated
+// from multiple threads. The registers are stored on the stack for small expressions,
+// otherwise in a buffer that each thread keeps, so only the first evaluations on
+// a thread can allocate memory.
+class FECORE_API MCompiledExpression
+{
+	enum OpCode {
+		OP_NEG, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_F1D, OP_F2D
+	};
+
+	struct Instruction
+	{
+		int			op;		// opcode
+		int			dst;	// result register
+		int			a, b;	// operand registers
+		FUNCPTR		f1;		// function pointer for OP_F1D
+		FUNC2PTR	f2;		// function pointer for OP_F2D
+	};
+
+public:
+	// number of points that are processed together in the batch evaluation
+	enum { BLOCK_SIZE = 32 };
+
+public:
+	MCompiledExpression();
+
+	// compile the expression. Returns false if the expression contains items
+	// that cannot be compiled, in which case the expression needs to be evaluated
+	// with MSimpleExpression::value_s.
+	bool Compile(const MSimpleExpression& e);
+
+	// clear the compiled expression
+	void Clear();
+
+	// see if the expression was compiled successfully
+	bool IsValid() const { return m_valid; }
+
+	// number of variables the expression depends on
+	int Variables() const { return m_nvar; }
+
+	// number of instructions after compilation
+	int Instructions() const { return (int)m_code.size(); }
+
+	// evaluate the expression. The var array must have Variables() values
+	double value(const double* var) const;
+
+	// Evaluate the expression for n sets of variables. The var array stores the
+	// variables of each point consecutively, i.e. it has size n*Variables().
+	void value(const double* var, int n, double* val) const;
+
+private:
+	int compile(const MItem* pi);
+	int addConstant(double v);
+	int addInstruction(int op, int a, int b, FUNCPTR f1 = 0, FUNC2PTR f2 = 0);
+	bool isConstant(int reg) const { return (reg >= m_nvar) && (reg < m_nvar + (int)m_const.size()); }
+	double constant(int reg) const { return m_const[reg - m_nvar]; }
+
+private:
+	bool	m_valid;
+	int		m_nvar;		// number of variables
+	int		m_nreg;		// total number of registers
+	int		m_result;	// register that holds the result
+
+	std::vector<double>			m_const;	// values of the constant registers
+	std::vector<Instruction>	m_code;		// instruction list
+
+	// lookup table used for eliminating common sub-expressions during compilation
+	std::map<std::vector<size_t>, int>	m_cse;
+};
@@ -38,7 +38,8 @@ SOFTWARE.*/
 #ifdef WIN32
 #define TIMER_TYPE clock_t
 #else
-#define TIMER_TYPE	time_t
+#include <sys/time.h>
+#define TIMER_TYPE	timeval
 #endif
 
 //-----------------------------------------------------------------------------
@@ -52,8 +53,9 @@ double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0);
 void sys_get_time(TIMER_TYPE& t) { t = clock(); }
 double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return (double) (t1 - t0) / CLOCKS_PER_SEC; }
 #else
-void sys_get_time(TIMER_TYPE& t) { time(&t); }
-double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return difftime(t1, t0); }
+// (time() only has a resolution of one second, which is too coarse for timing individual model components)
+void sys_get_time(TIMER_TYPE& t) { gettimeofday(&t, 0); }
+double sys_diff_time(TIMER_TYPE& t1, TIMER_TYPE& t0) { return (double)(t1.tv_sec - t0.tv_sec) + 1e-6*(double)(t1.tv_usec - t0.tv_usec); }
 #endif
 
 //-----------------------------------------------------------------------------
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include <assert.h>
 #include "mortar.h"
 #include <math.h>
+#include <algorithm>
 #include "FEMesh.h"
 
 //-----------------------------------------------------------------------------
@@ -541,29 +542,156 @@ bool CalculateMortarIntersection(FESurface& ss, FESurface& ms, int k, int l, Pat
 	return (patch.Empty() == false);
 }
 
-void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar)
+//-----------------------------------------------------------------------------
+MortarSurface::MortarSurface()
+{
+	m_tol = 0.0;
+	m_dx = vec3d(0,0,0);
+}
+
+//-----------------------------------------------------------------------------
+void MortarSurface::Clear()
+{
+	m_patch.clear();
+	m_tri.clear();
+	m_row.clear();
+	m_rs0.clear();
+	m_rm0.clear();
+	m_dx = vec3d(0,0,0);
+}
+
+//-----------------------------------------------------------------------------
+int MortarSurface::Update(FESurface& ss, FESurface& ms)
 {
-	// loop over all non-mortar facets
 	int NSF = ss.Elements();
 	int NMF = ms.Elements();
+	int NS = ss.Nodes();
+	int NM = ms.Nodes();
+
+	// A common translation of both surfaces only translates the patches, so we
+	// measure the motion since the reference relative to the mean displacement.
+	bool bfull = (((int)m_row.size() != NSF + 1) || ((int)m_rs0.size() != NS) || ((int)m_rm0.size() != NM));
+	vec3d dx(0,0,0);
+	vector<double> ds(NS, 0.0);
+	double dm = 0.0;
+	if (bfull == false)
+	{
+		for (int i=0; i<NS; ++i) dx += ss.Node(i).m_rt - m_rs0[i];
+		for (int i=0; i<NM; ++i) dx += ms.Node(i).m_rt - m_rm0[i];
+		if (NS + NM > 0) dx /= (double)(NS + NM);
+
+		for (int i=0; i<NS; ++i) ds[i] = (ss.Node(i).m_rt - m_rs0[i] - dx).norm();
+		for (int i=0; i<NM; ++i)
+		{
+			double d = (ms.Node(i).m_rt - m_rm0[i] - dx).norm();
+			if (d > dm) dm = d;
+		}
+
+		// if the secondary surface deformed, all patches have to be recalculated
+		if (dm > m_tol) bfull = true;
+	}
+
+	if (bfull)
+	{
+		// reset the reference configuration
+		m_rs0.resize(NS);
+		m_rm0.resize(NM);
+		for (int i=0; i<NS; ++i) m_rs0[i] = ss.Node(i).m_rt;
+		for (int i=0; i<NM; ++i) m_rm0[i] = ms.Node(i).m_rt;
+		dx = vec3d(0,0,0);
+		dm = 0.0;
+		m_dx = dx;
+	}
+
+	// find the primary facets whose patches need to be recalculated.
+	// Note that the motion is measured from the reference, so once a facet moved
+	// too much it is recalculated at each update until the next full update.
+	vector<int> rows;
 	for (int i=0; i<NSF; ++i)
 	{
-		// get the non-mortar surface element
 		FESurfaceElement& se = ss.Element(i);
+		double dmax = 0.0;
+		for (int k=0; k<se.Nodes(); ++k) dmax = std::max(dmax, ds[se.m_lnode[k]]);
+		if (bfull || (dmax + dm > m_tol)) rows.push_back(i);
+	}
+
+	// calculate the new patches. Each primary facet is processed independently.
+	int NR = (int) rows.size();
+	vector< vector<PATCH> > newPatch(NR);
+	vector< vector<Patch::FACET> > newTri(NR);
+#pragma omp parallel for schedule(dynamic)
+	for (int n=0; n<NR; ++n)
+	{
+		int i = rows[n];
+		vector<PATCH>& pn = newPatch[n];
+		vector<Patch::FACET>& tn = newTri[n];
 
 		// loop over all the mortar surface elements
+		Patch patch(i, 0);
 		for (int j=0; j<NMF; ++j)
 		{
-			// get the next surface element
-			FESurfaceElement& me = ms.Element(j);
-
 			// calculate the patch of triangles, representing the intersection
 			// of the non-mortar facet with the mortar facet
-			Patch patch(i,j);
-			CalculateMortarIntersection(ss, ms, i, j, patch);
-			mortar.AddPatch(patch);
+			if (CalculateMortarIntersection(ss, ms, i, j, patch))
+			{
+				PATCH p = { i, j, (int) tn.size(), patch.Size() };
+				for (int k=0; k<p.count; ++k) tn.push_back(patch.Facet(k));
+				pn.push_back(p);
+			}
+		}
+	}
+
+	// merge the new patches with the reused ones into the pool
+	vector<PATCH> patch;
+	vector<Patch::FACET> tri;
+	patch.reserve(m_patch.size());
+	tri.reserve(m_tri.size());
+	vector<int> row(NSF + 1);
+	vec3d shift = dx - m_dx;
+	int n = 0;
+	for (int i=0; i<NSF; ++i)
+	{
+		row[i] = (int) patch.size();
+		if ((n < NR) && (rows[n] == i))
+		{
+			int f0 = (int) tri.size();
+			for (PATCH p : newPatch[n]) { p.first += f0; patch.push_back(p); }
+			tri.insert(tri.end(), newTri[n].begin(), newTri[n].end());
+			n++;
+		}
+		else
+		{
+			// reused patches only need to follow the common translation
+			for (int k=m_row[i]; k<m_row[i+1]; ++k)
+			{
+				PATCH p = m_patch[k];
+				int f0 = (int) tri.size();
+				for (int l=0; l<p.count; ++l)
+				{
+					Patch::FACET f = m_tri[p.first + l];
+					f.r[0] += shift; f.r[1] += shift; f.r[2] += shift;
+					tri.push_back(f);
+				}
+				p.first = f0;
+				patch.push_back(p);
+			}
 		}
 	}
+	row[NSF] = (int) patch.size();
+
+	m_patch.swap(patch);
+	m_tri.swap(tri);
+	m_row.swap(row);
+	m_dx = dx;
+
+	return NR;
+}
+
+//-----------------------------------------------------------------------------
+void CalculateMortarSurface(FESurface& ss, FESurface& ms, MortarSurface& mortar)
+{
+	mortar.Clear();
+	mortar.Update(ss, ms);
 }
 
 bool ExportMortar(MortarSurface& mortar, const char* szfile)
@@ -575,11 +703,11 @@ bool ExportMortar(MortarSurface& mortar, const char* szfile)
 	int NP = mortar.Patches();
 	for (int i=0; i<NP; ++i)
 	{
-		Patch& patch = mortar.GetPatch(i);
-		int np = patch.Size();
+		const MortarSurface::PATCH& patch = mortar.GetPatch(i);
+		int np = patch.count;
 		for (int j=0; j<np; j++)
 		{
-			Patch::FACET& tri = patch.Facet(j);
+			Patch::FACET& tri = mortar.Facet(patch, j);
 
 			vec3d e1 = tri.r[1] - tri.r[0];
 			vec3d e2 = tri.r[2] - tri.r[0];
@@ -110,21 +110,54 @@ private:
 };
 
 //-----------------------------------------------------------------------------
+//! The mortar surface stores the patches of all primary/secondary facet pairs
+//! that intersect. The patch triangles are stored in one flat pool, and the
+//! patches of each primary facet are stored contiguously.
+//! The surface can be updated incrementally: the patches of a primary facet
+//! are only recalculated when the facet moved, relative to the secondary surface,
+//! by more than a tolerance since the patches were last calculated.
 class FECORE_API MortarSurface
 {
 public:
-	MortarSurface(){}
+	struct PATCH
+	{
+		int		primary;	//!< index of primary facet
+		int		secondary;	//!< index of secondary facet
+		int		first;		//!< first triangle in pool
+		int		count;		//!< number of triangles
+	};
+
+public:
+	MortarSurface();
+
+	//! number of (non-empty) patches
+	int Patches() const { return (int) m_patch.size(); }
+
+	//! get a patch
+	const PATCH& GetPatch(int i) const { return m_patch[i]; }
 
-	int Patches() { return (int) m_patch.size(); }
+	//! get a triangle of a patch
+	Patch::FACET& Facet(const PATCH& p, int j) { return m_tri[p.first + j]; }
 
-	Patch& GetPatch(int i) { return m_patch[i]; }
+	//! clear all patches
+	void Clear();
 
-	void AddPatch(const Patch& p) { m_patch.push_back(p); }
+	//! Set the relative motion below which patches are reused (default = 0)
+	void SetTolerance(double tol) { m_tol = tol; }
 
-	void Clear() { m_patch.clear(); }
+	//! (Re)calculate the patches of the primary facets that moved too much.
+	//! Returns the number of primary facets that were recalculated.
+	int Update(FESurface& ss, FESurface& ms);
 
 private:
-	vector<Patch>	m_patch;	
+	std::vector<PATCH>			m_patch;	//!< patches, ordered by primary facet
+	std::vector<Patch::FACET>	m_tri;		//!< triangle pool
+	std::vector<int>			m_row;		//!< first patch of each primary facet
+
+	double				m_tol;	//!< reuse tolerance
+	std::vector<vec3d>	m_rs0;	//!< primary nodal positions at reference
+	std::vector<vec3d>	m_rm0;	//!< secondary nodal positions at reference
+	vec3d				m_dx;	//!< common translation applied to the patches since the reference
 };
 
 //-----------------------------------------------------------------------------
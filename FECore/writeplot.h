@@ -69,6 +69,19 @@ template <class T> void writeNodalValues(FENodeSet& nset, FEDataStream& ar, std:
 	ar << data;
 }
 
+//=================================================================================================
+// Evaluates a value for each element of the domain in parallel, and then writes
+// the values to the stream in the order of the elements.
+template <class T> void writeElementValuesParallel(FEMeshPartition& dom, FEDataStream& ar, std::function<T(FEElement& el)> f)
+{
+	int NE = dom.Elements();
+	vector<T> v(NE);
+	#pragma omp parallel for shared(NE)
+	for (int i = 0; i < NE; ++i) v[i] = f(dom.ElementRef(i));
+
+	for (int i = 0; i < NE; ++i) ar << v[i];
+}
+
 //=================================================================================================
 template <class T> void writeIntegratedElementValue(FESurface& surf, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
@@ -93,67 +106,62 @@ template <class T> void writeElementValue(FEMeshPartition& dom, FEDataStream& ar
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
-		FEElement& el = dom.ElementRef(i);
+	writeElementValuesParallel<T>(dom, ar, [&](FEElement& el) {
 		T s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(*el.GetMaterialPoint(j));
-		ar << s / (double)el.GaussPoints();
-	}
+		return s / (double)el.GaussPoints();
+	});
 }
 
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<T(FEElement& el, int ip)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
-		FEElement& el = dom.ElementRef(i);
+	writeElementValuesParallel<T>(dom, ar, [&](FEElement& el) {
 		T s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(el, j);
-		ar << s / (double) el.GaussPoints();
-	}
+		return s / (double) el.GaussPoints();
+	});
 }
 
 //=================================================================================================
 template <class Tin, class Tout> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<Tin(const FEMaterialPoint&)> fnc, std::function<Tout(const Tin& m)> flt)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
-		FEElement& el = dom.ElementRef(i);
+	writeElementValuesParallel<Tout>(dom, ar, [&](FEElement& el) {
 		Tin s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(*el.GetMaterialPoint(j));
-		ar << flt(s / (double) el.GaussPoints());
-	}
+		return flt(s / (double) el.GaussPoints());
+	});
 }
 
 //=================================================================================================
 template <class Tin, class Tout> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, std::function<Tin(FEElement& el, int ip)> fnc, std::function<Tout(const Tin& m)> flt)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
-		FEElement& el = dom.ElementRef(i);
+	writeElementValuesParallel<Tout>(dom, ar, [&](FEElement& el) {
 		Tin s(0.0);
 		for (int j = 0; j<el.GaussPoints(); ++j) s += fnc(el, j);
-		ar << flt(s / (double)el.GaussPoints());
-	}
+		return flt(s / (double)el.GaussPoints());
+	});
 }
 
 //=================================================================================================
 template <class T> void writeAverageElementValue(FEMeshPartition& dom, FEDataStream& ar, FEDomainParameter* var)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
-		FEElement& el = dom.ElementRef(i);
+	writeElementValuesParallel<T>(dom, ar, [&](FEElement& el) {
 		T s(0.0);
 		for (int j = 0; j < el.GaussPoints(); ++j)
 		{
 			FEParamValue v = var->value(*el.GetMaterialPoint(j));
 			s += v.value<T>();
 		}
-		ar << s / (double)el.GaussPoints();
-	}
+		return s / (double)el.GaussPoints();
+	});
 }
 
 //=================================================================================================
 template <class T> void writeIntegratedElementValue(FESolidDomain& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint& mp)> fnc)
 {
-	for (int i = 0; i<dom.Elements(); ++i) {
-		FESolidElement& el = dom.Element(i);
+	writeElementValuesParallel<T>(dom, ar, [&](FEElement& e) {
+		FESolidElement& el = static_cast<FESolidElement&>(e);
 		double* gw = el.GaussWeights();
 
 		T ew(0.0);
@@ -162,21 +170,27 @@ template <class T> void writeIntegratedElementValue(FESolidDomain& dom, FEDataSt
 			FEMaterialPoint& mp = *el.GetMaterialPoint(j);
 			ew += fnc(mp)*dom.detJ0(el, j)*gw[j];
 		}
-		ar << ew;
-	}
+		return ew;
+	});
 }
 
 //=================================================================================================
 template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, FEDataStream& ar, std::function<T(const FEMaterialPoint&)> var)
 {
-	// temp storage 
-	T si[FEElement::MAX_INTPOINTS];
-	T sn[FEElement::MAX_NODES];
+	// the element's values start at these offsets in the value array
+	int NE = dom.Elements();
+	vector<int> off(NE + 1, 0);
+	for (int i = 0; i<NE; ++i) off[i + 1] = off[i] + dom.ElementRef(i).Nodes();
+	vector<T> v(off[NE], T(0.0));
 
 	// loop over all elements
-	int NE = dom.Elements();
+	#pragma omp parallel for shared(NE)
 	for (int i = 0; i<NE; ++i)
 	{
+		// temp storage 
+		T si[FEElement::MAX_INTPOINTS];
+		T sn[FEElement::MAX_NODES];
+
 		FEElement& e = dom.ElementRef(i);
 		int ne = e.Nodes();
 		int ni = e.GaussPoints();
@@ -192,9 +206,50 @@ template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, F
 		// project to nodes
 		e.project_to_nodes(si, sn);
 
-		// push data to archive
-		for (int j = 0; j<ne; ++j) ar << sn[j];
+		for (int j = 0; j<ne; ++j) v[off[i] + j] = sn[j];
+	}
+
+	// push data to archive
+	for (size_t i = 0; i<v.size(); ++i) ar << v[i];
+}
+
+//=================================================================================================
+// Same as above, but the values were already evaluated at all the integration points of the 
+// domain. They are stored element by element, in the order of FEDomain::MaterialPoint.
+template <class T> void writeNodalProjectedElementValues(FEMeshPartition& dom, FEDataStream& ar, const std::vector<T>& val)
+{
+	// the element's values start at these offsets in the value array (nodes) and in val (integration points)
+	int NE = dom.Elements();
+	vector<int> off(NE + 1, 0), offi(NE + 1, 0);
+	for (int i = 0; i<NE; ++i)
+	{
+		off [i + 1] = off [i] + dom.ElementRef(i).Nodes();
+		offi[i + 1] = offi[i] + dom.ElementRef(i).GaussPoints();
+	}
+	assert(offi[NE] == (int)val.size());
+	vector<T> v(off[NE], T(0.0));
+
+	// loop over all elements
+	#pragma omp parallel for shared(NE)
+	for (int i = 0; i<NE; ++i)
+	{
+		// temp storage 
+		T si[FEElement::MAX_INTPOINTS];
+		T sn[FEElement::MAX_NODES];
+
+		FEElement& e = dom.ElementRef(i);
+		int ne = e.Nodes();
+		int ni = e.GaussPoints();
+		for (int k = 0; k<ni; ++k) si[k] = val[offi[i] + k];
+
+		// project to nodes
+		e.project_to_nodes(si, sn);
+
+		for (int j = 0; j<ne; ++j) v[off[i] + j] = sn[j];
 	}
+
+	// push data to archive
+	for (size_t i = 0; i<v.size(); ++i) ar << v[i];
 }
 
 //=================================================================================================